@@ -410,6 +410,11 @@ extern const char *__progname;
 
 #define	ELFTC_HAVE_MMAP				1
 
+#if defined(__GLIBC__) && defined(__linux__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define	ELFTC_HAVE_COPY_FILE_RANGE		1
+#endif
+
 /*
  * Debian GNU/Linux and Debian GNU/kFreeBSD do not have strmode(3).
  */
@@ -537,6 +537,27 @@ enum {
 	EC__LAST__
 };
 
+/*
+ * Compression algorithms for sections with the SHF_COMPRESSED flag.
+ */
+#define	_ELF_DEFINE_ELF_COMPRESSION()				\
+_ELF_DEFINE_ECF(ELFCOMPRESS_ZLIB,   1, "ZLIB/DEFLATE")		\
+_ELF_DEFINE_ECF(ELFCOMPRESS_LOOS,   0x60000000UL,		\
+	"start of OS-specific range")				\
+_ELF_DEFINE_ECF(ELFCOMPRESS_HIOS,   0x6FFFFFFFUL,		\
+	"end of OS-specific range")				\
+_ELF_DEFINE_ECF(ELFCOMPRESS_LOPROC, 0x70000000UL,		\
+	"start of processor-specific range")			\
+_ELF_DEFINE_ECF(ELFCOMPRESS_HIPROC, 0x7FFFFFFFUL,		\
+	"end of processor-specific range")
+
+#undef	_ELF_DEFINE_ECF
+#define	_ELF_DEFINE_ECF(N, V, DESCR)	N = V ,
+enum {
+	_ELF_DEFINE_ELF_COMPRESSION()
+	ELFCOMPRESS__LAST__ = ELFCOMPRESS_HIPROC
+};
+
 /*
  * Endianness of data in an ELF object.
  */
@@ -2364,6 +2385,25 @@ typedef struct {
 	} c_un;
 } Elf64_Cap;
 
+/*
+ * Compression headers, at the start of SHF_COMPRESSED sections.
+ */
+
+/* 32-bit compression header. */
+typedef struct {
+	Elf32_Word	ch_type;      /* Compression algorithm (ELFCOMPRESS_*). */
+	Elf32_Word	ch_size;      /* Size of the uncompressed data. */
+	Elf32_Word	ch_addralign; /* Alignment of the uncompressed data. */
+} Elf32_Chdr;
+
+/* 64-bit compression header. */
+typedef struct {
+	Elf64_Word	ch_type;      /* Compression algorithm (ELFCOMPRESS_*). */
+	Elf64_Word	ch_reserved;
+	Elf64_Xword	ch_size;      /* Size of the uncompressed data. */
+	Elf64_Xword	ch_addralign; /* Alignment of the uncompressed data. */
+} Elf64_Chdr;
+
 /*
  * MIPS .conflict section entries.
  */
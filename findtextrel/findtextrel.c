@@ -46,6 +46,9 @@ static struct option longopts[] = {
 	{NULL, 0, NULL, 0}
 };
 
+/* Number of table entries retrieved per gelf_get*s() call. */
+#define	ENTRY_BATCH_SIZE	256
+
 #define	USAGE_MESSAGE	"\
 Usage: %s [options] [files...]\n\
   Show text relocations present in position independent code.\n\n\
@@ -71,28 +74,33 @@ static const char *
 find_symbol(const char *fn, Elf *e, Elf_Data *d, GElf_Shdr *sh, uintmax_t off)
 {
 	const char *name;
-	GElf_Sym sym;
-	int i, len;
+	GElf_Sym sym[ENTRY_BATCH_SIZE];
+	size_t i, j, len, n;
 
 	if (sh->sh_entsize == 0) {
 		warnx("invalid sh_entsize");
 		return (NULL);
 	}
-	len = (int) (d->d_size / sh->sh_entsize);
-	for (i = 0; i < len; i++) {
-		if (gelf_getsym(d, i, &sym) != &sym) {
-			warnx("%s: gelf_getsym() failed: %s", fn,
+	len = d->d_size / sh->sh_entsize;
+	for (i = 0; i < len; i += n) {
+		n = MIN(len - i, ENTRY_BATCH_SIZE);
+		if (gelf_getsyms(d, i, n, sym) != sym) {
+			warnx("%s: gelf_getsyms() failed: %s", fn,
 			    elf_errmsg(-1));
-			continue;
+			return (NULL);
 		}
-		if (GELF_ST_TYPE(sym.st_info) != STT_FUNC)
-			continue;
-		if (off >= sym.st_value && off < sym.st_value + sym.st_size) {
-			name = elf_strptr(e, sh->sh_link, sym.st_name);
-			if (name == NULL)
-				warnx("%s: elf_strptr() failed: %s", fn,
-				    elf_errmsg(-1));
-			return (name);
+		for (j = 0; j < n; j++) {
+			if (GELF_ST_TYPE(sym[j].st_info) != STT_FUNC)
+				continue;
+			if (off >= sym[j].st_value &&
+			    off < sym[j].st_value + sym[j].st_size) {
+				name = elf_strptr(e, sh->sh_link,
+				    sym[j].st_name);
+				if (name == NULL)
+					warnx("%s: elf_strptr() failed: %s",
+					    fn, elf_errmsg(-1));
+				return (name);
+			}
 		}
 	}
 
@@ -240,42 +248,43 @@ static void
 examine_reloc(const char *fn, Elf *e, Elf_Data *d, GElf_Shdr *sh, GElf_Phdr *ph,
     int phnum, Dwarf_Debug dbg, int *textrel)
 {
-	GElf_Rela rela;
-	int i, j, len;
-	GElf_Rel rel;
+	GElf_Rela rela[ENTRY_BATCH_SIZE];
+	GElf_Rel rel[ENTRY_BATCH_SIZE];
+	GElf_Addr r_offset;
+	size_t i, j, len, n;
+	int k;
 
 	if (sh->sh_entsize == 0) {
 		warnx("invalid sh_entsize");
 		return;
 	}
-	len = (int) (d->d_size / sh->sh_entsize);
-	for (i = 0; i < len; i++) {
+	len = d->d_size / sh->sh_entsize;
+	for (i = 0; i < len; i += n) {
+		n = MIN(len - i, ENTRY_BATCH_SIZE);
 		if (sh->sh_type == SHT_REL) {
-			if (gelf_getrel(d, i, &rel) != &rel) {
-				warnx("%s: gelf_getrel() failed: %s", fn,
+			if (gelf_getrels(d, i, n, rel) != rel) {
+				warnx("%s: gelf_getrels() failed: %s", fn,
 				    elf_errmsg(-1));
-				continue;
+				return;
 			}
 		} else {
-			if (gelf_getrela(d, i, &rela) != &rela) {
-				warnx("%s: gelf_getrela() failed: %s", fn,
+			if (gelf_getrelas(d, i, n, rela) != rela) {
+				warnx("%s: gelf_getrelas() failed: %s", fn,
 				    elf_errmsg(-1));
-				continue;
+				return;
 			}
 		}
-		for (j = 0; j < phnum; j++) {
-			if (sh->sh_type == SHT_REL) {
-				if (rel.r_offset >= ph[j].p_offset &&
-				    rel.r_offset < ph[j].p_offset +
-				    ph[j].p_filesz)
-					report_textrel(fn, e, dbg,
-					    (uintmax_t) rel.r_offset, textrel);
-			} else {
-				if (rela.r_offset >= ph[j].p_offset &&
-				    rela.r_offset < ph[j].p_offset +
-				    ph[j].p_filesz)
+		for (j = 0; j < n; j++) {
+			if (sh->sh_type == SHT_REL)
+				r_offset = rel[j].r_offset;
+			else
+				r_offset = rela[j].r_offset;
+			for (k = 0; k < phnum; k++) {
+				if (r_offset >= ph[k].p_offset &&
+				    r_offset < ph[k].p_offset +
+				    ph[k].p_filesz)
 					report_textrel(fn, e, dbg,
-					    (uintmax_t) rela.r_offset, textrel);
+					    (uintmax_t) r_offset, textrel);
 			}
 		}
 	}
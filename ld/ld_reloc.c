@@ -230,32 +230,42 @@ static void
 _read_rel(struct ld *ld, struct ld_input_section *is, Elf_Data *d)
 {
 	struct ld_reloc_entry *lre;
-	GElf_Rel r;
+	GElf_Rel *r;
 	uint64_t reloc_adjust, sym;
-	int i, len;
+	size_t i, len;
+	int bulk;
 
 	assert(is->is_reloc != NULL);
 
 	reloc_adjust = 0;
 	len = d->d_size / is->is_entsize;
+	r = NULL;
+	bulk = 0;
+	if (len > 0) {
+		if ((r = malloc(len * sizeof(*r))) == NULL)
+			ld_fatal_std(ld, "malloc");
+		bulk = gelf_getrels(d, 0, len, r) == r;
+	}
 	for (i = 0; i < len; i++) {
-		if (gelf_getrel(d, i, &r) != &r) {
+		/* Fall back to reading entries one at a time. */
+		if (!bulk && gelf_getrel(d, (int) i, &r[i]) != &r[i]) {
 			ld_warn(ld, "gelf_getrel failed: %s", elf_errmsg(-1));
 			continue;
 		}
-		sym = GELF_R_SYM(r.r_info);
-		if (_discard_reloc(ld, is, sym, r.r_offset, &reloc_adjust))
+		sym = GELF_R_SYM(r[i].r_info);
+		if (_discard_reloc(ld, is, sym, r[i].r_offset, &reloc_adjust))
 			continue;
 		if ((lre = calloc(1, sizeof(*lre))) == NULL)
 			ld_fatal(ld, "calloc");
-		assert(r.r_offset >= reloc_adjust);
-		lre->lre_offset = r.r_offset - reloc_adjust;
-		lre->lre_type = GELF_R_TYPE(r.r_info);
+		assert(r[i].r_offset >= reloc_adjust);
+		lre->lre_offset = r[i].r_offset - reloc_adjust;
+		lre->lre_type = GELF_R_TYPE(r[i].r_info);
 		lre->lre_tis = is->is_tis;
 		_scan_reloc(ld, is, sym, lre);
 		STAILQ_INSERT_TAIL(is->is_reloc, lre, lre_next);
 		is->is_num_reloc++;
 	}
+	free(r);
 	is->is_tis->is_shrink = reloc_adjust;
 }
 
@@ -263,33 +273,43 @@ static void
 _read_rela(struct ld *ld, struct ld_input_section *is, Elf_Data *d)
 {
 	struct ld_reloc_entry *lre;
-	GElf_Rela r;
+	GElf_Rela *r;
 	uint64_t reloc_adjust, sym;
-	int i, len;
+	size_t i, len;
+	int bulk;
 
 	assert(is->is_reloc != NULL);
 
 	reloc_adjust = 0;
 	len = d->d_size / is->is_entsize;
+	r = NULL;
+	bulk = 0;
+	if (len > 0) {
+		if ((r = malloc(len * sizeof(*r))) == NULL)
+			ld_fatal_std(ld, "malloc");
+		bulk = gelf_getrelas(d, 0, len, r) == r;
+	}
 	for (i = 0; i < len; i++) {
-		if (gelf_getrela(d, i, &r) != &r) {
+		/* Fall back to reading entries one at a time. */
+		if (!bulk && gelf_getrela(d, (int) i, &r[i]) != &r[i]) {
 			ld_warn(ld, "gelf_getrel failed: %s", elf_errmsg(-1));
 			continue;
 		}
-		sym = GELF_R_SYM(r.r_info);
-		if (_discard_reloc(ld, is, sym, r.r_offset, &reloc_adjust))
+		sym = GELF_R_SYM(r[i].r_info);
+		if (_discard_reloc(ld, is, sym, r[i].r_offset, &reloc_adjust))
 			continue;
 		if ((lre = calloc(1, sizeof(*lre))) == NULL)
 			ld_fatal(ld, "calloc");
-		assert(r.r_offset >= reloc_adjust);
-		lre->lre_offset = r.r_offset - reloc_adjust;
-		lre->lre_type = GELF_R_TYPE(r.r_info);
-		lre->lre_addend = r.r_addend;
+		assert(r[i].r_offset >= reloc_adjust);
+		lre->lre_offset = r[i].r_offset - reloc_adjust;
+		lre->lre_type = GELF_R_TYPE(r[i].r_info);
+		lre->lre_addend = r[i].r_addend;
 		lre->lre_tis = is->is_tis;
 		_scan_reloc(ld, is, sym, lre);
 		STAILQ_INSERT_TAIL(is->is_reloc, lre, lre_next);
 		is->is_num_reloc++;
 	}
+	free(r);
 	is->is_tis->is_shrink = reloc_adjust;
 }
 
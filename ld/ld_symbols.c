@@ -54,6 +54,8 @@ static struct ld_archive_member * _extract_archive_member(struct ld *ld,
     struct ld_file *lf, struct ld_archive *la, off_t off);
 static void _print_extracted_member(struct ld *ld,
     struct ld_archive_member *lam, struct ld_symbol *lsb);
+static int _archive_member_adds_names(struct ld *ld, struct ld_file *lf,
+    struct ld_archive_member *lam);
 static void _resolve_and_add_symbol(struct ld *ld, struct ld_symbol *lsb);
 static struct ld_symbol *_alloc_symbol(struct ld *ld);
 static void _free_symbol(struct ld_symbol *lsb);
@@ -1076,6 +1078,37 @@ _print_extracted_member(struct ld *ld, struct ld_archive_member *lam,
 	printf("%s (%s)\n", c2, lsb->lsb_name);
 }
 
+/*
+ * Return non-zero if a newly extracted archive member refers to a
+ * symbol that is still undefined in the link and that the archive's
+ * symbol table lists for a member not extracted yet, in which case
+ * another pass over that table may extract further members.
+ */
+static int
+_archive_member_adds_names(struct ld *ld, struct ld_file *lf,
+    struct ld_archive_member *lam)
+{
+	struct ld_input *li;
+	struct ld_symbol *lsb, *_lsb;
+	Elf_Arsym *as;
+	size_t i;
+
+	li = lam->lam_input;
+	for (i = 0; li->li_symindex != NULL && i < li->li_symnum; i++) {
+		if ((lsb = li->li_symindex[i]) == NULL ||
+		    lsb->lsb_bind == STB_LOCAL)
+			continue;
+		if ((_lsb = _find_symbol(ld->ld_sym, lsb->lsb_longname)) ==
+		    NULL || _lsb->lsb_shndx != SHN_UNDEF)
+			continue;
+		if ((as = elf_arsym_lookup(lf->lf_elf, lsb->lsb_name)) !=
+		    NULL && !_archive_member_extracted(lf->lf_ar, as->as_off))
+			return (1);
+	}
+
+	return (0);
+}
+
 static void
 _load_archive_symbols(struct ld *ld, struct ld_file *lf)
 {
@@ -1095,6 +1128,13 @@ _load_archive_symbols(struct ld *ld, struct ld_file *lf)
 	if ((as = elf_getarsym(lf->lf_elf, &c)) == NULL)
 		ld_fatal(ld, "%s: elf_getarsym failed: %s", lf->lf_name,
 		    elf_errmsg(-1));
+
+	/*
+	 * Sweep the archive symbol table in order until no more members
+	 * are extracted.  A further sweep is only needed if a member
+	 * extracted by this one introduced names that the archive's
+	 * symbol table lists, which its hashed index tells us cheaply.
+	 */
 	do {
 		extracted = 0;
 		for (i = 0; (size_t) i < c; i++) {
@@ -1106,7 +1146,9 @@ _load_archive_symbols(struct ld *ld, struct ld_file *lf)
 			    NULL) {
 				lam = _extract_archive_member(ld, lf, la,
 				    as[i].as_off);
-				extracted = 1;
+				if (!extracted &&
+				    _archive_member_adds_names(ld, lf, lam))
+					extracted = 1;
 				ls->ls_extracted[ls->ls_group_level] = 1;
 				if (ld->ld_print_linkmap)
 					_print_extracted_member(ld, lam, lsb);
@@ -1122,7 +1164,7 @@ _load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e)
 	Elf_Scn *scn_sym, *scn_dynamic;
 	Elf_Scn *scn_versym, *scn_verneed, *scn_verdef;
 	Elf_Data *d;
-	GElf_Sym sym;
+	GElf_Sym *sym;
 	GElf_Shdr shdr;
 	size_t dyn_strndx, strndx;
 	int elferr, i;
@@ -1184,13 +1226,16 @@ _load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e)
 	}
 
 	li->li_symnum = d->d_size / shdr.sh_entsize;
-	for (i = 0; (uint64_t) i < li->li_symnum; i++) {
-		if (gelf_getsym(d, i, &sym) != &sym)
-			ld_warn(ld, "%s: gelf_getsym failed: %s", li->li_name,
-			    elf_errmsg(-1));
-		_add_elf_symbol(ld, li, e, &sym, strndx, i);
-	}
-
+	if (li->li_symnum == 0)
+		return;
+	if ((sym = malloc(li->li_symnum * sizeof(*sym))) == NULL)
+		ld_fatal_std(ld, "malloc");
+	if (gelf_getsyms(d, 0, li->li_symnum, sym) != sym)
+		ld_fatal(ld, "%s: gelf_getsyms failed: %s", li->li_name,
+		    elf_errmsg(-1));
+	for (i = 0; (uint64_t) i < li->li_symnum; i++)
+		_add_elf_symbol(ld, li, e, &sym[i], strndx, i);
+	free(sym);
 }
 
 static void
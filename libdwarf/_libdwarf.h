@@ -100,7 +100,6 @@ struct _Dwarf_AttrDef {
 
 struct _Dwarf_Attribute {
 	Dwarf_Die		at_die;		/* Ptr to containing DIE. */
-	Dwarf_Die		at_refdie;	/* Ptr to reference DIE. */
 	uint64_t		at_offset;	/* Offset in info section. */
 	Dwarf_Half		at_attrib;	/* DW_AT_XXX */
 	Dwarf_Half		at_form;	/* DW_FORM_XXX */
@@ -111,14 +110,29 @@ struct _Dwarf_Attribute {
 		char		*s;   		/* String. */
 		uint8_t		*u8p;		/* Block data. */
 	} u[2];					/* Value. */
-	Dwarf_Block		at_block;	/* Block. */
-	Dwarf_Locdesc		*at_ld;		/* at value is locdesc. */
-	Dwarf_P_Expr		at_expr;	/* at value is expr. */
-	uint64_t		at_relsym;	/* Relocation symbol index. */
-	const char		*at_relsec;	/* Rel. to dwarf section. */
-	STAILQ_ENTRY(_Dwarf_Attribute) at_next;	/* Next attribute. */
+	union {
+		struct {			/* Consumer only. */
+			Dwarf_Block	c_block;	/* Block. */
+			Dwarf_Locdesc	*c_ld;		/* at value is locdesc. */
+		} at_c;
+		struct {			/* Producer only. */
+			Dwarf_Die	p_refdie;	/* Ptr to reference DIE. */
+			Dwarf_P_Expr	p_expr;		/* at value is expr. */
+			uint64_t	p_relsym;	/* Relocation symbol index. */
+			const char	*p_relsec;	/* Rel. to dwarf section. */
+			STAILQ_ENTRY(_Dwarf_Attribute) p_next; /* Next attribute. */
+		} at_p;
+	} at_u;
 };
 
+#define	at_block	at_u.at_c.c_block
+#define	at_ld		at_u.at_c.c_ld
+#define	at_refdie	at_u.at_p.p_refdie
+#define	at_expr		at_u.at_p.p_expr
+#define	at_relsym	at_u.at_p.p_relsym
+#define	at_relsec	at_u.at_p.p_relsec
+#define	at_next		at_u.at_p.p_next
+
 struct _Dwarf_Abbrev {
 	uint64_t	ab_entry;	/* Abbrev entry. */
 	uint64_t	ab_tag;		/* Tag: DW_TAG_ */
@@ -126,28 +140,59 @@ struct _Dwarf_Abbrev {
 	uint64_t	ab_offset;	/* Offset in abbrev section. */
 	uint64_t	ab_length;	/* Length of this abbrev entry. */
 	uint64_t	ab_atnum;	/* Number of attribute defines. */
+	uint64_t	ab_skip;	/* Size of all attributes, if fixed. */
+	int		ab_skip_fixed;	/* All attributes have a fixed size. */
+	Dwarf_Half	*ab_attrmap;	/* Attribute at each position. */
+	Dwarf_Die	ab_free;	/* Released DIEs using this abbrev. */
 	UT_hash_handle	ab_hh;		/* Uthash handle. */
 	STAILQ_HEAD(, _Dwarf_AttrDef) ab_attrdef; /* List of attribute defs. */
 };
 
 struct _Dwarf_Die {
-	Dwarf_Die	die_parent;	/* Parent DIE. */
-	Dwarf_Die	die_child;	/* First child DIE. */
-	Dwarf_Die	die_left;	/* Left sibling DIE. */
-	Dwarf_Die	die_right;	/* Right sibling DIE. */
 	uint64_t	die_offset;	/* DIE offset in section. */
 	uint64_t	die_next_off;	/* Next DIE offset in section. */
-	uint64_t	die_abnum;	/* Abbrev number. */
 	Dwarf_Abbrev	die_ab;		/* Abbrev pointer. */
-	Dwarf_Tag	die_tag;	/* DW_TAG_ */
+	void		*die_chunk;	/* Storage of a DIE read from a file. */
 	Dwarf_Debug	die_dbg;	/* Dwarf_Debug pointer. */
 	Dwarf_CU	die_cu;		/* Compilation unit pointer. */
-	char		*die_name;	/* Ptr to the name string. */
-	Dwarf_Attribute	*die_attrarray;	/* Array of attributes. */
-	STAILQ_HEAD(, _Dwarf_Attribute)	die_attr; /* List of attributes. */
-	STAILQ_ENTRY(_Dwarf_Die) die_pro_next; /* Next die in pro-die list. */
+	Dwarf_Attribute	die_attrs;	/* Decoded attributes, in abbrev order. */
+	union {
+		struct {		/* Consumer only. */
+			int		c_refcnt; /* References to a cached DIE. */
+			UT_hash_handle	c_hh;	/* Uthash handle for the cache. */
+		} die_c;
+		struct {		/* Producer only. */
+			Dwarf_Die	p_parent; /* Parent DIE. */
+			Dwarf_Die	p_child; /* First child DIE. */
+			Dwarf_Die	p_left;	/* Left sibling DIE. */
+			Dwarf_Die	p_right; /* Right sibling DIE. */
+			Dwarf_Tag	p_tag;	/* DW_TAG_ */
+			STAILQ_HEAD(, _Dwarf_Attribute) p_attr; /* Attributes. */
+			STAILQ_ENTRY(_Dwarf_Die) p_next; /* Next in pro-die list. */
+		} die_p;
+	} die_u;
 };
 
+/*
+ * A DIE read from a file is followed by the offset of the value of each
+ * of its attributes from the start of the DIE, in abbrev order.  Its
+ * decoded attributes are followed by the array of their descriptors
+ * returned by dwarf_attrlist().
+ */
+#define	_DWARF_DIE_ATTROFF(die)	((uint32_t *) (void *) ((die) + 1))
+#define	_DWARF_DIE_ATTRLIST(die) ((Dwarf_Attribute *) (void *)		\
+	((die)->die_attrs + (die)->die_ab->ab_atnum))
+
+#define	die_refcnt	die_u.die_c.c_refcnt
+#define	die_hh		die_u.die_c.c_hh
+#define	die_parent	die_u.die_p.p_parent
+#define	die_child	die_u.die_p.p_child
+#define	die_left	die_u.die_p.p_left
+#define	die_right	die_u.die_p.p_right
+#define	die_tag		die_u.die_p.p_tag
+#define	die_attr	die_u.die_p.p_attr
+#define	die_pro_next	die_u.die_p.p_next
+
 struct _Dwarf_P_Expr_Entry {
 	Dwarf_Loc	ee_loc;		/* Location expression. */
 	Dwarf_Unsigned	ee_sym;		/* Optional related reloc sym index. */
@@ -336,6 +381,10 @@ struct _Dwarf_CU {
 	int		cu_pass2;	/* Two pass DIE traverse. */
 	Dwarf_LineInfo	cu_lineinfo;	/* Ptr to Dwarf_LineInfo. */
 	Dwarf_Abbrev	cu_abbrev_hash; /* Abbrev hash table. */
+	Dwarf_Die	cu_die_cache;	/* Parsed DIEs, oldest first. */
+	void		*cu_die_chunks;	/* Storage for DIEs. */
+	uint8_t		*cu_die_free;	/* Unused space in current chunk. */
+	size_t		cu_die_avail;	/* Size of unused space. */
 	Dwarf_Bool	cu_is_info;	/* Compilation/type unit flag. */
 	STAILQ_ENTRY(_Dwarf_CU) cu_next; /* Next compilation unit. */
 };
@@ -380,7 +429,9 @@ typedef struct _Dwarf_Rel_Section {
 
 typedef struct {
 	Elf_Data *ed_data;
+	Elf_Data ed_zdata;	/* Inflated contents, if compressed. */
 	void *ed_alloc;
+	const char *ed_name;	/* DWARF name of the section. */
 } Dwarf_Elf_Data;
 
 typedef struct {
@@ -413,6 +464,13 @@ struct _Dwarf_Debug {
 	STAILQ_HEAD(, _Dwarf_CU) dbg_tu;/* List of type units. */
 	Dwarf_CU	dbg_cu_current; /* Ptr to the current CU. */
 	Dwarf_CU	dbg_tu_current; /* Ptr to the current TU. */
+	Dwarf_CU	*dbg_cu_index;	/* CUs sorted by offset. */
+	Dwarf_Unsigned	dbg_cu_index_cnt; /* Length of the CU index. */
+	Dwarf_CU	*dbg_tu_index;	/* TUs sorted by offset. */
+	Dwarf_Unsigned	dbg_tu_index_cnt; /* Length of the TU index. */
+	Dwarf_Unsigned	dbg_die_cache_limit; /* DIEs cached per unit. */
+	Dwarf_Unsigned	dbg_die_cache_hits; /* DIEs found in the cache. */
+	Dwarf_Unsigned	dbg_die_cache_misses; /* DIEs added to the cache. */
 	Dwarf_NameSec	dbg_globals;	/* Ptr to pubnames lookup section. */
 	Dwarf_NameSec	dbg_pubtypes;	/* Ptr to pubtypes lookup section. */
 	Dwarf_NameSec	dbg_weaks;	/* Ptr to weaknames lookup section. */
@@ -499,12 +557,18 @@ int		_dwarf_arange_gen(Dwarf_P_Debug, Dwarf_Error *);
 int		_dwarf_arange_init(Dwarf_Debug, Dwarf_Error *);
 void		_dwarf_arange_pro_cleanup(Dwarf_P_Debug);
 int		_dwarf_attr_alloc(Dwarf_Die, Dwarf_Attribute *, Dwarf_Error *);
+int		_dwarf_attr_decode(Dwarf_Die, uint64_t, Dwarf_Attribute,
+		    Dwarf_Error *);
 Dwarf_Attribute	_dwarf_attr_find(Dwarf_Die, Dwarf_Half);
+Dwarf_Attribute	_dwarf_attr_get(Dwarf_Die, Dwarf_Half, Dwarf_Attribute);
 int		_dwarf_attr_gen(Dwarf_P_Debug, Dwarf_P_Section, Dwarf_Rel_Section,
 		    Dwarf_CU, Dwarf_Die, int, Dwarf_Error *);
 int		_dwarf_attr_init(Dwarf_Debug, Dwarf_Section *, uint64_t *, int,
-		    Dwarf_CU, Dwarf_Die, Dwarf_AttrDef, uint64_t, int,
-		    Dwarf_Error *);
+		    Dwarf_CU, Dwarf_Die, Dwarf_Attribute, Dwarf_AttrDef,
+		    uint64_t, int, Dwarf_Error *);
+int		_dwarf_attr_size(Dwarf_CU, int, uint64_t);
+int		_dwarf_attr_skip(Dwarf_Debug, Dwarf_Section *, uint64_t *, int,
+		    Dwarf_CU, uint64_t, Dwarf_Error *);
 int		_dwarf_attrdef_add(Dwarf_Debug, Dwarf_Abbrev, uint64_t,
 		    uint64_t, uint64_t, Dwarf_AttrDef *, Dwarf_Error *);
 uint64_t	_dwarf_decode_lsb(uint8_t **, int);
@@ -513,6 +577,9 @@ int64_t		_dwarf_decode_sleb128(uint8_t **);
 uint64_t	_dwarf_decode_uleb128(uint8_t **);
 void		_dwarf_deinit(Dwarf_Debug);
 int		_dwarf_die_alloc(Dwarf_Debug, Dwarf_Die *, Dwarf_Error *);
+int		_dwarf_die_attr_init(Dwarf_Die, Dwarf_Error *);
+void		_dwarf_die_cache_trim(Dwarf_CU, Dwarf_Unsigned);
+void		_dwarf_die_cleanup(Dwarf_CU);
 int		_dwarf_die_count_links(Dwarf_P_Die, Dwarf_P_Die,
 		    Dwarf_P_Die, Dwarf_P_Die);
 Dwarf_Die	_dwarf_die_find(Dwarf_Die, Dwarf_Unsigned);
@@ -523,6 +590,7 @@ void		_dwarf_die_link(Dwarf_P_Die, Dwarf_P_Die, Dwarf_P_Die,
 int		_dwarf_die_parse(Dwarf_Debug, Dwarf_Section *, Dwarf_CU, int,
 		    uint64_t, uint64_t, Dwarf_Die *, int, Dwarf_Error *);
 void		_dwarf_die_pro_cleanup(Dwarf_P_Debug);
+void		_dwarf_die_release(Dwarf_Die);
 void		_dwarf_elf_deinit(Dwarf_Debug);
 int		_dwarf_elf_init(Dwarf_Debug, Elf *, Dwarf_Error *);
 int		_dwarf_elf_load_section(void *, Dwarf_Half, Dwarf_Small **,
@@ -557,6 +625,7 @@ int		_dwarf_generate_sections(Dwarf_P_Debug, Dwarf_Error *);
 Dwarf_Unsigned	_dwarf_get_reloc_type(Dwarf_P_Debug, int);
 int		_dwarf_get_reloc_size(Dwarf_Debug, Dwarf_Unsigned);
 void		_dwarf_info_cleanup(Dwarf_Debug);
+Dwarf_CU	_dwarf_info_find_cu(Dwarf_Debug, Dwarf_Bool, Dwarf_Off);
 int		_dwarf_info_first_cu(Dwarf_Debug, Dwarf_Error *);
 int		_dwarf_info_first_tu(Dwarf_Debug, Dwarf_Error *);
 int		_dwarf_info_gen(Dwarf_P_Debug, Dwarf_Error *);
@@ -33,6 +33,7 @@ int
 dwarf_attr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute *atp,
     Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Debug dbg;
 	Dwarf_Attribute at;
 
@@ -43,11 +44,18 @@ dwarf_attr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute *atp,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, attr)) == NULL) {
+	if ((at = _dwarf_attr_get(die, attr, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
 
+	/* Give the DIE descriptors for its attributes. */
+	if (at == &atbuf) {
+		if (_dwarf_die_attr_init(die, error) != DW_DLE_NONE)
+			return (DW_DLV_ERROR);
+		at = _dwarf_attr_find(die, attr);
+	}
+
 	*atp = at;
 
 	return (DW_DLV_OK);
@@ -57,13 +65,12 @@ int
 dwarf_attrlist(Dwarf_Die die, Dwarf_Attribute **attrbuf,
     Dwarf_Signed *attrcount, Dwarf_Error *error)
 {
-	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
-	int i;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
 
-	if (die == NULL || attrbuf == NULL || attrcount == NULL) {
+	if (die == NULL || die->die_chunk == NULL || attrbuf == NULL ||
+	    attrcount == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_ARGUMENT);
 		return (DW_DLV_ERROR);
 	}
@@ -75,22 +82,11 @@ dwarf_attrlist(Dwarf_Die die, Dwarf_Attribute **attrbuf,
 
 	*attrcount = die->die_ab->ab_atnum;
 
-	if (die->die_attrarray != NULL) {
-		*attrbuf = die->die_attrarray;
-		return (DW_DLV_OK);
-	}
-
-	if ((die->die_attrarray = malloc(*attrcount * sizeof(Dwarf_Attribute)))
-	    == NULL) {
-		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+	if (die->die_attrs == NULL &&
+	    _dwarf_die_attr_init(die, error) != DW_DLE_NONE)
 		return (DW_DLV_ERROR);
-	}
-
-	for (i = 0, at = STAILQ_FIRST(&die->die_attr);
-	     i < *attrcount && at != NULL; i++, at = STAILQ_NEXT(at, at_next))
-		die->die_attrarray[i] = at;
 
-	*attrbuf = die->die_attrarray;
+	*attrbuf = _DWARF_DIE_ATTRLIST(die);
 
 	return (DW_DLV_OK);
 }
@@ -99,6 +95,7 @@ int
 dwarf_hasattr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *ret_bool,
     Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Debug dbg;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
@@ -108,7 +105,7 @@ dwarf_hasattr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *ret_bool,
 		return (DW_DLV_ERROR);
 	}
 
-	*ret_bool = (_dwarf_attr_find(die, attr) != NULL);
+	*ret_bool = (_dwarf_attr_get(die, attr, &atbuf) != NULL);
 
 	return (DW_DLV_OK);
 }
@@ -133,6 +130,7 @@ dwarf_attroffset(Dwarf_Attribute at, Dwarf_Off *ret_off, Dwarf_Error *error)
 int
 dwarf_lowpc(Dwarf_Die die, Dwarf_Addr *ret_lowpc, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -143,7 +141,7 @@ dwarf_lowpc(Dwarf_Die die, Dwarf_Addr *ret_lowpc, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_low_pc)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_low_pc, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -164,6 +162,7 @@ int
 dwarf_highpc_b(Dwarf_Die die, Dwarf_Addr *ret_highpc, Dwarf_Half *ret_form,
     enum Dwarf_Form_Class *ret_class, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 	Dwarf_CU cu;
@@ -175,7 +174,7 @@ dwarf_highpc_b(Dwarf_Die die, Dwarf_Addr *ret_highpc, Dwarf_Half *ret_form,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_high_pc)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_high_pc, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -199,6 +198,7 @@ dwarf_highpc_b(Dwarf_Die die, Dwarf_Addr *ret_highpc, Dwarf_Half *ret_form,
 int
 dwarf_bytesize(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -209,7 +209,7 @@ dwarf_bytesize(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_byte_size)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_byte_size, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -222,6 +222,7 @@ dwarf_bytesize(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 int
 dwarf_bitsize(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -232,7 +233,7 @@ dwarf_bitsize(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_bit_size)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_bit_size, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -245,6 +246,7 @@ dwarf_bitsize(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 int
 dwarf_bitoffset(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -255,7 +257,7 @@ dwarf_bitoffset(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_bit_offset)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_bit_offset, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -268,6 +270,7 @@ dwarf_bitoffset(Dwarf_Die die, Dwarf_Unsigned *ret_size, Dwarf_Error *error)
 int
 dwarf_srclang(Dwarf_Die die, Dwarf_Unsigned *ret_lang, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -278,7 +281,7 @@ dwarf_srclang(Dwarf_Die die, Dwarf_Unsigned *ret_lang, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_language)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_language, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -291,6 +294,7 @@ dwarf_srclang(Dwarf_Die die, Dwarf_Unsigned *ret_lang, Dwarf_Error *error)
 int
 dwarf_arrayorder(Dwarf_Die die, Dwarf_Unsigned *ret_order, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 	
@@ -301,7 +305,7 @@ dwarf_arrayorder(Dwarf_Die die, Dwarf_Unsigned *ret_order, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_ordering)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_ordering, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
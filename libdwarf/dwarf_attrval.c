@@ -31,6 +31,7 @@ ELFTC_VCSID("$Id$");
 int
 dwarf_attrval_flag(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *valp, Dwarf_Error *err)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -43,7 +44,7 @@ dwarf_attrval_flag(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *valp, Dwarf_Error
 
 	*valp = 0;
 
-	if ((at = _dwarf_attr_find(die, attr)) == NULL) {
+	if ((at = _dwarf_attr_get(die, attr, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, err, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -64,6 +65,7 @@ dwarf_attrval_flag(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *valp, Dwarf_Error
 int
 dwarf_attrval_string(Dwarf_Die die, Dwarf_Half attr, const char **strp, Dwarf_Error *err)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -76,7 +78,7 @@ dwarf_attrval_string(Dwarf_Die die, Dwarf_Half attr, const char **strp, Dwarf_Er
 
 	*strp = NULL;
 
-	if ((at = _dwarf_attr_find(die, attr)) == NULL) {
+	if ((at = _dwarf_attr_get(die, attr, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, err, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -99,6 +101,7 @@ dwarf_attrval_string(Dwarf_Die die, Dwarf_Half attr, const char **strp, Dwarf_Er
 int
 dwarf_attrval_signed(Dwarf_Die die, Dwarf_Half attr, Dwarf_Signed *valp, Dwarf_Error *err)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
@@ -111,7 +114,7 @@ dwarf_attrval_signed(Dwarf_Die die, Dwarf_Half attr, Dwarf_Signed *valp, Dwarf_E
 
 	*valp = 0;
 
-	if ((at = _dwarf_attr_find(die, attr)) == NULL) {
+	if ((at = _dwarf_attr_get(die, attr, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, err, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -141,6 +144,7 @@ dwarf_attrval_signed(Dwarf_Die die, Dwarf_Half attr, Dwarf_Signed *valp, Dwarf_E
 int
 dwarf_attrval_unsigned(Dwarf_Die die, Dwarf_Half attr, Dwarf_Unsigned *valp, Dwarf_Error *err)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_Die die1;
 	Dwarf_Unsigned val;
@@ -158,12 +162,13 @@ dwarf_attrval_unsigned(Dwarf_Die die, Dwarf_Half attr, Dwarf_Unsigned *valp, Dwa
 
 	die1 = NULL;
 	for (;;) {
-		if ((at = _dwarf_attr_find(die, attr)) != NULL ||
+		if ((at = _dwarf_attr_get(die, attr, &atbuf)) != NULL ||
 		    attr != DW_AT_type)
 			break;
-		if ((at = _dwarf_attr_find(die, DW_AT_abstract_origin)) ==
-		    NULL &&
-		    (at = _dwarf_attr_find(die, DW_AT_specification)) == NULL)
+		if ((at = _dwarf_attr_get(die, DW_AT_abstract_origin,
+		    &atbuf)) == NULL &&
+		    (at = _dwarf_attr_get(die, DW_AT_specification,
+		    &atbuf)) == NULL)
 			break;
 
 		switch (at->at_form) {
@@ -59,15 +59,23 @@ dwarf_dealloc(Dwarf_Debug dbg, Dwarf_Ptr p, Dwarf_Unsigned alloc_type)
 		free(ab);
 	} else if (alloc_type == DW_DLA_DIE) {
 		die = p;
+		/* DIEs read from a file are kept for reuse by their unit. */
+		if (die->die_chunk != NULL) {
+			/*
+			 * Cached DIEs are released once their last
+			 * reference is gone.
+			 */
+			if (die->die_refcnt > 1)
+				die->die_refcnt--;
+			else
+				_dwarf_die_release(die);
+			return;
+		}
 		STAILQ_FOREACH_SAFE(at, &die->die_attr, at_next, tat) {
 			STAILQ_REMOVE(&die->die_attr, at,
 			    _Dwarf_Attribute, at_next);
-			if (at->at_ld != NULL)
-				free(at->at_ld);
 			free(at);
 		}
-		if (die->die_attrarray)
-			free(die->die_attrarray);
 		free(die);
 	}
 }
@@ -66,6 +66,7 @@ int
 dwarf_siblingof_b(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die *ret_die,
     Dwarf_Bool is_info, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_CU cu;
 	Dwarf_Attribute at;
 	Dwarf_Section *ds;
@@ -111,7 +112,7 @@ dwarf_siblingof_b(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die *ret_die,
 		 * Look for DW_AT_sibling attribute for the offset of
 		 * its sibling.
 		 */
-		if ((at = _dwarf_attr_find(die, DW_AT_sibling)) != NULL) {
+		if ((at = _dwarf_attr_get(die, DW_AT_sibling, &atbuf)) != NULL) {
 			if (at->at_form != DW_FORM_ref_addr)
 				offset = at->u[0].u64 + cu->cu_offset;
 			else
@@ -189,38 +190,19 @@ dwarf_offdie_b(Dwarf_Debug dbg, Dwarf_Off offset, Dwarf_Bool is_info,
 	if (ret != DW_DLE_NONE)
 		return (DW_DLV_ERROR);
 
-	if (is_info) {
-		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next) {
-			if (offset < cu->cu_offset ||
-			    offset > cu->cu_next_offset)
-				continue;
-			ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset,
-			    ret_die, error);
-			if (ret == DW_DLE_NO_ENTRY) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-				return (DW_DLV_NO_ENTRY);
-			} else if (ret != DW_DLE_NONE)
-				return (DW_DLV_ERROR);
-			return (DW_DLV_OK);
-		}
-	} else {
-		STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next) {
-			if (offset < cu->cu_offset ||
-			    offset > cu->cu_next_offset)
-				continue;
-			ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset,
-			    ret_die, error);
-			if (ret == DW_DLE_NO_ENTRY) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-				return (DW_DLV_NO_ENTRY);
-			} else if (ret != DW_DLE_NONE)
-				return (DW_DLV_ERROR);
-			return (DW_DLV_OK);
-		}
+	if ((cu = _dwarf_info_find_cu(dbg, is_info, offset)) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
 	}
 
-	DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-	return (DW_DLV_NO_ENTRY);
+	ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset, ret_die, error);
+	if (ret == DW_DLE_NO_ENTRY) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	} else if (ret != DW_DLE_NONE)
+		return (DW_DLV_ERROR);
+
+	return (DW_DLV_OK);
 }
 
 int
@@ -314,6 +296,8 @@ dwarf_die_CU_offset_range(Dwarf_Die die, Dwarf_Off *cu_offset,
 int
 dwarf_diename(Dwarf_Die die, char **ret_name, Dwarf_Error *error)
 {
+	struct _Dwarf_Attribute atbuf;
+	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
@@ -323,12 +307,22 @@ dwarf_diename(Dwarf_Die die, char **ret_name, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if (die->die_name == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_name, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
 
-	*ret_name = die->die_name;
+	switch (at->at_form) {
+	case DW_FORM_strp:
+		*ret_name = at->u[1].s;
+		break;
+	case DW_FORM_string:
+		*ret_name = at->u[0].s;
+		break;
+	default:
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	}
 
 	return (DW_DLV_OK);
 }
@@ -339,7 +333,7 @@ dwarf_die_abbrev_code(Dwarf_Die die)
 
 	assert(die != NULL);
 
-	return (die->die_abnum);
+	return (die->die_ab->ab_entry);
 }
 
 int
@@ -411,3 +405,36 @@ dwarf_get_die_infotypes_flag(Dwarf_Die die)
 
 	return (die->die_cu->cu_is_info);
 }
+
+Dwarf_Unsigned
+dwarf_set_die_cache_limit(Dwarf_Debug dbg, Dwarf_Unsigned limit)
+{
+	Dwarf_Unsigned old_limit;
+	Dwarf_CU cu;
+
+	old_limit = dbg->dbg_die_cache_limit;
+	dbg->dbg_die_cache_limit = limit;
+
+	STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+		_dwarf_die_cache_trim(cu, limit);
+	STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next)
+		_dwarf_die_cache_trim(cu, limit);
+
+	return (old_limit);
+}
+
+int
+dwarf_get_die_cache_stats(Dwarf_Debug dbg, Dwarf_Unsigned *hits,
+    Dwarf_Unsigned *misses, Dwarf_Error *error)
+{
+
+	if (dbg == NULL || hits == NULL || misses == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ARGUMENT);
+		return (DW_DLV_ERROR);
+	}
+
+	*hits = dbg->dbg_die_cache_hits;
+	*misses = dbg->dbg_die_cache_misses;
+
+	return (DW_DLV_OK);
+}
@@ -36,6 +36,7 @@ dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
 	Dwarf_Debug dbg;
 	Dwarf_Line ln;
 	Dwarf_CU cu;
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at; 
 	int i;
 
@@ -46,7 +47,7 @@ dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_stmt_list)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_stmt_list, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -98,6 +99,7 @@ dwarf_srcfiles(Dwarf_Die die, char ***srcfiles, Dwarf_Signed *srccount,
 	Dwarf_LineFile lf;
 	Dwarf_Debug dbg;
 	Dwarf_CU cu;
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at; 
 	int i;
 
@@ -108,7 +110,7 @@ dwarf_srcfiles(Dwarf_Die die, char ***srcfiles, Dwarf_Signed *srccount,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_stmt_list)) == NULL) {
+	if ((at = _dwarf_attr_get(die, DW_AT_stmt_list, &atbuf)) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
 	}
@@ -50,6 +50,10 @@ _dwarf_abbrev_add(Dwarf_CU cu, uint64_t entry, uint64_t tag, uint8_t children,
 	ab->ab_offset	= aboff;
 	ab->ab_length	= 0;	/* fill in later. */
 	ab->ab_atnum	= 0;	/* fill in later. */
+	ab->ab_skip	= 0;	/* fill in later. */
+	ab->ab_skip_fixed = 0;	/* fill in later. */
+	ab->ab_attrmap	= NULL;	/* fill in later. */
+	ab->ab_free	= NULL;
 
 	/* Initialise the list of attribute definitions. */
 	STAILQ_INIT(&ab->ab_attrdef);
@@ -100,6 +104,7 @@ int
 _dwarf_abbrev_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned *offset,
     Dwarf_Abbrev *abp, Dwarf_Error *error)
 {
+	Dwarf_AttrDef ad;
 	Dwarf_Section *ds;
 	uint64_t attr;
 	uint64_t entry;
@@ -107,8 +112,9 @@ _dwarf_abbrev_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned *offset,
 	uint64_t aboff;
 	uint64_t adoff;
 	uint64_t tag;
+	uint64_t i;
 	uint8_t children;
-	int ret;
+	int ret, size;
 
 	assert(abp != NULL);
 
@@ -148,6 +154,39 @@ _dwarf_abbrev_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned *offset,
 
 	(*abp)->ab_length = *offset - aboff;
 
+	if (cu == NULL)
+		return (ret);
+
+	/*
+	 * Record the combined size of the attributes of DIEs using
+	 * this abbrev, if none of them has a variable size, so that
+	 * such DIEs can be skipped without decoding their attributes.
+	 */
+	(*abp)->ab_skip_fixed = 1;
+	STAILQ_FOREACH(ad, &(*abp)->ab_attrdef, ad_next) {
+		if ((size = _dwarf_attr_size(cu, cu->cu_dwarf_size,
+		    ad->ad_form)) < 0) {
+			(*abp)->ab_skip_fixed = 0;
+			break;
+		}
+		(*abp)->ab_skip += size;
+	}
+
+	/*
+	 * Record the attribute stored at each position of the attribute
+	 * array of DIEs using this abbrev.
+	 */
+	if ((*abp)->ab_atnum > 0) {
+		if (((*abp)->ab_attrmap = malloc((*abp)->ab_atnum *
+		    sizeof(Dwarf_Half))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		i = 0;
+		STAILQ_FOREACH(ad, &(*abp)->ab_attrdef, ad_next)
+			(*abp)->ab_attrmap[i++] = ad->ad_attrib;
+	}
+
 	return (ret);
 }
 
@@ -214,6 +253,8 @@ _dwarf_abbrev_cleanup(Dwarf_CU cu)
 			    ad_next);
 			free(ad);
 		}
+		if (ab->ab_attrmap)
+			free(ab->ab_attrmap);
 		free(ab);
 	}
 }
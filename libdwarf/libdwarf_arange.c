@@ -99,11 +99,8 @@ _dwarf_arange_init(Dwarf_Debug dbg, Dwarf_Error *error)
 		}
 
 		as->as_cu_offset = dbg->read(ds->ds_data, &offset, dwarf_size);
-		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next) {
-			if (cu->cu_offset == as->as_cu_offset)
-				break;
-		}
-		if (cu == NULL) {
+		cu = _dwarf_info_find_cu(dbg, 1, as->as_cu_offset);
+		if (cu == NULL || cu->cu_offset != as->as_cu_offset) {
 			DWARF_SET_ERROR(dbg, error, DW_DLE_ARANGE_OFFSET_BAD);
 			ret = DW_DLE_ARANGE_OFFSET_BAD;
 			goto fail_cleanup;
@@ -47,44 +47,74 @@ _dwarf_attr_alloc(Dwarf_Die die, Dwarf_Attribute *atp, Dwarf_Error *error)
 	return (DW_DLE_NONE);
 }
 
-static int
-_dwarf_attr_add(Dwarf_Die die, Dwarf_Attribute atref, Dwarf_Attribute *atp,
-    Dwarf_Error *error)
+/*
+ * Return the position of attribute 'attr' in the attributes of DIEs
+ * using abbrev 'ab', or -1 if they do not have it.  Abbrevs rarely
+ * define more than a handful of attributes, so a scan of their
+ * compact attribute map beats an index keyed by attribute code.
+ */
+static int64_t
+_dwarf_attr_index(Dwarf_Abbrev ab, Dwarf_Half attr)
 {
-	Dwarf_Attribute at;
-	int ret;
+	uint64_t i;
 
-	if ((ret = _dwarf_attr_alloc(die, &at, error)) != DW_DLE_NONE)
-		return (ret);
+	for (i = 0; i < ab->ab_atnum; i++)
+		if (ab->ab_attrmap[i] == attr)
+			return ((int64_t) i);
 
-	memcpy(at, atref, sizeof(struct _Dwarf_Attribute));
+	return (-1);
+}
 
-	STAILQ_INSERT_TAIL(&die->die_attr, at, at_next);
+/*
+ * Decode the attribute at position 'i' of a DIE read from a file
+ * into 'at'.
+ */
+int
+_dwarf_attr_decode(Dwarf_Die die, uint64_t i, Dwarf_Attribute at,
+    Dwarf_Error *error)
+{
+	Dwarf_AttrDef ad;
+	Dwarf_Debug dbg;
+	Dwarf_Section *ds;
+	Dwarf_CU cu;
+	uint64_t n, offset;
 
-	/* Save a pointer to the attribute name if this is one. */
-	if (at->at_attrib == DW_AT_name) {
-		switch (at->at_form) {
-		case DW_FORM_strp:
-			die->die_name = at->u[1].s;
-			break;
-		case DW_FORM_string:
-			die->die_name = at->u[0].s;
-			break;
-		default:
-			break;
-		}
-	}
+	assert(die->die_chunk != NULL && i < die->die_ab->ab_atnum);
 
-	if (atp != NULL)
-		*atp = at;
+	cu = die->die_cu;
+	dbg = die->die_dbg;
+	ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
 
-	return (DW_DLE_NONE);
+	ad = STAILQ_FIRST(&die->die_ab->ab_attrdef);
+	for (n = 0; n < i; n++)
+		ad = STAILQ_NEXT(ad, ad_next);
+
+	memset(at, 0, sizeof(*at));
+	offset = die->die_offset + _DWARF_DIE_ATTROFF(die)[i];
+
+	return (_dwarf_attr_init(dbg, ds, &offset, cu->cu_dwarf_size, cu, die,
+	    at, ad, ad->ad_form, 0, error));
 }
 
+/*
+ * Return the descriptor for attribute 'attr' of a DIE.  The attributes
+ * of a DIE read from a file are decoded into descriptors the first
+ * time one of them is asked for.
+ */
 Dwarf_Attribute
 _dwarf_attr_find(Dwarf_Die die, Dwarf_Half attr)
 {
 	Dwarf_Attribute at;
+	int64_t i;
+
+	if (die->die_chunk != NULL) {
+		if ((i = _dwarf_attr_index(die->die_ab, attr)) < 0)
+			return (NULL);
+		if (die->die_attrs == NULL &&
+		    _dwarf_die_attr_init(die, NULL) != DW_DLE_NONE)
+			return (NULL);
+		return (&die->die_attrs[i]);
+	}
 
 	STAILQ_FOREACH(at, &die->die_attr, at_next) {
 		if (at->at_attrib == attr)
@@ -94,104 +124,122 @@ _dwarf_attr_find(Dwarf_Die die, Dwarf_Half attr)
 	return (at);
 }
 
+/*
+ * Look up attribute 'attr' of a DIE for the library's own use.  An
+ * attribute of a DIE read from a file is decoded into 'atbuf', unless
+ * the DIE already has descriptors for its attributes.
+ */
+Dwarf_Attribute
+_dwarf_attr_get(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute atbuf)
+{
+	int64_t i;
+
+	if (die->die_chunk == NULL || die->die_attrs != NULL)
+		return (_dwarf_attr_find(die, attr));
+
+	if ((i = _dwarf_attr_index(die->die_ab, attr)) < 0)
+		return (NULL);
+	if (_dwarf_attr_decode(die, (uint64_t) i, atbuf, NULL) != DW_DLE_NONE)
+		return (NULL);
+
+	return (atbuf);
+}
+
 int
 _dwarf_attr_init(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
-    int dwarf_size, Dwarf_CU cu, Dwarf_Die die, Dwarf_AttrDef ad,
-    uint64_t form, int indirect, Dwarf_Error *error)
+    int dwarf_size, Dwarf_CU cu, Dwarf_Die die, Dwarf_Attribute at,
+    Dwarf_AttrDef ad, uint64_t form, int indirect, Dwarf_Error *error)
 {
-	struct _Dwarf_Attribute atref;
 	int ret;
 
 	ret = DW_DLE_NONE;
-	memset(&atref, 0, sizeof(atref));
-	atref.at_die = die;
-	atref.at_offset = *offsetp;
-	atref.at_attrib = ad->ad_attrib;
-	atref.at_form = indirect ? form : ad->ad_form;
-	atref.at_indirect = indirect;
-	atref.at_ld = NULL;
+	at->at_die = die;
+	at->at_offset = *offsetp;
+	at->at_attrib = ad->ad_attrib;
+	at->at_form = indirect ? form : ad->ad_form;
+	at->at_indirect = indirect;
 
 	switch (form) {
 	case DW_FORM_addr:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp,
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp,
 		    cu->cu_pointer_size);
 		break;
 	case DW_FORM_block:
 	case DW_FORM_exprloc:
-		atref.u[0].u64 = _dwarf_read_uleb128(ds->ds_data, offsetp);
-		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
-		    atref.u[0].u64);
+		at->u[0].u64 = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		at->u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
+		    at->u[0].u64);
 		break;
 	case DW_FORM_block1:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 1);
-		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
-		    atref.u[0].u64);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 1);
+		at->u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
+		    at->u[0].u64);
 		break;
 	case DW_FORM_block2:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 2);
-		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
-		    atref.u[0].u64);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 2);
+		at->u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
+		    at->u[0].u64);
 		break;
 	case DW_FORM_block4:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 4);
-		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
-		    atref.u[0].u64);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 4);
+		at->u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
+		    at->u[0].u64);
 		break;
 	case DW_FORM_data1:
 	case DW_FORM_flag:
 	case DW_FORM_ref1:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 1);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 1);
 		break;
 	case DW_FORM_data2:
 	case DW_FORM_ref2:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 2);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 2);
 		break;
 	case DW_FORM_data4:
 	case DW_FORM_ref4:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 4);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 4);
 		break;
 	case DW_FORM_data8:
 	case DW_FORM_ref8:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 8);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, 8);
 		break;
 	case DW_FORM_indirect:
 		form = _dwarf_read_uleb128(ds->ds_data, offsetp);
 		return (_dwarf_attr_init(dbg, ds, offsetp, dwarf_size, cu, die,
-		    ad, form, 1, error));
+		    at, ad, form, 1, error));
 	case DW_FORM_ref_addr:
 		if (cu->cu_version == 2)
-			atref.u[0].u64 = dbg->read(ds->ds_data, offsetp,
+			at->u[0].u64 = dbg->read(ds->ds_data, offsetp,
 			    cu->cu_pointer_size);
 		else
-			atref.u[0].u64 = dbg->read(ds->ds_data, offsetp,
+			at->u[0].u64 = dbg->read(ds->ds_data, offsetp,
 			    dwarf_size);
 		break;
 	case DW_FORM_ref_udata:
 	case DW_FORM_udata:
-		atref.u[0].u64 = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		at->u[0].u64 = _dwarf_read_uleb128(ds->ds_data, offsetp);
 		break;
 	case DW_FORM_sdata:
-		atref.u[0].s64 = _dwarf_read_sleb128(ds->ds_data, offsetp);
+		at->u[0].s64 = _dwarf_read_sleb128(ds->ds_data, offsetp);
 		break;
 	case DW_FORM_sec_offset:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
 		break;
 	case DW_FORM_string:
-		atref.u[0].s = _dwarf_read_string(ds->ds_data, ds->ds_size,
+		at->u[0].s = _dwarf_read_string(ds->ds_data, ds->ds_size,
 		    offsetp);
 		break;
 	case DW_FORM_strp:
-		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
-		atref.u[1].s = _dwarf_strtab_get_table(dbg) + atref.u[0].u64;
+		at->u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
+		at->u[1].s = _dwarf_strtab_get_table(dbg) + at->u[0].u64;
 		break;
 	case DW_FORM_ref_sig8:
-		atref.u[0].u64 = 8;
-		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
-		    atref.u[0].u64);
+		at->u[0].u64 = 8;
+		at->u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
+		    at->u[0].u64);
 		break;
 	case DW_FORM_flag_present:
 		/* This form has no value encoded in the DIE. */
-		atref.u[0].u64 = 1;
+		at->u[0].u64 = 1;
 		break;
 	default:
 		DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
@@ -202,15 +250,109 @@ _dwarf_attr_init(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
 	if (ret == DW_DLE_NONE) {
 		if (form == DW_FORM_block || form == DW_FORM_block1 ||
 		    form == DW_FORM_block2 || form == DW_FORM_block4) {
-			atref.at_block.bl_len = atref.u[0].u64;
-			atref.at_block.bl_data = atref.u[1].u8p;
+			at->at_block.bl_len = at->u[0].u64;
+			at->at_block.bl_data = at->u[1].u8p;
 		}
-		ret = _dwarf_attr_add(die, &atref, NULL, error);
 	}
 
 	return (ret);
 }
 
+/*
+ * Return the size of the value of an attribute encoded using form
+ * 'form' in compilation unit 'cu', or -1 if the size varies.
+ */
+int
+_dwarf_attr_size(Dwarf_CU cu, int dwarf_size, uint64_t form)
+{
+
+	switch (form) {
+	case DW_FORM_flag_present:
+		return (0);
+	case DW_FORM_data1:
+	case DW_FORM_flag:
+	case DW_FORM_ref1:
+		return (1);
+	case DW_FORM_data2:
+	case DW_FORM_ref2:
+		return (2);
+	case DW_FORM_data4:
+	case DW_FORM_ref4:
+		return (4);
+	case DW_FORM_data8:
+	case DW_FORM_ref8:
+	case DW_FORM_ref_sig8:
+		return (8);
+	case DW_FORM_addr:
+		return (cu->cu_pointer_size);
+	case DW_FORM_ref_addr:
+		if (cu->cu_version == 2)
+			return (cu->cu_pointer_size);
+		return (dwarf_size);
+	case DW_FORM_sec_offset:
+	case DW_FORM_strp:
+		return (dwarf_size);
+	default:
+		return (-1);
+	}
+}
+
+/*
+ * Advance '*offsetp' past the value of an attribute encoded using form
+ * 'form', without decoding it.
+ */
+int
+_dwarf_attr_skip(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
+    int dwarf_size, Dwarf_CU cu, uint64_t form, Dwarf_Error *error)
+{
+	uint64_t length;
+	int size;
+
+	if ((size = _dwarf_attr_size(cu, dwarf_size, form)) >= 0) {
+		*offsetp += size;
+		return (DW_DLE_NONE);
+	}
+
+	switch (form) {
+	case DW_FORM_block:
+	case DW_FORM_exprloc:
+		length = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		*offsetp += length;
+		break;
+	case DW_FORM_block1:
+		length = dbg->read(ds->ds_data, offsetp, 1);
+		*offsetp += length;
+		break;
+	case DW_FORM_block2:
+		length = dbg->read(ds->ds_data, offsetp, 2);
+		*offsetp += length;
+		break;
+	case DW_FORM_block4:
+		length = dbg->read(ds->ds_data, offsetp, 4);
+		*offsetp += length;
+		break;
+	case DW_FORM_indirect:
+		form = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		return (_dwarf_attr_skip(dbg, ds, offsetp, dwarf_size, cu,
+		    form, error));
+	case DW_FORM_ref_udata:
+	case DW_FORM_udata:
+		(void) _dwarf_read_uleb128(ds->ds_data, offsetp);
+		break;
+	case DW_FORM_sdata:
+		(void) _dwarf_read_sleb128(ds->ds_data, offsetp);
+		break;
+	case DW_FORM_string:
+		(void) _dwarf_read_string(ds->ds_data, ds->ds_size, offsetp);
+		break;
+	default:
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+		return (DW_DLE_ATTR_FORM_BAD);
+	}
+
+	return (DW_DLE_NONE);
+}
+
 static int
 _dwarf_attr_write(Dwarf_P_Debug dbg, Dwarf_P_Section ds, Dwarf_Rel_Section drs,
     Dwarf_CU cu, Dwarf_Attribute at, int pass2, Dwarf_Error *error)
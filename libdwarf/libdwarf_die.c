@@ -48,25 +48,87 @@ _dwarf_die_alloc(Dwarf_Debug dbg, Dwarf_Die *ret_die, Dwarf_Error *error)
 	return (DW_DLE_NONE);
 }
 
+/*
+ * DIEs read from a file are allocated together with the offsets of the
+ * values of their attributes, from chunks of memory belonging to their
+ * unit.  The attributes are only decoded into descriptors when the
+ * application asks for one.  Chunks grow in size with the number
+ * of DIEs parsed in the unit.  A released DIE is kept on a free list in
+ * its abbrev, for reuse by a later DIE with the same layout.  Chunks
+ * are freed along with the unit, except for those holding DIEs that
+ * the application has yet to release, which are freed once their last
+ * DIE is released.
+ */
+#define	_DWARF_DIE_CHUNK_MIN	2048
+#define	_DWARF_DIE_CHUNK_MAX	65536
+
+union _Dwarf_Die_Chunk {
+	struct {
+		union _Dwarf_Die_Chunk *c_next;
+		size_t		c_size;	/* size of the chunk */
+		size_t		c_used;	/* bytes handed out as DIEs */
+		size_t		c_live;	/* DIEs not yet released */
+	} c_hdr;
+	/* Keep the DIEs following the chunk header aligned. */
+	uint64_t	c_align64;
+	void		*c_alignptr;
+};
+
+#define	_DWARF_DIE_SIZE(ab)	(sizeof(struct _Dwarf_Die) +		\
+	roundup2((ab)->ab_atnum * sizeof(uint32_t), sizeof(uint64_t)))
+
 static int
-_dwarf_die_add(Dwarf_CU cu, uint64_t offset, uint64_t abnum, Dwarf_Abbrev ab,
+_dwarf_die_add(Dwarf_CU cu, uint64_t offset, Dwarf_Abbrev ab,
     Dwarf_Die *diep, Dwarf_Error *error)
 {
+	union _Dwarf_Die_Chunk *c, *head;
 	Dwarf_Debug dbg;
 	Dwarf_Die die;
-	int ret;
+	size_t csize, size;
 
 	assert(cu != NULL);
 	assert(ab != NULL);
 
 	dbg = cu->cu_dbg;
+	size = _DWARF_DIE_SIZE(ab);
+
+	if ((die = ab->ab_free) != NULL) {
+		ab->ab_free = *(Dwarf_Die *) (void *) die;
+		c = die->die_chunk;
+	} else {
+		if (size > cu->cu_die_avail) {
+			head = cu->cu_die_chunks;
+			csize = head == NULL ? _DWARF_DIE_CHUNK_MIN :
+			    head->c_hdr.c_size * 2;
+			if (csize > _DWARF_DIE_CHUNK_MAX)
+				csize = _DWARF_DIE_CHUNK_MAX;
+			if (csize < sizeof(*c) + size)
+				csize = sizeof(*c) + size;
+			if ((c = malloc(csize)) == NULL) {
+				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+				return (DW_DLE_MEMORY);
+			}
+			c->c_hdr.c_next = head;
+			c->c_hdr.c_size = csize;
+			c->c_hdr.c_used = 0;
+			c->c_hdr.c_live = 0;
+			cu->cu_die_chunks = c;
+			cu->cu_die_free = (uint8_t *) (c + 1);
+			cu->cu_die_avail = csize - sizeof(*c);
+		}
+		c = cu->cu_die_chunks;
+		c->c_hdr.c_used += size;
+		die = (Dwarf_Die) (void *) cu->cu_die_free;
+		cu->cu_die_free += size;
+		cu->cu_die_avail -= size;
+	}
 
-	if ((ret = _dwarf_die_alloc(dbg, &die, error)) != DW_DLE_NONE)
-		return (ret);
+	c->c_hdr.c_live++;
 
+	memset(die, 0, size);
 	die->die_offset	= offset;
-	die->die_abnum	= abnum;
 	die->die_ab	= ab;
+	die->die_chunk	= c;
 	die->die_cu	= cu;
 	die->die_dbg	= cu->cu_dbg;
 
@@ -76,6 +138,221 @@ _dwarf_die_add(Dwarf_CU cu, uint64_t offset, uint64_t abnum, Dwarf_Abbrev ab,
 	return (DW_DLE_NONE);
 }
 
+/*
+ * Decode the attributes of a DIE read from a file into descriptors
+ * that the application can retrieve, followed by the array of them
+ * returned by dwarf_attrlist().
+ */
+int
+_dwarf_die_attr_init(Dwarf_Die die, Dwarf_Error *error)
+{
+	Dwarf_Attribute attrs;
+	uint64_t i, n;
+	int ret;
+
+	assert(die->die_chunk != NULL && die->die_attrs == NULL);
+
+	if ((n = die->die_ab->ab_atnum) == 0)
+		return (DW_DLE_NONE);
+
+	if ((attrs = malloc(n * (sizeof(struct _Dwarf_Attribute) +
+	    sizeof(Dwarf_Attribute)))) == NULL) {
+		DWARF_SET_ERROR(die->die_dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+
+	for (i = 0; i < n; i++) {
+		if ((ret = _dwarf_attr_decode(die, i, &attrs[i], error)) !=
+		    DW_DLE_NONE) {
+			free(attrs);
+			return (ret);
+		}
+	}
+
+	die->die_attrs = attrs;
+	for (i = 0; i < n; i++)
+		_DWARF_DIE_ATTRLIST(die)[i] = &attrs[i];
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Free the memory hanging off a DIE read from a file.
+ */
+static void
+_dwarf_die_free_attrs(Dwarf_Die die)
+{
+	Dwarf_Locdesc *ld;
+	uint64_t i;
+
+	if (die->die_attrs) {
+		for (i = 0; i < die->die_ab->ab_atnum; i++)
+			if ((ld = die->die_attrs[i].at_ld) != NULL) {
+				if (ld->ld_s)
+					free(ld->ld_s);
+				free(ld);
+			}
+		free(die->die_attrs);
+		die->die_attrs = NULL;
+	}
+}
+
+/*
+ * Release a DIE read from a file, keeping its storage for reuse.  A
+ * DIE that outlived its unit only counts down the DIEs of its chunk.
+ */
+void
+_dwarf_die_release(Dwarf_Die die)
+{
+	union _Dwarf_Die_Chunk *c;
+	Dwarf_Abbrev ab;
+
+	assert(die != NULL && die->die_chunk != NULL);
+
+	c = die->die_chunk;
+	c->c_hdr.c_live--;
+	if (die->die_cu == NULL) {
+		if (c->c_hdr.c_live == 0)
+			free(c);
+		return;
+	}
+
+	_dwarf_die_free_attrs(die);
+
+	ab = die->die_ab;
+	die->die_cu = NULL;
+	*(Dwarf_Die *) (void *) die = ab->ab_free;
+	ab->ab_free = die;
+}
+
+/*
+ * Free the storage of the DIEs read from a unit.  The DIEs in a chunk
+ * are laid out back to back, each followed by the attribute offsets
+ * of its abbrev, so the abbrevs of the unit must still be present.
+ * DIEs that the application did not release lose their attributes and
+ * their unit, but stay allocated until they are released.
+ */
+void
+_dwarf_die_cleanup(Dwarf_CU cu)
+{
+	union _Dwarf_Die_Chunk *c, *tc;
+	Dwarf_Die die;
+	uint8_t *end, *p;
+
+	for (c = cu->cu_die_chunks; c != NULL; c = tc) {
+		tc = c->c_hdr.c_next;
+		if (c->c_hdr.c_live == 0) {
+			free(c);
+			continue;
+		}
+		p = (uint8_t *) (c + 1);
+		end = p + c->c_hdr.c_used;
+		while (p < end) {
+			die = (Dwarf_Die) (void *) p;
+			p += _DWARF_DIE_SIZE(die->die_ab);
+			if (die->die_cu == NULL)
+				continue;
+			_dwarf_die_free_attrs(die);
+			die->die_cu = NULL;
+			die->die_ab = NULL;
+		}
+	}
+	cu->cu_die_chunks = NULL;
+	cu->cu_die_free = NULL;
+	cu->cu_die_avail = 0;
+}
+
+/*
+ * Look up the DIE at section offset 'offset' in the DIE cache of a
+ * unit.  A DIE that is found is moved to the tail of the cache, which
+ * is kept in least recently used order, and gains a reference that
+ * the caller releases using dwarf_dealloc().
+ */
+static Dwarf_Die
+_dwarf_die_cache_find(Dwarf_CU cu, uint64_t offset)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Die die;
+
+	dbg = cu->cu_dbg;
+
+	HASH_FIND(die_hh, cu->cu_die_cache, &offset, sizeof(offset), die);
+	if (die == NULL)
+		return (NULL);
+
+	HASH_DELETE(die_hh, cu->cu_die_cache, die);
+	HASH_ADD(die_hh, cu->cu_die_cache, die_offset,
+	    sizeof(die->die_offset), die);
+	die->die_refcnt++;
+	dbg->dbg_die_cache_hits++;
+
+	return (die);
+}
+
+/*
+ * Add a newly parsed DIE to the DIE cache of a unit, evicting the least
+ * recently used DIEs as needed to stay within the limit.  The cache
+ * and the caller each hold a reference to the DIE.
+ */
+static void
+_dwarf_die_cache_add(Dwarf_CU cu, Dwarf_Die die)
+{
+	Dwarf_Debug dbg;
+
+	dbg = cu->cu_dbg;
+
+	assert(dbg->dbg_die_cache_limit > 0);
+
+	_dwarf_die_cache_trim(cu, dbg->dbg_die_cache_limit - 1);
+
+	HASH_ADD(die_hh, cu->cu_die_cache, die_offset,
+	    sizeof(die->die_offset), die);
+	die->die_refcnt = 2;
+	dbg->dbg_die_cache_misses++;
+}
+
+/*
+ * Release the references held by the DIE cache of a unit until no more
+ * than 'limit' DIEs remain in it.  DIEs that are still referenced by
+ * the application stay allocated until it calls dwarf_dealloc().
+ */
+void
+_dwarf_die_cache_trim(Dwarf_CU cu, Dwarf_Unsigned limit)
+{
+	Dwarf_Die die;
+
+	while (HASH_CNT(die_hh, cu->cu_die_cache) > limit) {
+		die = cu->cu_die_cache;
+		HASH_DELETE(die_hh, cu->cu_die_cache, die);
+		dwarf_dealloc(cu->cu_dbg, die, DW_DLA_DIE);
+	}
+}
+
+/*
+ * Advance '*offsetp' past the attributes of a DIE using abbrev 'ab',
+ * without allocating or decoding them.
+ */
+static int
+_dwarf_die_skip(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
+    int dwarf_size, Dwarf_Abbrev ab, uint64_t *offsetp, Dwarf_Error *error)
+{
+	Dwarf_AttrDef ad;
+	int ret;
+
+	if (ab->ab_skip_fixed) {
+		*offsetp += ab->ab_skip;
+		return (DW_DLE_NONE);
+	}
+
+	STAILQ_FOREACH(ad, &ab->ab_attrdef, ad_next) {
+		if ((ret = _dwarf_attr_skip(dbg, ds, offsetp, dwarf_size, cu,
+		    ad->ad_form, error)) != DW_DLE_NONE)
+			return (ret);
+	}
+
+	return (DW_DLE_NONE);
+}
+
 /* Find die at offset 'off' within the same CU. */
 Dwarf_Die
 _dwarf_die_find(Dwarf_Die die, Dwarf_Unsigned off)
@@ -108,7 +385,8 @@ _dwarf_die_parse(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
 	Dwarf_Abbrev ab;
 	Dwarf_AttrDef ad;
 	Dwarf_Die die;
-	uint64_t abnum;
+	uint64_t abnum, i;
+	uint32_t *attroff;
 	uint64_t die_offset;
 	int ret, level;
 
@@ -121,6 +399,14 @@ _dwarf_die_parse(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
 
 		die_offset = offset;
 
+		/* Return a previously parsed DIE if one is cached. */
+		if (dbg->dbg_die_cache_limit > 0 &&
+		    (level == 0 || !search_sibling) &&
+		    (die = _dwarf_die_cache_find(cu, die_offset)) != NULL) {
+			*ret_die = die;
+			return (DW_DLE_NONE);
+		}
+
 		abnum = _dwarf_read_uleb128(ds->ds_data, &offset);
 
 		if (abnum == 0) {
@@ -138,28 +424,52 @@ _dwarf_die_parse(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
 		    DW_DLE_NONE)
 			return (ret);
 
-		if ((ret = _dwarf_die_add(cu, die_offset, abnum, ab, &die,
-		    error)) != DW_DLE_NONE)
+		/*
+		 * DIEs preceding the sibling being searched for are
+		 * skipped over without being materialized.
+		 */
+		if (search_sibling && level > 0) {
+			if ((ret = _dwarf_die_skip(dbg, ds, cu, dwarf_size, ab,
+			    &offset, error)) != DW_DLE_NONE)
+				return (ret);
+			if (ab->ab_children == DW_CHILDREN_yes) {
+				/* Advance to next DIE level. */
+				level++;
+			}
+			continue;
+		}
+
+		if ((ret = _dwarf_die_add(cu, die_offset, ab, &die, error)) !=
+		    DW_DLE_NONE)
 			return (ret);
 
+		/*
+		 * Record where the value of each attribute starts.  The
+		 * values are decoded when they are looked up.
+		 */
+		attroff = _DWARF_DIE_ATTROFF(die);
+		i = 0;
 		STAILQ_FOREACH(ad, &ab->ab_attrdef, ad_next) {
-			if ((ret = _dwarf_attr_init(dbg, ds, &offset,
-			    dwarf_size, cu, die, ad, ad->ad_form, 0,
-			    error)) != DW_DLE_NONE)
+			if (offset - die_offset > UINT32_MAX) {
+				_dwarf_die_release(die);
+				DWARF_SET_ERROR(dbg, error,
+				    DW_DLE_CU_LENGTH_ERROR);
+				return (DW_DLE_CU_LENGTH_ERROR);
+			}
+			attroff[i++] = (uint32_t) (offset - die_offset);
+			if ((ret = _dwarf_attr_skip(dbg, ds, &offset,
+			    dwarf_size, cu, ad->ad_form, error)) !=
+			    DW_DLE_NONE) {
+				_dwarf_die_release(die);
 				return (ret);
+			}
 		}
 
 		die->die_next_off = offset;
-		if (search_sibling && level > 0) {
-			dwarf_dealloc(dbg, die, DW_DLA_DIE);
-			if (ab->ab_children == DW_CHILDREN_yes) {
-				/* Advance to next DIE level. */
-				level++;
-			}
-		} else {
-			*ret_die = die;
-			return (DW_DLE_NONE);
-		}
+		if (dbg->dbg_die_cache_limit > 0)
+			_dwarf_die_cache_add(cu, die);
+		*ret_die = die;
+		return (DW_DLE_NONE);
 	}
 
 	return (DW_DLE_NO_ENTRY);
@@ -33,6 +33,7 @@ _dwarf_elf_get_section_info(void *obj, Dwarf_Half ndx,
     Dwarf_Obj_Access_Section *ret_section, int *error)
 {
 	Dwarf_Elf_Object *e;
+	Dwarf_Elf_Data *ed;
 	GElf_Shdr *sh;
 
 	e = obj;
@@ -51,11 +52,17 @@ _dwarf_elf_get_section_info(void *obj, Dwarf_Half ndx,
 	}
 
 	sh = &e->eo_shdr[ndx];
+	ed = &e->eo_data[ndx];
 
+	/*
+	 * The contents of compressed sections are inflated by
+	 * _dwarf_elf_init(), so their size is that of their data descriptor.
+	 */
 	ret_section->addr = sh->sh_addr;
-	ret_section->size = sh->sh_size;
+	ret_section->size = ed->ed_data != NULL ? ed->ed_data->d_size :
+	    sh->sh_size;
 
-	ret_section->name = elf_strptr(e->eo_elf, e->eo_strndx, sh->sh_name);
+	ret_section->name = ed->ed_name;
 	if (ret_section->name == NULL) {
 		if (error)
 			*error = DW_DLE_ELF;
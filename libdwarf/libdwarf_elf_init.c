@@ -24,6 +24,8 @@
  * SUCH DAMAGE.
  */
 
+#include <zlib.h>
+
 #include "_libdwarf.h"
 
 ELFTC_VCSID("$Id$");
@@ -49,6 +51,138 @@ static const char *debug_name[] = {
 	NULL
 };
 
+/*
+ * Return the DWARF section name for an ELF section name, or NULL if
+ * the section does not hold DWARF information.  Sections compressed
+ * in the legacy GNU format are named ".zdebug_*" in place of
+ * ".debug_*".
+ */
+static const char *
+_dwarf_elf_debug_name(const char *name)
+{
+	int i;
+
+	for (i = 0; debug_name[i] != NULL; i++) {
+		if (!strcmp(name, debug_name[i]))
+			return (debug_name[i]);
+		if (!strncmp(name, ".z", 2) &&
+		    !strncmp(debug_name[i], ".debug_", 7) &&
+		    !strcmp(name + 2, debug_name[i] + 1))
+			return (debug_name[i]);
+	}
+
+	return (NULL);
+}
+
+/*
+ * Inflate the contents of a compressed section into a buffer owned
+ * by libdwarf, leaving the ELF descriptor of the application alone.
+ * Sections are compressed either with an ELF compression header
+ * (SHF_COMPRESSED), or in the legacy GNU format used by ".zdebug_*"
+ * sections, where a "ZLIB" tag and a big-endian 64-bit size precede
+ * the compressed stream.
+ */
+static int
+_dwarf_elf_inflate(Dwarf_Debug dbg, Dwarf_Elf_Object *e, Dwarf_Elf_Data *ed,
+    int gnu, Dwarf_Error *error)
+{
+	uint64_t (*read_word)(uint8_t *, uint64_t *, int);
+	uint64_t ch_size, ch_type, hdrsz, offset;
+	uint8_t *buf, *src;
+	size_t dsz, n, ssz;
+	z_stream zs;
+	int rc;
+
+	src = ed->ed_data->d_buf;
+	ssz = ed->ed_data->d_size;
+
+	if (e->eo_ehdr.e_ident[EI_DATA] == ELFDATA2MSB)
+		read_word = _dwarf_read_msb;
+	else
+		read_word = _dwarf_read_lsb;
+
+	if (gnu) {
+		hdrsz = 12;
+		if (ssz < hdrsz || memcmp(src, "ZLIB", 4) != 0)
+			goto corrupt;
+		offset = 4;
+		ch_type = ELFCOMPRESS_ZLIB;
+		ch_size = _dwarf_read_msb(src, &offset, 8);
+	} else if (e->eo_ehdr.e_ident[EI_CLASS] == ELFCLASS32) {
+		hdrsz = sizeof(Elf32_Chdr);
+		if (ssz < hdrsz)
+			goto corrupt;
+		offset = 0;
+		ch_type = read_word(src, &offset, 4);
+		ch_size = read_word(src, &offset, 4);
+	} else {
+		hdrsz = sizeof(Elf64_Chdr);
+		if (ssz < hdrsz)
+			goto corrupt;
+		offset = 0;
+		ch_type = read_word(src, &offset, 4);
+		offset += 4;		/* ch_reserved */
+		ch_size = read_word(src, &offset, 8);
+	}
+
+	if (ch_type != ELFCOMPRESS_ZLIB) {
+		_DWARF_SET_ERROR(dbg, error, DW_DLE_ELF, ELF_E_UNIMPL);
+		return (DW_DLE_ELF);
+	}
+
+	if (ch_size > SIZE_MAX ||
+	    (buf = malloc(ch_size > 0 ? (size_t) ch_size : 1)) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+
+	(void) memset(&zs, 0, sizeof(zs));
+	if (inflateInit(&zs) != Z_OK) {
+		free(buf);
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+
+	zs.next_in = src + hdrsz;
+	zs.next_out = buf;
+	ssz -= hdrsz;
+	dsz = (size_t) ch_size;
+
+	/* zlib counts in units of `uInt', so feed it in pieces. */
+	do {
+		if (zs.avail_in == 0 && ssz > 0) {
+			n = MIN(ssz, UINT_MAX);
+			zs.avail_in = (uInt) n;
+			ssz -= n;
+		}
+		if (zs.avail_out == 0 && dsz > 0) {
+			n = MIN(dsz, UINT_MAX);
+			zs.avail_out = (uInt) n;
+			dsz -= n;
+		}
+		rc = inflate(&zs, Z_NO_FLUSH);
+	} while (rc == Z_OK);
+
+	(void) inflateEnd(&zs);
+
+	if (rc != Z_STREAM_END || zs.avail_out != 0 || dsz != 0) {
+		free(buf);
+		goto corrupt;
+	}
+
+	ed->ed_alloc = buf;
+	ed->ed_zdata = *ed->ed_data;
+	ed->ed_zdata.d_buf = buf;
+	ed->ed_zdata.d_size = (size_t) ch_size;
+	ed->ed_data = &ed->ed_zdata;
+
+	return (DW_DLE_NONE);
+
+corrupt:
+	_DWARF_SET_ERROR(dbg, error, DW_DLE_ELF, ELF_E_SECTION);
+	return (DW_DLE_ELF);
+}
+
 static void
 _dwarf_elf_apply_rel_reloc(Dwarf_Debug dbg, void *buf, uint64_t bufsize,
     Elf_Data *rel_data, Elf_Data *symtab_data, int endian)
@@ -168,13 +302,17 @@ _dwarf_elf_relocate(Dwarf_Debug dbg, Elf *elf, Dwarf_Elf_Data *ed, size_t shndx,
 					return (DW_DLE_NONE);
 			}
 
-			ed->ed_alloc = malloc(ed->ed_data->d_size);
+			/* Inflated contents are already a private copy. */
 			if (ed->ed_alloc == NULL) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
-				return (DW_DLE_MEMORY);
+				ed->ed_alloc = malloc(ed->ed_data->d_size);
+				if (ed->ed_alloc == NULL) {
+					DWARF_SET_ERROR(dbg, error,
+					    DW_DLE_MEMORY);
+					return (DW_DLE_MEMORY);
+				}
+				memcpy(ed->ed_alloc, ed->ed_data->d_buf,
+				    ed->ed_data->d_size);
 			}
-			memcpy(ed->ed_alloc, ed->ed_data->d_buf,
-			    ed->ed_data->d_size);
 			if (sh.sh_type == SHT_REL)
 				_dwarf_elf_apply_rel_reloc(dbg,
 				    ed->ed_alloc, ed->ed_data->d_size,
@@ -206,7 +344,7 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 	Elf_Scn *scn;
 	Elf_Data *symtab_data;
 	size_t symtab_ndx;
-	int elferr, i, j, n, ret;
+	int elferr, j, n, ret;
 
 	ret = DW_DLE_NONE;
 
@@ -281,10 +419,8 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 			continue;
 		}
 
-		for (i = 0; debug_name[i] != NULL; i++) {
-			if (!strcmp(name, debug_name[i]))
-				n++;
-		}
+		if (_dwarf_elf_debug_name(name) != NULL)
+			n++;
 	}
 	elferr = elf_errno();
 	if (elferr != 0) {
@@ -322,31 +458,41 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 			goto fail_cleanup;
 		}
 
-		for (i = 0; debug_name[i] != NULL; i++) {
-			if (strcmp(name, debug_name[i]))
-				continue;
+		if ((e->eo_data[j].ed_name = _dwarf_elf_debug_name(name)) ==
+		    NULL)
+			continue;
 
-			(void) elf_errno();
-			if ((e->eo_data[j].ed_data = elf_getdata(scn, NULL)) ==
-			    NULL) {
-				elferr = elf_errno();
-				if (elferr != 0) {
-					_DWARF_SET_ERROR(dbg, error,
-					    DW_DLE_ELF, elferr);
-					ret = DW_DLE_ELF;
-					goto fail_cleanup;
-				}
+		(void) elf_errno();
+		if ((e->eo_data[j].ed_data = elf_getdata(scn, NULL)) == NULL) {
+			elferr = elf_errno();
+			if (elferr != 0) {
+				_DWARF_SET_ERROR(dbg, error,
+				    DW_DLE_ELF, elferr);
+				ret = DW_DLE_ELF;
+				goto fail_cleanup;
 			}
+		}
 
-			if (_libdwarf.applyreloc) {
-				if (_dwarf_elf_relocate(dbg, elf,
-				    &e->eo_data[j], elf_ndxscn(scn), symtab_ndx,
-				    symtab_data, error) != DW_DLE_NONE)
-					goto fail_cleanup;
-			}
+		/*
+		 * elf_getdata() returns the contents of compressed
+		 * sections as stored.
+		 */
+		if (e->eo_data[j].ed_data != NULL &&
+		    ((sh.sh_flags & SHF_COMPRESSED) ||
+		    strcmp(name, e->eo_data[j].ed_name) != 0) &&
+		    (ret = _dwarf_elf_inflate(dbg, e, &e->eo_data[j],
+		    (sh.sh_flags & SHF_COMPRESSED) == 0, error)) !=
+		    DW_DLE_NONE)
+			goto fail_cleanup;
 
-			j++;
+		if (_libdwarf.applyreloc) {
+			if (_dwarf_elf_relocate(dbg, elf,
+			    &e->eo_data[j], elf_ndxscn(scn), symtab_ndx,
+			    symtab_data, error) != DW_DLE_NONE)
+				goto fail_cleanup;
 		}
+
+		j++;
 	}
 
 	assert(j == n);
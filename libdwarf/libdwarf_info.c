@@ -135,13 +135,97 @@ _dwarf_info_next_tu(Dwarf_Debug dbg, Dwarf_Error *error)
 	return (DW_DLE_NONE);
 }
 
+/*
+ * Build an array of the units of the .debug_info or .debug_types
+ * section, once all of them have been loaded.  Units are loaded in
+ * section order, so the array is sorted by offset.
+ */
+static int
+_dwarf_info_index(Dwarf_Debug dbg, Dwarf_Bool is_info, Dwarf_Error *error)
+{
+	Dwarf_CU cu, *index;
+	Dwarf_Unsigned cnt, i;
+
+	cnt = 0;
+	if (is_info) {
+		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+			cnt++;
+	} else {
+		STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next)
+			cnt++;
+	}
+
+	index = NULL;
+	if (cnt > 0 && (index = malloc(cnt * sizeof(Dwarf_CU))) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+
+	i = 0;
+	if (is_info) {
+		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+			index[i++] = cu;
+		free(dbg->dbg_cu_index);
+		dbg->dbg_cu_index = index;
+		dbg->dbg_cu_index_cnt = cnt;
+	} else {
+		STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next)
+			index[i++] = cu;
+		free(dbg->dbg_tu_index);
+		dbg->dbg_tu_index = index;
+		dbg->dbg_tu_index_cnt = cnt;
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Find the unit containing the section offset `offset', using a binary
+ * search of the unit index.  All units must have been loaded.
+ */
+Dwarf_CU
+_dwarf_info_find_cu(Dwarf_Debug dbg, Dwarf_Bool is_info, Dwarf_Off offset)
+{
+	Dwarf_CU cu, *index;
+	Dwarf_Unsigned hi, lo, mid;
+
+	if (is_info) {
+		assert(dbg->dbg_info_loaded);
+		index = dbg->dbg_cu_index;
+		hi = dbg->dbg_cu_index_cnt;
+	} else {
+		assert(dbg->dbg_types_loaded);
+		index = dbg->dbg_tu_index;
+		hi = dbg->dbg_tu_index_cnt;
+	}
+
+	/* Look for the last unit starting at or before `offset'. */
+	lo = 0;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (index[mid]->cu_offset <= offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == 0)
+		return (NULL);
+
+	cu = index[lo - 1];
+	if (offset >= cu->cu_next_offset)
+		return (NULL);
+
+	return (cu);
+}
+
 int
 _dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
     Dwarf_Error *error)
 {
 	Dwarf_CU cu;
 	Dwarf_Section *ds;
-	int dwarf_size, ret;
+	int dwarf_size, iret, ret;
 	uint64_t length;
 	uint64_t next_offset;
 	uint64_t offset;
@@ -239,12 +323,25 @@ _dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
 			break;
 	}
 
+	/*
+	 * Once all units are loaded, index them.  If the index cannot
+	 * be built, the section is not marked as loaded, so that the
+	 * next call retries.
+	 */
 	if (is_info) {
-		if ((Dwarf_Unsigned) dbg->dbg_info_off >= ds->ds_size)
+		if ((Dwarf_Unsigned) dbg->dbg_info_off >= ds->ds_size) {
+			if ((iret = _dwarf_info_index(dbg, 1, error)) !=
+			    DW_DLE_NONE)
+				return (iret);
 			dbg->dbg_info_loaded = 1;
+		}
 	} else {
-		if ((Dwarf_Unsigned) dbg->dbg_types_off >= ds->ds_size)
+		if ((Dwarf_Unsigned) dbg->dbg_types_off >= ds->ds_size) {
+			if ((iret = _dwarf_info_index(dbg, 0, error)) !=
+			    DW_DLE_NONE)
+				return (iret);
 			dbg->dbg_types_loaded = 1;
+		}
 	}
 
 	return (ret);
@@ -259,6 +356,8 @@ _dwarf_info_cleanup(Dwarf_Debug dbg)
 
 	STAILQ_FOREACH_SAFE(cu, &dbg->dbg_cu, cu_next, tcu) {
 		STAILQ_REMOVE(&dbg->dbg_cu, cu, _Dwarf_CU, cu_next);
+		_dwarf_die_cache_trim(cu, 0);
+		_dwarf_die_cleanup(cu);
 		_dwarf_abbrev_cleanup(cu);
 		if (cu->cu_lineinfo != NULL) {
 			_dwarf_lineno_cleanup(cu->cu_lineinfo);
@@ -267,6 +366,10 @@ _dwarf_info_cleanup(Dwarf_Debug dbg)
 		free(cu);
 	}
 
+	free(dbg->dbg_cu_index);
+	dbg->dbg_cu_index = NULL;
+	dbg->dbg_cu_index_cnt = 0;
+
 	_dwarf_type_unit_cleanup(dbg);
 }
 
@@ -279,9 +382,15 @@ _dwarf_type_unit_cleanup(Dwarf_Debug dbg)
 
 	STAILQ_FOREACH_SAFE(cu, &dbg->dbg_tu, cu_next, tcu) {
 		STAILQ_REMOVE(&dbg->dbg_tu, cu, _Dwarf_CU, cu_next);
+		_dwarf_die_cache_trim(cu, 0);
+		_dwarf_die_cleanup(cu);
 		_dwarf_abbrev_cleanup(cu);
 		free(cu);
 	}
+
+	free(dbg->dbg_tu_index);
+	dbg->dbg_tu_index = NULL;
+	dbg->dbg_tu_index_cnt = 0;
 }
 
 int
@@ -253,6 +253,7 @@ _dwarf_lineno_init(Dwarf_Die die, uint64_t offset, Dwarf_Error *error)
 	Dwarf_Debug dbg;
 	Dwarf_Section *ds;
 	Dwarf_CU cu;
+	struct _Dwarf_Attribute atbuf;
 	Dwarf_Attribute at;
 	Dwarf_LineInfo li;
 	Dwarf_LineFile lf, tlf;
@@ -275,7 +276,7 @@ _dwarf_lineno_init(Dwarf_Die die, uint64_t offset, Dwarf_Error *error)
 	 * will use the dir to create full pathnames, if need.
 	 */
 	compdir = NULL;
-	at = _dwarf_attr_find(die, DW_AT_comp_dir);
+	at = _dwarf_attr_get(die, DW_AT_comp_dir, &atbuf);
 	if (at != NULL) {
 		switch (at->at_form) {
 		case DW_FORM_strp:
@@ -109,10 +109,9 @@ _dwarf_nametbl_init(Dwarf_Debug dbg, Dwarf_NameSec *namesec, Dwarf_Section *ds,
 		}
 
 		/* Find the referenced CU. */
-		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next) {
-			if (cu->cu_offset == nt->nt_cu_offset)
-				break;
-		}
+		cu = _dwarf_info_find_cu(dbg, 1, nt->nt_cu_offset);
+		if (cu != NULL && cu->cu_offset != nt->nt_cu_offset)
+			cu = NULL;
 		nt->nt_cu = cu;	/* FIXME: Check if NULL here */
 
 		/* Add name pairs. */
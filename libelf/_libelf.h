@@ -31,6 +31,8 @@
 
 #include <sys/queue.h>
 
+#include <pthread.h>
+
 #include "_libelf_config.h"
 
 #include "_elftc.h"
@@ -41,19 +43,38 @@
 
 #define LIBELF_MSG_SIZE	256
 
+/*
+ * Process-wide state.  The working version and the fill character
+ * are expected to be set before an application starts using libelf
+ * from multiple threads.
+ */
 struct _libelf_globals {
 	int		libelf_arch;
 	unsigned int	libelf_byteorder;
 	int		libelf_class;
-	int		libelf_error;
 	int		libelf_fillchar;
 	unsigned int	libelf_version;
+};
+
+/*
+ * Per-thread state.
+ */
+struct _libelf_thread_globals {
+	int		libelf_error;
 	unsigned char	libelf_msg[LIBELF_MSG_SIZE];
 };
 
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define	LIBELF_THREAD_LOCAL	_Thread_local
+#else
+#define	LIBELF_THREAD_LOCAL	__thread
+#endif
+
 extern struct _libelf_globals _libelf;
+extern LIBELF_THREAD_LOCAL struct _libelf_thread_globals _libelf_thread;
 
 #define	LIBELF_PRIVATE(N)	(_libelf.libelf_##N)
+#define	LIBELF_THREAD_PRIVATE(N)	(_libelf_thread.libelf_##N)
 
 #define	LIBELF_ELF_ERROR_MASK			0xFF
 #define	LIBELF_OS_ERROR_SHIFT			8
@@ -62,11 +83,20 @@ extern struct _libelf_globals _libelf;
 	((O) << LIBELF_OS_ERROR_SHIFT))
 
 #define	LIBELF_SET_ERROR(E, O) do {					\
-		LIBELF_PRIVATE(error) = LIBELF_ERROR(ELF_E_##E, (O));	\
+		LIBELF_THREAD_PRIVATE(error) =				\
+		    LIBELF_ERROR(ELF_E_##E, (O));			\
 	} while (0)
 
 #define	LIBELF_ADJUST_AR_SIZE(S)	(((S) + 1U) & ~1U)
 
+/*
+ * Serialize the lazy initialization of a descriptor's internal state,
+ * so that an ELF_C_READ descriptor may be shared between threads.
+ * The lock is recursive.
+ */
+#define	LIBELF_LOCK(E)		(void) pthread_mutex_lock(&(E)->e_lock)
+#define	LIBELF_UNLOCK(E)	(void) pthread_mutex_unlock(&(E)->e_lock)
+
 /*
  * Flags for library internal use.  These use the upper 16 bits of the
  * `e_flags' field.
@@ -77,8 +107,25 @@ extern struct _libelf_globals _libelf;
 #define	LIBELF_F_DATA_MALLOCED	0x040000U /* whether data was malloc'ed */
 #define	LIBELF_F_RAWFILE_MALLOC	0x080000U /* whether e_rawfile was malloc'ed */
 #define	LIBELF_F_RAWFILE_MMAP	0x100000U /* whether e_rawfile was mmap'ed */
-#define	LIBELF_F_SHDRS_LOADED	0x200000U /* whether all shdrs were read in */
+#define	LIBELF_F_SHDRS_LOADED	0x200000U /* whether the shdr table was checked */
 #define	LIBELF_F_SPECIAL_FILE	0x400000U /* non-regular file */
+#define	LIBELF_F_DATA_CACHED	0x800000U /* data is in the data cache */
+#define	LIBELF_F_STREAM		0x1000000U /* object read by elf_stream() */
+#define	LIBELF_F_INFLATED	0x2000000U /* section contents were inflated */
+
+/*
+ * A simple arena for fixed-size internal descriptors.  Objects are
+ * carved out of chunks of increasing size, released objects are kept
+ * on a free list for reuse, and the chunks are only given up when the
+ * arena as a whole is released.  See libelf_allocate.c.
+ */
+struct _Libelf_Arena {
+	union _Libelf_Chunk *a_chunks;	/* list of chunks */
+	void		*a_free;	/* list of released objects */
+	unsigned char	*a_next;	/* next unused object */
+	size_t		a_avail;	/* #unused objects in chunk */
+	unsigned int	a_nchunks;	/* #chunks allocated */
+};
 
 struct _Elf {
 	int		e_activations;	/* activation count */
@@ -88,8 +135,10 @@ struct _Elf {
 	int		e_fd;		/* associated file descriptor */
 	unsigned int	e_flags;	/* ELF_F_* & LIBELF_F_* flags */
 	Elf_Kind	e_kind;		/* ELF_K_* */
+	pthread_mutex_t	e_lock;		/* see LIBELF_LOCK() */
 	Elf		*e_parent; 	/* non-NULL for archive members */
 	unsigned char	*e_rawfile;	/* uninterpreted bytes */
+	off_t		e_rawoff;	/* file offset of e_rawfile */
 	off_t		e_rawsize;	/* size of uninterpreted bytes */
 	unsigned int	e_version;	/* file version */
 
@@ -112,6 +161,8 @@ struct _Elf {
 			size_t	e_rawsymtabsz;
 			Elf_Arsym *e_symtab;
 			size_t	e_symtabsz;
+			size_t	*e_symhash;	/* see elf_arsym_lookup() */
+			size_t	e_symhashsz;
 		} e_ar;
 		struct {		/* regular ELF files */
 			union {
@@ -123,9 +174,17 @@ struct _Elf {
 				Elf64_Phdr *e_phdr64;
 			} e_phdr;
 			STAILQ_HEAD(, _Elf_Scn)	e_scn;	/* section list */
+			Elf_Scn	**e_scntab;	/* sections by index */
+			size_t	e_scntabsz;	/* size of e_scntab */
+			uint64_t e_shoff;	/* offset of the shdr table */
 			size_t	e_nphdr;	/* number of Phdr entries */
 			size_t	e_nscn;		/* number of sections */
 			size_t	e_strndx;	/* string table section index */
+			struct _Libelf_Arena e_scnarena; /* for Elf_Scn */
+			struct _Libelf_Arena e_dataarena; /* for Elf_Data */
+			unsigned char *e_window; /* see elf_stream() */
+			uint64_t e_windowoff; /* file offset of e_window */
+			size_t	e_windowsz;	/* size of e_window */
 		} e_elf;
 	} e_u;
 };
@@ -138,6 +197,7 @@ struct _Libelf_Data {
 	Elf_Scn		*d_scn;		/* The containing section */
 	unsigned int	d_flags;
 	STAILQ_ENTRY(_Libelf_Data) d_next;
+	TAILQ_ENTRY(_Libelf_Data) d_lru; /* see LIBELF_F_DATA_CACHED */
 };
 
 struct _Elf_Scn {
@@ -154,8 +214,22 @@ struct _Elf_Scn {
 	uint64_t	s_offset;	/* managed by elf_update() */
 	uint64_t	s_rawoff;	/* original offset in the file */
 	uint64_t	s_size;		/* managed by elf_update() */
+	int		s_ctype;	/* LIBELF_COMPRESS_* */
+	unsigned char	*s_zimage;	/* compressed contents for elf_update() */
+	size_t		s_zsize;	/* size of the above */
+	struct _Libelf_Data *s_strdata;	/* see elf_strptr() */
 };
 
+/*
+ * The ways in which the contents of a section may be stored
+ * compressed, see the `s_ctype' member of section descriptors and
+ * elf_compress().  The data descriptors of such sections hold their
+ * uncompressed contents.
+ */
+#define	LIBELF_COMPRESS_NONE	0	/* stored as is */
+#define	LIBELF_COMPRESS_CHDR	1	/* SHF_COMPRESSED, with an Elf_Chdr */
+#define	LIBELF_COMPRESS_GNU	2	/* legacy GNU ".zdebug" format */
+
 
 enum {
 	ELF_TOFILE,
@@ -197,6 +271,15 @@ enum {
 typedef int _libelf_translator_function(unsigned char *_dst, size_t dsz,
     unsigned char *_src, size_t _cnt, int _byteswap);
 
+/*
+ * Byte swapping kernels permute the bytes of each LIBELF_BSWAP_BLOCKSZ
+ * sized block of their source and return the number of bytes converted.
+ */
+#define	LIBELF_BSWAP_BLOCKSZ	48
+
+typedef size_t _libelf_bswap_function(unsigned char *_dst,
+    const unsigned char *_src, size_t _sz, const unsigned char *_perm);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -205,26 +288,48 @@ Elf	*_libelf_allocate_elf(void);
 Elf_Scn	*_libelf_allocate_scn(Elf *_e, size_t _ndx);
 Elf_Arhdr *_libelf_ar_gethdr(Elf *_e);
 Elf	*_libelf_ar_open(Elf *_e, int _reporterror);
-Elf	*_libelf_ar_open_member(int _fd, Elf_Cmd _c, Elf *_ar);
+Elf	*_libelf_ar_open_member(int _fd, Elf_Cmd _c, Elf *_ar,
+    off_t _off);
 Elf_Arsym *_libelf_ar_process_bsd_symtab(Elf *_ar, size_t *_dst);
 Elf_Arsym *_libelf_ar_process_svr4_symtab(Elf *_ar, size_t *_dst);
+void	_libelf_cache_enter(struct _Libelf_Data *_d);
+void	_libelf_cache_enter_elf(Elf *_e);
+void	_libelf_cache_hit(struct _Libelf_Data *_d);
+void	_libelf_cache_remove(struct _Libelf_Data *_d);
 long	 _libelf_checksum(Elf *_e, int _elfclass);
+int	_libelf_compress_scn(Elf_Scn *_s, uint64_t _size, uint64_t _align);
+uint64_t _libelf_compression_align(int _ctype, int _elfclass);
+int	_libelf_compression_type(Elf_Scn *_s);
+size_t	_libelf_copy_mapped(int _fd, const unsigned char *_buf, size_t _sz);
 void	*_libelf_ehdr(Elf *_e, int _elfclass, int _allocate);
 int	_libelf_elfmachine(Elf *_e);
 unsigned int _libelf_falign(Elf_Type _t, int _elfclass);
+int	_libelf_file_is_mapped(int _fd);
 size_t	_libelf_fsize(Elf_Type _t, int _elfclass, unsigned int _version,
     size_t count);
+_libelf_bswap_function *_libelf_get_bswap_kernel(void);
+Elf_Data *_libelf_get_data(Elf_Scn *_s, Elf_Data *_d, int _ctype);
 _libelf_translator_function *_libelf_get_translator(Elf_Type _t,
     int _direction, int _elfclass, int _elfmachine);
 void	*_libelf_getphdr(Elf *_e, int _elfclass);
+void	*_libelf_getrange(Elf_Data *_d, Elf_Type _t, size_t _first,
+    size_t _count, void *_dst, int *_elfclass);
 void	*_libelf_getshdr(Elf_Scn *_scn, int _elfclass);
+unsigned char *_libelf_inflate_scn(Elf_Scn *_s, int _ctype, uint64_t *_size,
+    uint64_t *_align);
 void	_libelf_init_elf(Elf *_e, Elf_Kind _kind);
+unsigned char *_libelf_rawbytes(Elf *_e, uint64_t _off, uint64_t _sz);
+Elf_Scn	*_libelf_load_scn(Elf *_e, size_t _ndx);
 int	_libelf_load_section_headers(Elf *e, void *ehdr);
+int	_libelf_load_sections(Elf *_e);
 unsigned int _libelf_malign(Elf_Type _t, int _elfclass);
 Elf	*_libelf_memory(unsigned char *_image, size_t _sz, int _reporterror);
 size_t	_libelf_msize(Elf_Type _t, int _elfclass, unsigned int _version);
 void	*_libelf_newphdr(Elf *_e, int _elfclass, size_t _count);
 Elf	*_libelf_open_object(int _fd, Elf_Cmd _c, int _reporterror);
+Elf	*_libelf_open_slice(int _fd, off_t _off, size_t _sz);
+void	_libelf_register_mapping(const unsigned char *_base, size_t _size,
+    int _fd, off_t _off);
 struct _Libelf_Data *_libelf_release_data(struct _Libelf_Data *_d);
 void	_libelf_release_elf(Elf *_e);
 Elf_Scn	*_libelf_release_scn(Elf_Scn *_s);
@@ -232,8 +337,12 @@ int	_libelf_setphnum(Elf *_e, void *_eh, int _elfclass, size_t _phnum);
 int	_libelf_setshnum(Elf *_e, void *_eh, int _elfclass, size_t _shnum);
 int	_libelf_setshstrndx(Elf *_e, void *_eh, int _elfclass,
     size_t _shstrndx);
+void	_libelf_unmap_rawfile(Elf *_e);
+void	_libelf_unregister_mapping(const unsigned char *_base);
 Elf_Data *_libelf_xlate(Elf_Data *_d, const Elf_Data *_s,
     unsigned int _encoding, int _elfclass, int _elfmachine, int _direction);
+int	_libelf_xlate_is_copy(Elf_Type _t, int _elfclass,
+    unsigned int _byteorder);
 int	_libelf_xlate_shtype(uint32_t _sht);
 #ifdef __cplusplus
 }
@@ -0,0 +1,176 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "_libelf.h"
+
+#if	ELFTC_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+ELFTC_VCSID("$Id$");
+
+#if	ELFTC_HAVE_MMAP
+/*
+ * Apply access advice `advice' to the byte range [off, off+sz) of the
+ * image of ELF descriptor `e'.  Images that were not mapped in from a
+ * file by the library are left alone.
+ */
+static int
+_libelf_advise_range(Elf *e, uint64_t off, uint64_t sz, int advice)
+{
+	Elf *root;
+	long pagesz;
+	int error;
+	uintptr_t end, start;
+
+	for (root = e; root->e_parent != NULL; root = root->e_parent)
+		;
+
+	if ((root->e_flags & LIBELF_F_RAWFILE_MMAP) == 0 || sz == 0)
+		return (0);
+
+	if ((pagesz = sysconf(_SC_PAGESIZE)) <= 0)
+		pagesz = 4096;
+
+	/* madvise(2) needs a page aligned start address. */
+	start = (uintptr_t) (e->e_rawfile + off);
+	end = start + (uintptr_t) sz;
+	start &= ~((uintptr_t) pagesz - 1);
+
+	switch (advice) {
+	case ELF_ADV_NORMAL:
+		advice = MADV_NORMAL;
+		break;
+	case ELF_ADV_RANDOM:
+		advice = MADV_RANDOM;
+		break;
+	case ELF_ADV_SEQUENTIAL:
+		advice = MADV_SEQUENTIAL;
+		break;
+	case ELF_ADV_WILLNEED:
+		advice = MADV_WILLNEED;
+		break;
+	case ELF_ADV_POPULATE:
+#if	defined(MADV_POPULATE_READ)
+		if (madvise((void *) start, end - start,
+		    MADV_POPULATE_READ) == 0)
+			return (0);
+		/* Fall back to asynchronous read-ahead on older kernels. */
+#endif
+		advice = MADV_WILLNEED;
+		break;
+	case ELF_ADV_HUGEPAGE:
+#if	defined(MADV_HUGEPAGE)
+		advice = MADV_HUGEPAGE;
+		break;
+#else
+		return (0);
+#endif
+	}
+
+	if (madvise((void *) start, end - start, advice) < 0) {
+		error = errno;
+		/* Advice that the system cannot act on is ignored. */
+		if (error == EINVAL || error == ENOSYS)
+			return (0);
+		LIBELF_SET_ERROR(IO, error);
+		return (-1);
+	}
+
+	return (0);
+}
+#else
+static int
+_libelf_advise_range(Elf *e, uint64_t off, uint64_t sz, int advice)
+{
+	(void) e;
+	(void) off;
+	(void) sz;
+	(void) advice;
+
+	return (0);
+}
+#endif	/* ELFTC_HAVE_MMAP */
+
+int
+elf_advise(Elf *e, int advice)
+{
+	if (e == NULL || advice < ELF_ADV_FIRST || advice > ELF_ADV_LAST) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	if (e->e_rawfile == NULL)
+		return (0);
+
+	return (_libelf_advise_range(e, 0, (uint64_t) e->e_rawsize, advice));
+}
+
+int
+elf_advisescn(Elf_Scn *s, int advice)
+{
+	Elf *e;
+	uint32_t sh_type;
+	uint64_t sh_size;
+
+	if (s == NULL || (e = s->s_elf) == NULL ||
+	    advice < ELF_ADV_FIRST || advice > ELF_ADV_LAST) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	if (e->e_rawfile == NULL)
+		return (0);
+
+	/* The section header may be updated concurrently. */
+	LIBELF_LOCK(e);
+	if (e->e_class == ELFCLASS32) {
+		sh_type = s->s_shdr.s_shdr32.sh_type;
+		sh_size = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+	} else {
+		sh_type = s->s_shdr.s_shdr64.sh_type;
+		sh_size = s->s_shdr.s_shdr64.sh_size;
+	}
+	LIBELF_UNLOCK(e);
+
+	if (sh_type == SHT_NULL || sh_type == SHT_NOBITS)
+		return (0);
+
+	if (s->s_rawoff > (uint64_t) e->e_rawsize ||
+	    sh_size > (uint64_t) e->e_rawsize - s->s_rawoff) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (-1);
+	}
+
+	return (_libelf_advise_range(e, s->s_rawoff, sh_size, advice));
+}
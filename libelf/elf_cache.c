@@ -0,0 +1,227 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <assert.h>
+#include <libelf.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * A process-wide cache of translated section data.
+ *
+ * Data descriptors that elf_getdata(3) allocates for ELF objects
+ * marked ELF_F_EVICTABLE are kept on a list in order of use.  They
+ * stay on the list if the flag is later cleared, but are only
+ * released while it is set.  When
+ * the memory they hold exceeds the limit set by elf_setcachelimit(3),
+ * the least recently used descriptors belonging to other evictable
+ * objects are released.  A released descriptor is re-created from the
+ * file image the next time its section's data is retrieved.
+ *
+ * The cache lock is acquired with an ELF descriptor's lock held, so
+ * the locks of other descriptors are only ever tried while the cache
+ * lock is held.  A descriptor that is busy is simply skipped.
+ */
+
+static TAILQ_HEAD(, _Libelf_Data) _libelf_cache =
+    TAILQ_HEAD_INITIALIZER(_libelf_cache);
+static pthread_mutex_t _libelf_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static Elf_Cachestat _libelf_cache_stat;
+
+/*
+ * Release cached data until the cache fits within its limit, leaving
+ * the data of ELF descriptor `e' alone.  The caller holds the cache
+ * lock.
+ */
+static void
+_libelf_cache_trim(Elf *e)
+{
+	Elf *ve;
+	Elf_Scn *s;
+	struct _Libelf_Data *d, *td;
+
+	TAILQ_FOREACH_SAFE(d, &_libelf_cache, d_lru, td) {
+		if (_libelf_cache_stat.cs_size <= _libelf_cache_stat.cs_limit)
+			break;
+
+		s = d->d_scn;
+		if ((ve = s->s_elf) == e ||
+		    pthread_mutex_trylock(&ve->e_lock) != 0)
+			continue;
+
+		/*
+		 * Only whole, unmodified sections of objects that are
+		 * still marked evictable may be released.
+		 */
+		if ((ve->e_flags & ELF_F_EVICTABLE) == 0 ||
+		    (s->s_flags & ELF_F_DIRTY) != 0 ||
+		    (d->d_flags & ELF_F_DIRTY) != 0 ||
+		    STAILQ_FIRST(&s->s_data) != d ||
+		    STAILQ_NEXT(d, d_next) != NULL) {
+			LIBELF_UNLOCK(ve);
+			continue;
+		}
+
+		TAILQ_REMOVE(&_libelf_cache, d, d_lru);
+		_libelf_cache_stat.cs_size -= (size_t) d->d_data.d_size;
+		_libelf_cache_stat.cs_evictions++;
+
+		STAILQ_REMOVE_HEAD(&s->s_data, d_next);
+		d->d_flags &= ~LIBELF_F_DATA_CACHED;
+		(void) _libelf_release_data(d);
+
+		LIBELF_UNLOCK(ve);
+	}
+}
+
+/*
+ * Add data descriptor `d' to the cache.  The caller holds the cache
+ * lock.
+ */
+static void
+_libelf_cache_insert(struct _Libelf_Data *d)
+{
+	assert((d->d_flags & LIBELF_F_DATA_MALLOCED) != 0);
+
+	d->d_flags |= LIBELF_F_DATA_CACHED;
+	TAILQ_INSERT_TAIL(&_libelf_cache, d, d_lru);
+	_libelf_cache_stat.cs_size += (size_t) d->d_data.d_size;
+}
+
+/*
+ * Add the data descriptor `d', just translated on a cache miss, to
+ * the cache.  The caller holds the lock for the descriptor's ELF
+ * object.
+ */
+void
+_libelf_cache_enter(struct _Libelf_Data *d)
+{
+	(void) pthread_mutex_lock(&_libelf_cache_lock);
+
+	_libelf_cache_insert(d);
+	_libelf_cache_stat.cs_misses++;
+
+	if (_libelf_cache_stat.cs_limit > 0)
+		_libelf_cache_trim(d->d_scn->s_elf);
+
+	(void) pthread_mutex_unlock(&_libelf_cache_lock);
+}
+
+/*
+ * Add the data already allocated for ELF descriptor `e' to the cache,
+ * when the descriptor is first marked evictable.  The caller holds the
+ * lock for `e'.
+ */
+void
+_libelf_cache_enter_elf(Elf *e)
+{
+	Elf_Scn *s;
+	struct _Libelf_Data *d;
+
+	(void) pthread_mutex_lock(&_libelf_cache_lock);
+
+	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next)
+		STAILQ_FOREACH(d, &s->s_data, d_next)
+			if ((d->d_flags & (LIBELF_F_DATA_MALLOCED |
+			    LIBELF_F_DATA_CACHED)) == LIBELF_F_DATA_MALLOCED)
+				_libelf_cache_insert(d);
+
+	if (_libelf_cache_stat.cs_limit > 0)
+		_libelf_cache_trim(e);
+
+	(void) pthread_mutex_unlock(&_libelf_cache_lock);
+}
+
+/*
+ * Note a retrieval of the cached data descriptor `d'.  The caller
+ * holds the lock for the descriptor's ELF object.
+ */
+void
+_libelf_cache_hit(struct _Libelf_Data *d)
+{
+	(void) pthread_mutex_lock(&_libelf_cache_lock);
+
+	TAILQ_REMOVE(&_libelf_cache, d, d_lru);
+	TAILQ_INSERT_TAIL(&_libelf_cache, d, d_lru);
+	_libelf_cache_stat.cs_hits++;
+
+	(void) pthread_mutex_unlock(&_libelf_cache_lock);
+}
+
+/*
+ * Remove the data descriptor `d' from the cache, prior to its being
+ * released.
+ */
+void
+_libelf_cache_remove(struct _Libelf_Data *d)
+{
+	(void) pthread_mutex_lock(&_libelf_cache_lock);
+
+	TAILQ_REMOVE(&_libelf_cache, d, d_lru);
+	_libelf_cache_stat.cs_size -= (size_t) d->d_data.d_size;
+	d->d_flags &= ~LIBELF_F_DATA_CACHED;
+
+	(void) pthread_mutex_unlock(&_libelf_cache_lock);
+}
+
+size_t
+elf_setcachelimit(size_t limit)
+{
+	size_t old;
+
+	(void) pthread_mutex_lock(&_libelf_cache_lock);
+
+	old = _libelf_cache_stat.cs_limit;
+	_libelf_cache_stat.cs_limit = limit;
+
+	if (limit > 0)
+		_libelf_cache_trim(NULL);
+
+	(void) pthread_mutex_unlock(&_libelf_cache_lock);
+
+	return (old);
+}
+
+int
+elf_getcachestat(Elf_Cachestat *cs)
+{
+	if (cs == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	(void) pthread_mutex_lock(&_libelf_cache_lock);
+	*cs = _libelf_cache_stat;
+	(void) pthread_mutex_unlock(&_libelf_cache_lock);
+
+	return (0);
+}
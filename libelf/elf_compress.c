@@ -0,0 +1,133 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <libelf.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Choose how the contents of a section are to be stored by
+ * elf_update().  Contents that are stored compressed in the file are
+ * inflated here, as elf_getdata() returns them as they appear in the
+ * file.
+ */
+int
+elf_compress(Elf_Scn *s, int type, unsigned int flags)
+{
+	Elf *e;
+	int ctype, rc;
+	uint64_t sh_flags;
+	struct _Libelf_Data *d, *td;
+	uint32_t sh_type;
+
+	if (s == NULL || (e = s->s_elf) == NULL || flags != 0U) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	if (type != 0 && type != ELFCOMPRESS_ZLIB) {
+		LIBELF_SET_ERROR(UNIMPL, 0);
+		return (-1);
+	}
+
+	rc = -1;
+
+	LIBELF_LOCK(e);
+
+	if (e->e_class == ELFCLASS32) {
+		sh_flags = (uint64_t) s->s_shdr.s_shdr32.sh_flags;
+		sh_type  = s->s_shdr.s_shdr32.sh_type;
+	} else {
+		sh_flags = s->s_shdr.s_shdr64.sh_flags;
+		sh_type  = s->s_shdr.s_shdr64.sh_type;
+	}
+
+	/*
+	 * Sections that occupy no space in the file have nothing to
+	 * compress, and sections that are part of the process image
+	 * may not be compressed.
+	 */
+	if (sh_type == SHT_NULL || sh_type == SHT_NOBITS ||
+	    (type != 0 && (sh_flags & SHF_ALLOC))) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		goto done;
+	}
+
+	/*
+	 * Bring in the current contents of the section, in their
+	 * uncompressed form, before the way they are stored changes.
+	 * Any data descriptors holding the compressed contents as read
+	 * from the file are replaced, unless they have been modified.
+	 */
+	ctype = LIBELF_COMPRESS_NONE;
+	if (e->e_rawfile != NULL && s->s_ctype == LIBELF_COMPRESS_NONE &&
+	    (s->s_flags & LIBELF_F_INFLATED) == 0)
+		ctype = _libelf_compression_type(s);
+
+	if (ctype != LIBELF_COMPRESS_NONE) {
+		STAILQ_FOREACH(d, &s->s_data, d_next)
+			if (d->d_flags & ELF_F_DIRTY) {
+				LIBELF_SET_ERROR(SEQUENCE, 0);
+				goto done;
+			}
+
+		STAILQ_FOREACH_SAFE(d, &s->s_data, d_next, td) {
+			STAILQ_REMOVE(&s->s_data, d, _Libelf_Data, d_next);
+			d = _libelf_release_data(d);
+		}
+
+		if (_libelf_get_data(s, NULL, ctype) == NULL)
+			goto done;
+
+		s->s_flags |= LIBELF_F_INFLATED;
+	} else if (e->e_rawfile != NULL && STAILQ_EMPTY(&s->s_data) &&
+	    _libelf_get_data(s, NULL, LIBELF_COMPRESS_NONE) == NULL)
+		goto done;
+
+	if (type == ELFCOMPRESS_ZLIB) {
+		s->s_ctype = LIBELF_COMPRESS_CHDR;
+		sh_flags |= SHF_COMPRESSED;
+	} else {
+		s->s_ctype = LIBELF_COMPRESS_NONE;
+		sh_flags &= ~(uint64_t) SHF_COMPRESSED;
+	}
+
+	if (e->e_class == ELFCLASS32)
+		s->s_shdr.s_shdr32.sh_flags = (uint32_t) sh_flags;
+	else
+		s->s_shdr.s_shdr64.sh_flags = sh_flags;
+
+	s->s_flags |= ELF_F_DIRTY;
+	rc = 0;
+
+done:
+	LIBELF_UNLOCK(e);
+	return (rc);
+}
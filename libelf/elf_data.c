@@ -29,20 +29,47 @@
 #include <libelf.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "_libelf.h"
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Return non-zero if the in-memory representation of section data
+ * of type `t' at offset `off' in the file image would be identical to
+ * its file representation.  For ELF objects marked ELF_F_READONLY,
+ * such data is returned without being copied.
+ */
+static int
+_libelf_data_is_shareable(Elf *e, Elf_Type t, uint64_t off)
+{
+	if ((e->e_flags & (ELF_F_READONLY | LIBELF_F_STREAM)) !=
+	    ELF_F_READONLY ||
+	    !_libelf_xlate_is_copy(t, e->e_class, e->e_byteorder))
+		return (0);
+
+	/* The file data needs to be suitably aligned for the host. */
+	return (((uintptr_t) (e->e_rawfile + off) %
+	    _libelf_malign(t, e->e_class)) == 0);
+}
+
+/*
+ * Retrieve translated data for a section.  Argument `ctype' describes
+ * how the section's contents are stored in the file; contents that
+ * are stored compressed are inflated.  The caller holds the lock for
+ * the section's ELF descriptor.
+ */
 Elf_Data *
-elf_getdata(Elf_Scn *s, Elf_Data *ed)
+_libelf_get_data(Elf_Scn *s, Elf_Data *ed, int ctype)
 {
 	Elf *e;
 	unsigned int sh_type;
 	int elfclass, elftype;
 	size_t count, fsz, msz;
 	struct _Libelf_Data *d;
-	uint64_t sh_align, sh_offset, sh_size, raw_size;
+	unsigned char *src, *zbuf;
+	uint64_t sh_align, sh_offset, sh_size;
 	_libelf_translator_function *xlate;
 
 	d = (struct _Libelf_Data *) ed;
@@ -55,8 +82,11 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 
 	assert(e->e_kind == ELF_K_ELF);
 
-	if (d == NULL && (d = STAILQ_FIRST(&s->s_data)) != NULL)
+	if (d == NULL && (d = STAILQ_FIRST(&s->s_data)) != NULL) {
+		if (d->d_flags & LIBELF_F_DATA_CACHED)
+			_libelf_cache_hit(d);
 		return (&d->d_data);
+	}
 
 	if (d != NULL)
 		return (STAILQ_NEXT(d, d_next) ?
@@ -92,36 +122,52 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 		return (NULL);
 	}
 
-	raw_size = (uint64_t) e->e_rawsize;
 	if ((elftype = _libelf_xlate_shtype(sh_type)) < ELF_T_FIRST ||
-	    elftype > ELF_T_LAST || (sh_type != SHT_NOBITS &&
-	    (sh_offset > raw_size || sh_size > raw_size - sh_offset))) {
+	    elftype > ELF_T_LAST) {
 		LIBELF_SET_ERROR(SECTION, 0);
 		return (NULL);
 	}
 
+	src = NULL;
+	if (sh_type != SHT_NOBITS &&
+	    (src = _libelf_rawbytes(e, sh_offset, sh_size)) == NULL)
+		return (NULL);
+
 	if ((fsz = (elfclass == ELFCLASS32 ? elf32_fsize : elf64_fsize)
             (elftype, (size_t) 1, e->e_version)) == 0) {
 		LIBELF_SET_ERROR(UNIMPL, 0);
 		return (NULL);
 	}
 
+	zbuf = NULL;
+	if (ctype != LIBELF_COMPRESS_NONE) {
+		if ((zbuf = _libelf_inflate_scn(s, ctype, &sh_size,
+		    &sh_align)) == NULL)
+			return (NULL);
+		src = zbuf;
+	}
+
 	if (sh_size % fsz) {
+		free(zbuf);
 		LIBELF_SET_ERROR(SECTION, 0);
 		return (NULL);
 	}
 
 	if (sh_size / fsz > SIZE_MAX) {
+		free(zbuf);
 		LIBELF_SET_ERROR(RANGE, 0);
 		return (NULL);
 	}
 
 	count = (size_t) (sh_size / fsz);
 
-	if ((msz = _libelf_msize(elftype, elfclass, e->e_version)) == 0)
+	if ((msz = _libelf_msize(elftype, elfclass, e->e_version)) == 0) {
+		free(zbuf);
 		return (NULL);
+	}
 
 	if (count > 0 && msz > SIZE_MAX / count) {
+		free(zbuf);
 		LIBELF_SET_ERROR(RANGE, 0);
 		return (NULL);
 	}
@@ -130,8 +176,10 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 	assert(count <= SIZE_MAX);
 	assert(msz * count <= SIZE_MAX);
 
-	if ((d = _libelf_allocate_data(s)) == NULL)
+	if ((d = _libelf_allocate_data(s)) == NULL) {
+		free(zbuf);
 		return (NULL);
+	}
 
 	d->d_data.d_buf     = NULL;
 	d->d_data.d_off     = 0;
@@ -141,33 +189,78 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 	d->d_data.d_version = e->e_version;
 
 	if (sh_type == SHT_NOBITS || sh_size == 0) {
+		free(zbuf);
 	        STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
 		return (&d->d_data);
         }
 
+	if (zbuf == NULL && _libelf_data_is_shareable(e, elftype, sh_offset)) {
+		d->d_data.d_buf = src;
+		STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+		return (&d->d_data);
+	}
+
+	d->d_flags  |= LIBELF_F_DATA_MALLOCED;
+
+	/* Inflated contents that need no translation are used as is. */
+	if (zbuf != NULL &&
+	    _libelf_xlate_is_copy(elftype, elfclass, e->e_byteorder)) {
+		d->d_data.d_buf = zbuf;
+		STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+		return (&d->d_data);
+	}
+
 	if ((d->d_data.d_buf = malloc(msz * count)) == NULL) {
+		free(zbuf);
 		(void) _libelf_release_data(d);
 		LIBELF_SET_ERROR(RESOURCE, 0);
 		return (NULL);
 	}
 
-	d->d_flags  |= LIBELF_F_DATA_MALLOCED;
-
 	xlate = _libelf_get_translator(elftype, ELF_TOMEMORY, elfclass,
 	    _libelf_elfmachine(e));
 	if (!(*xlate)(d->d_data.d_buf, (size_t) d->d_data.d_size,
-	    e->e_rawfile + sh_offset, count,
-	    e->e_byteorder != LIBELF_PRIVATE(byteorder))) {
+	    src, count, e->e_byteorder != LIBELF_PRIVATE(byteorder))) {
+		free(zbuf);
 		_libelf_release_data(d);
 		LIBELF_SET_ERROR(DATA, 0);
 		return (NULL);
 	}
 
+	free(zbuf);
+
 	STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
 
+	/*
+	 * Data allocated for evictable objects is tracked in the data
+	 * cache, which may release the data of other objects to make
+	 * room for it.  Inflated contents are not, as they would not
+	 * be inflated again when next retrieved.
+	 */
+	if ((e->e_flags & ELF_F_EVICTABLE) && ctype == LIBELF_COMPRESS_NONE)
+		_libelf_cache_enter(d);
+
 	return (&d->d_data);
 }
 
+Elf_Data *
+elf_getdata(Elf_Scn *s, Elf_Data *ed)
+{
+	Elf *e;
+	Elf_Data *d;
+
+	if (s == NULL || (e = s->s_elf) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	LIBELF_LOCK(e);
+	d = _libelf_get_data(s, ed, LIBELF_COMPRESS_NONE);
+	LIBELF_UNLOCK(e);
+
+	return (d);
+}
+
 Elf_Data *
 elf_newdata(Elf_Scn *s)
 {
@@ -181,16 +274,19 @@ elf_newdata(Elf_Scn *s)
 
 	assert(e->e_kind == ELF_K_ELF);
 
+	LIBELF_LOCK(e);
+
 	/*
 	 * elf_newdata() has to append a data descriptor, so
 	 * bring in existing section data if not already present.
 	 */
 	if (e->e_rawfile && s->s_size > 0 && STAILQ_EMPTY(&s->s_data))
-		if (elf_getdata(s, NULL) == NULL)
-			return (NULL);
+		if (_libelf_get_data(s, NULL,
+		    LIBELF_COMPRESS_NONE) == NULL)
+			goto error;
 
 	if ((d = _libelf_allocate_data(s)) == NULL)
-		return (NULL);
+		goto error;
 
 	STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
 
@@ -203,22 +299,29 @@ elf_newdata(Elf_Scn *s)
 
 	(void) elf_flagscn(s, ELF_C_SET, ELF_F_DIRTY);
 
+	LIBELF_UNLOCK(e);
+
 	return (&d->d_data);
+
+error:
+	LIBELF_UNLOCK(e);
+	return (NULL);
 }
 
 /*
  * Retrieve a data descriptor for raw (untranslated) data for section
- * `s'.
+ * `s'.  The caller holds the lock for the section's ELF descriptor.
  */
 
-Elf_Data *
-elf_rawdata(Elf_Scn *s, Elf_Data *ed)
+static Elf_Data *
+_libelf_get_rawdata(Elf_Scn *s, Elf_Data *ed)
 {
 	Elf *e;
 	int elf_class;
 	uint32_t sh_type;
 	struct _Libelf_Data *d;
-	uint64_t sh_align, sh_offset, sh_size, raw_size;
+	unsigned char *src;
+	uint64_t sh_align, sh_offset, sh_size;
 
 	if (s == NULL || (e = s->s_elf) == NULL || e->e_rawfile == NULL) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
@@ -239,14 +342,18 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 
 	assert(elf_class == ELFCLASS32 || elf_class == ELFCLASS64);
 
+	/*
+	 * Use the offset at which the section was read in, as
+	 * elf_update() may already have assigned it a new one.
+	 */
+	sh_offset = s->s_rawoff;
+
 	if (elf_class == ELFCLASS32) {
 		sh_type   = s->s_shdr.s_shdr32.sh_type;
-		sh_offset = (uint64_t) s->s_shdr.s_shdr32.sh_offset;
 		sh_size   = (uint64_t) s->s_shdr.s_shdr32.sh_size;
 		sh_align  = (uint64_t) s->s_shdr.s_shdr32.sh_addralign;
 	} else {
 		sh_type   = s->s_shdr.s_shdr64.sh_type;
-		sh_offset = s->s_shdr.s_shdr64.sh_offset;
 		sh_size   = s->s_shdr.s_shdr64.sh_size;
 		sh_align  = s->s_shdr.s_shdr64.sh_addralign;
 	}
@@ -256,18 +363,31 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 		return (NULL);
 	}
 
-	raw_size = (uint64_t) e->e_rawsize;
+	src = NULL;
 	if (sh_type != SHT_NOBITS &&
-	    (sh_offset > raw_size || sh_size > raw_size - sh_offset)) {
-		LIBELF_SET_ERROR(SECTION, 0);
+	    (src = _libelf_rawbytes(e, sh_offset, sh_size)) == NULL)
 		return (NULL);
-	}
 
 	if ((d = _libelf_allocate_data(s)) == NULL)
 		return (NULL);
 
 	d->d_data.d_buf = (sh_type == SHT_NOBITS || sh_size == 0) ? NULL :
-	    e->e_rawfile + sh_offset;
+	    src;
+
+	/*
+	 * The contents of streamed sections do not outlive the call
+	 * to the application's handler, so raw data needs a copy.
+	 */
+	if (d->d_data.d_buf != NULL && (e->e_flags & LIBELF_F_STREAM)) {
+		if ((d->d_data.d_buf = malloc((size_t) sh_size)) == NULL) {
+			(void) _libelf_release_data(d);
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			return (NULL);
+		}
+		(void) memcpy(d->d_data.d_buf, src, (size_t) sh_size);
+		d->d_flags |= LIBELF_F_DATA_MALLOCED;
+	}
+
 	d->d_data.d_off     = 0;
 	d->d_data.d_align   = sh_align;
 	d->d_data.d_size    = sh_size;
@@ -278,3 +398,21 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 
 	return (&d->d_data);
 }
+
+Elf_Data *
+elf_rawdata(Elf_Scn *s, Elf_Data *ed)
+{
+	Elf *e;
+	Elf_Data *d;
+
+	if (s == NULL || (e = s->s_elf) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	LIBELF_LOCK(e);
+	d = _libelf_get_rawdata(s, ed);
+	LIBELF_UNLOCK(e);
+
+	return (d);
+}
@@ -30,45 +30,65 @@
 
 #include "_libelf.h"
 
-#if	ELFTC_HAVE_MMAP
-#include <sys/mman.h>
-#endif
-
 ELFTC_VCSID("$Id$");
 
+/*
+ * Drop a reference to the archive 'ar' held by one of its members,
+ * and return non-zero if this was the last reference to it.  Members
+ * of an archive may be closed concurrently, so the counts are only
+ * examined with the archive's lock held.
+ */
+static int
+_libelf_ar_release_child(Elf *ar)
+{
+	int last;
+
+	LIBELF_LOCK(ar);
+	last = --ar->e_u.e_ar.e_nchildren == 0 && ar->e_activations == 0;
+	LIBELF_UNLOCK(ar);
+
+	return (last);
+}
+
 int
 elf_end(Elf *e)
 {
 	Elf *sv;
 	Elf_Scn *scn, *tscn;
+	int activations, deferred;
 
 	if (e == NULL || e->e_activations == 0)
 		return (0);
 
-	if (--e->e_activations > 0)
-		return (e->e_activations);
+	LIBELF_LOCK(e);
+	activations = --e->e_activations;
 
-	assert(e->e_activations == 0);
+	/*
+	 * If an archive still has open child descriptors, we need to
+	 * defer reclaiming resources till all the child descriptors
+	 * for the archive are closed.
+	 */
+	deferred = e->e_kind == ELF_K_AR && e->e_u.e_ar.e_nchildren > 0;
+	LIBELF_UNLOCK(e);
+
+	if (activations > 0)
+		return (activations);
+	if (deferred)
+		return (0);
 
-	while (e && e->e_activations == 0) {
+	while (e) {
 		switch (e->e_kind) {
-		case ELF_K_AR:
-			/*
-			 * If we still have open child descriptors, we
-			 * need to defer reclaiming resources till all
-			 * the child descriptors for the archive are
-			 * closed.
-			 */
-			if (e->e_u.e_ar.e_nchildren > 0)
-				return (0);
-			break;
 		case ELF_K_ELF:
 			/*
-			 * Reclaim all section descriptors.
+			 * Reclaim all section descriptors.  The lock keeps
+			 * the data cache from releasing section data at
+			 * the same time.
 			 */
+			LIBELF_LOCK(e);
 			STAILQ_FOREACH_SAFE(scn, &e->e_u.e_elf.e_scn, s_next,
 			    tscn)
  				scn = _libelf_release_scn(scn);
+			LIBELF_UNLOCK(e);
 			break;
 		case ELF_K_NUM:
 			assert(0);
@@ -80,14 +100,17 @@ elf_end(Elf *e)
 			if (e->e_flags & LIBELF_F_RAWFILE_MALLOC)
 				free(e->e_rawfile);
 #if	ELFTC_HAVE_MMAP
-			else if (e->e_flags & LIBELF_F_RAWFILE_MMAP)
-				(void) munmap(e->e_rawfile, (size_t) e->e_rawsize);
+			else if (e->e_flags & LIBELF_F_RAWFILE_MMAP) {
+				_libelf_unregister_mapping(e->e_rawfile);
+				_libelf_unmap_rawfile(e);
+			}
 #endif
 		}
 
 		sv = e;
-		if ((e = e->e_parent) != NULL)
-			e->e_u.e_ar.e_nchildren--;
+		if ((e = e->e_parent) != NULL &&
+		    _libelf_ar_release_child(e) == 0)
+			e = NULL;
 		_libelf_release_elf(sv);
 	}
 
@@ -117,7 +117,8 @@ elf_flagelf(Elf *e, Elf_Cmd c, unsigned int flags)
 	if ((c != ELF_C_SET && c != ELF_C_CLR) ||
 	    (e->e_kind != ELF_K_ELF) ||
 	    (flags & ~(ELF_F_ARCHIVE | ELF_F_ARCHIVE_SYSV |
-	    ELF_F_DIRTY | ELF_F_LAYOUT)) != 0) {
+	    ELF_F_DIRTY | ELF_F_EVICTABLE | ELF_F_LAYOUT |
+	    ELF_F_READONLY)) != 0) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 		return (0);
 	}
@@ -132,10 +133,34 @@ elf_flagelf(Elf *e, Elf_Cmd c, unsigned int flags)
 		return (0);
 	}
 
+	if ((flags & (ELF_F_EVICTABLE | ELF_F_READONLY)) &&
+	    c == ELF_C_SET && e->e_cmd != ELF_C_READ) {
+		LIBELF_SET_ERROR(MODE, 0);
+		return (0);
+	}
+
+	/* Data read from a stream cannot be read again once evicted. */
+	if ((flags & ELF_F_EVICTABLE) && c == ELF_C_SET &&
+	    (e->e_flags & LIBELF_F_STREAM) != 0) {
+		LIBELF_SET_ERROR(MODE, 0);
+		return (0);
+	}
+
+	/*
+	 * The data cache examines the ELF_F_EVICTABLE flag with the
+	 * descriptor locked.  Section data retrieved before the flag
+	 * was first set is added to the cache at that point.
+	 */
+	LIBELF_LOCK(e);
+	if ((flags & ELF_F_EVICTABLE) && c == ELF_C_SET &&
+	    (e->e_flags & ELF_F_EVICTABLE) == 0)
+		_libelf_cache_enter_elf(e);
 	if (c == ELF_C_SET)
 		r = e->e_flags |= flags;
 	else
 		r = e->e_flags &= ~flags;
+	LIBELF_UNLOCK(e);
+
 	return (r & LIBELF_F_API_MASK);
 }
 
@@ -25,11 +25,36 @@
  */
 
 #include <libelf.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "_libelf.h"
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Retrieve the translated archive symbol table, translating it on
+ * first use.  The caller must hold the descriptor's lock.
+ */
+static Elf_Arsym *
+_libelf_ar_get_symtab(Elf *ar, size_t *count)
+{
+	Elf_Arsym *symtab;
+
+	*count = 0;
+
+	if ((symtab = ar->e_u.e_ar.e_symtab) != NULL)
+		*count = ar->e_u.e_ar.e_symtabsz;
+	else if (ar->e_u.e_ar.e_rawsymtab)
+		symtab = (ar->e_flags & LIBELF_F_AR_VARIANT_SVR4) ?
+		    _libelf_ar_process_svr4_symtab(ar, count) :
+		    _libelf_ar_process_bsd_symtab(ar, count);
+	else
+		LIBELF_SET_ERROR(ARCHIVE, 0);
+
+	return (symtab);
+}
+
 Elf_Arsym *
 elf_getarsym(Elf *ar, size_t *ptr)
 {
@@ -39,18 +64,99 @@ elf_getarsym(Elf *ar, size_t *ptr)
 	n = 0;
 	symtab = NULL;
 
-	if (ar == NULL || ar->e_kind != ELF_K_AR)
+	if (ar == NULL || ar->e_kind != ELF_K_AR) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
-	else if ((symtab = ar->e_u.e_ar.e_symtab) != NULL)
-		n = ar->e_u.e_ar.e_symtabsz;
-	else if (ar->e_u.e_ar.e_rawsymtab)
-		symtab = (ar->e_flags & LIBELF_F_AR_VARIANT_SVR4) ?
-		    _libelf_ar_process_svr4_symtab(ar, &n) :
-		    _libelf_ar_process_bsd_symtab(ar, &n);
-	else
-		LIBELF_SET_ERROR(ARCHIVE, 0);
+		goto done;
+	}
+
+	LIBELF_LOCK(ar);
+	symtab = _libelf_ar_get_symtab(ar, &n);
+	LIBELF_UNLOCK(ar);
+
+done:
 
 	if (ptr)
 		*ptr = n;
 	return (symtab);
 }
+
+/*
+ * Build an open-addressed hash index over the archive symbol table.
+ *
+ * Slots hold one more than the index of an Elf_Arsym entry, with
+ * zero marking an empty slot.  Entries are keyed by their 'as_hash'
+ * values, which the library computes while translating the symbol
+ * table.  Only the first entry for a given name is indexed, so that
+ * lookups return the same member that a linear scan would find.
+ */
+static int
+_libelf_ar_index_symtab(Elf *ar, Elf_Arsym *symtab, size_t count)
+{
+	size_t h, i, j, mask, nslots, *slots;
+
+	/* Keep the table at most half full; 'count' includes the sentinel. */
+	for (nslots = 16; nslots < 2 * count; nslots <<= 1)
+		;
+
+	if ((slots = calloc(nslots, sizeof(*slots))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	mask = nslots - 1;
+	for (i = 0; i + 1 < count; i++) {
+		for (h = symtab[i].as_hash & mask; (j = slots[h]) != 0;
+		     h = (h + 1) & mask)
+			if (symtab[j - 1].as_hash == symtab[i].as_hash &&
+			    strcmp(symtab[j - 1].as_name,
+				symtab[i].as_name) == 0)
+				break;
+		if (j == 0)
+			slots[h] = i + 1;
+	}
+
+	ar->e_u.e_ar.e_symhash = slots;
+	ar->e_u.e_ar.e_symhashsz = nslots;
+
+	return (1);
+}
+
+Elf_Arsym *
+elf_arsym_lookup(Elf *ar, const char *name)
+{
+	size_t count, h, j, mask;
+	unsigned long hash;
+	Elf_Arsym *as, *symtab;
+
+	if (ar == NULL || ar->e_kind != ELF_K_AR || name == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	as = NULL;
+	hash = elf_hash(name);
+
+	LIBELF_LOCK(ar);
+
+	if ((symtab = _libelf_ar_get_symtab(ar, &count)) == NULL)
+		goto done;
+
+	if (ar->e_u.e_ar.e_symhash == NULL &&
+	    _libelf_ar_index_symtab(ar, symtab, count) == 0)
+		goto done;
+
+	mask = ar->e_u.e_ar.e_symhashsz - 1;
+	for (h = hash & mask; (j = ar->e_u.e_ar.e_symhash[h]) != 0;
+	     h = (h + 1) & mask) {
+		if (symtab[j - 1].as_hash == hash &&
+		    strcmp(symtab[j - 1].as_name, name) == 0) {
+			as = &symtab[j - 1];
+			break;
+		}
+	}
+
+done:
+	LIBELF_UNLOCK(ar);
+
+	return (as);
+}
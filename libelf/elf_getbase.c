@@ -39,8 +39,8 @@ elf_getbase(Elf *e)
 	}
 
 	if (e->e_parent == NULL)
-		return ((off_t) 0);
+		return (e->e_rawoff);
 
-	return ((off_t) ((uintptr_t) e->e_rawfile -
+	return (e->e_parent->e_rawoff + (off_t) ((uintptr_t) e->e_rawfile -
 	    (uintptr_t) e->e_parent->e_rawfile));
 }
@@ -52,3 +52,145 @@ elf_hash(const char *name)
 
 	return (h);
 }
+
+/*
+ * Hash a batch of strings from a string table.
+ *
+ * Each string is hashed using both the System V ABI function above
+ * and the GNU hash function (h = h * 33 + c, starting from 5381) in
+ * a single pass over its bytes.
+ *
+ * The per-byte recurrences of both hash functions are strictly
+ * serial, so hashing one string at a time leaves most of the
+ * execution units of a modern CPU idle.  We instead hash four
+ * strings ("lanes") in lock step, letting the CPU overlap their
+ * dependency chains.  A lane that reaches the end of its string is
+ * refilled with the next string from the batch, so that strings of
+ * differing lengths do not leave lanes idle.  The lanes are held in
+ * separate local variables so that the compiler can keep them in
+ * registers.
+ */
+
+#define	_LIBELF_HASH_STEP(S,G,C)	do {				\
+		uint32_t _t;						\
+		(S) = ((S) << 4) + (C);					\
+		_t = (S) & 0xF0000000U;					\
+		(S) = ((S) ^ (_t >> 24)) & ~_t;				\
+		(G) = (G) * 33 + (C);					\
+	} while (0)
+
+#define	_LIBELF_HASH_START(L)	do {					\
+		s##L = base + offsets[next];				\
+		n##L = next++;						\
+		sh##L = 0;						\
+		gh##L = 5381;						\
+	} while (0)
+
+#define	_LIBELF_HASH_STORE(L)	do {					\
+		if (sysvhash)						\
+			sysvhash[n##L] = sh##L;				\
+		if (gnuhash)						\
+			gnuhash[n##L] = gh##L;				\
+	} while (0)
+
+/*
+ * Finish the string in lane `L' one byte at a time.
+ */
+#define	_LIBELF_HASH_FINISH(L)	do {					\
+		while ((c##L = *s##L++) != 0)				\
+			_LIBELF_HASH_STEP(sh##L, gh##L, c##L);		\
+		_LIBELF_HASH_STORE(L);					\
+	} while (0)
+
+/*
+ * Retire lane `L' if it has reached the end of its string, and
+ * refill it, or stop if there are no more strings.
+ */
+#define	_LIBELF_HASH_REFILL(L)	do {					\
+		if (c##L == 0) {					\
+			_LIBELF_HASH_STORE(L);				\
+			if (next == count)				\
+				goto drain;				\
+			_LIBELF_HASH_START(L);				\
+		}							\
+	} while (0)
+
+int
+elf_hashstrings(const char *strtab, size_t strsz, const size_t *offsets,
+    size_t count, uint32_t *sysvhash, uint32_t *gnuhash)
+{
+	const unsigned char *base, *s0, *s1, *s2, *s3;
+	size_t i, next, n0, n1, n2, n3;
+	uint32_t c0, c1, c2, c3, sh0, sh1, sh2, sh3, gh0, gh1, gh2, gh3;
+
+	if (strtab == NULL || strsz == 0 || strtab[strsz - 1] != '\0' ||
+	    (offsets == NULL && count > 0) ||
+	    (sysvhash == NULL && gnuhash == NULL)) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (-1);
+	}
+
+	/*
+	 * Since the string table is NUL terminated, checking the
+	 * offsets up front ensures that every string lies within it.
+	 */
+	for (i = 0; i < count; i++)
+		if (offsets[i] >= strsz) {
+			LIBELF_SET_ERROR(ARGUMENT, 0);
+			return (-1);
+		}
+
+	base = (const unsigned char *) strtab;
+	next = 0;
+
+	/* Batches too small to fill all lanes are hashed serially. */
+	if (count < 4) {
+		while (next < count) {
+			_LIBELF_HASH_START(0);
+			_LIBELF_HASH_FINISH(0);
+		}
+		return (0);
+	}
+
+	_LIBELF_HASH_START(0);
+	_LIBELF_HASH_START(1);
+	_LIBELF_HASH_START(2);
+	_LIBELF_HASH_START(3);
+
+	for (;;) {
+		c0 = *s0;
+		c1 = *s1;
+		c2 = *s2;
+		c3 = *s3;
+
+		if (c0 != 0 && c1 != 0 && c2 != 0 && c3 != 0) {
+			_LIBELF_HASH_STEP(sh0, gh0, c0);
+			_LIBELF_HASH_STEP(sh1, gh1, c1);
+			_LIBELF_HASH_STEP(sh2, gh2, c2);
+			_LIBELF_HASH_STEP(sh3, gh3, c3);
+			s0++;
+			s1++;
+			s2++;
+			s3++;
+			continue;
+		}
+
+		_LIBELF_HASH_REFILL(0);
+		_LIBELF_HASH_REFILL(1);
+		_LIBELF_HASH_REFILL(2);
+		_LIBELF_HASH_REFILL(3);
+	}
+
+drain:
+	/*
+	 * Finish the strings still in flight.  A lane whose string has
+	 * already been stored points at its terminating NUL, so storing
+	 * it again is harmless.
+	 */
+	_LIBELF_HASH_FINISH(0);
+	_LIBELF_HASH_FINISH(1);
+	_LIBELF_HASH_FINISH(2);
+	_LIBELF_HASH_FINISH(3);
+
+	return (0);
+}
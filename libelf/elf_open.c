@@ -45,6 +45,21 @@ elf_open(int fd)
 	return (_libelf_open_object(fd, ELF_C_READ, 0));
 }
 
+/*
+ * Extension API: open an object embedded in a larger file for reading.
+ */
+
+Elf *
+elf_open_slice(int fd, off_t off, size_t sz)
+{
+	if (LIBELF_PRIVATE(version) == EV_NONE) {
+		LIBELF_SET_ERROR(SEQUENCE, 0);
+		return (NULL);
+	}
+
+	return (_libelf_open_slice(fd, off, sz));
+}
+
 /*
  * Extension API: create an ELF descriptor for an in-memory object,
  * ignoring parse errors.
@@ -31,8 +31,12 @@
 
 ELFTC_VCSID("$Id$");
 
-off_t
-elf_rand(Elf *ar, off_t offset)
+/*
+ * Check that 'offset' denotes the start of an archive member header
+ * in archive 'ar'.
+ */
+static int
+_libelf_ar_check_offset(Elf *ar, off_t offset)
 {
 	struct ar_hdr *arh;
 	off_t offset_of_member;
@@ -41,7 +45,7 @@ elf_rand(Elf *ar, off_t offset)
 	    (offset & 1) || offset < SARMAG ||
 	    offset >= ar->e_rawsize) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return 0;
+		return (0);
 	}
 
 	offset_of_member = offset + (off_t) sizeof(struct ar_hdr);
@@ -49,7 +53,7 @@ elf_rand(Elf *ar, off_t offset)
 	if (offset_of_member <= 0 || /* Numeric overflow. */
 	    offset_of_member >= ar->e_rawsize) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return 0;
+		return (0);
 	}
 
 	arh = (struct ar_hdr *) (ar->e_rawfile + offset);
@@ -57,10 +61,28 @@ elf_rand(Elf *ar, off_t offset)
 	/* a too simple sanity check */
 	if (arh->ar_fmag[0] != '`' || arh->ar_fmag[1] != '\n') {
 		LIBELF_SET_ERROR(ARCHIVE, 0);
-		return 0;
+		return (0);
 	}
 
+	return (1);
+}
+
+off_t
+elf_rand(Elf *ar, off_t offset)
+{
+	if (_libelf_ar_check_offset(ar, offset) == 0)
+		return (0);
+
 	ar->e_u.e_ar.e_next = offset;
 
 	return (offset);
 }
+
+Elf *
+elf_ar_member_at(Elf *ar, off_t offset)
+{
+	if (_libelf_ar_check_offset(ar, offset) == 0)
+		return (NULL);
+
+	return (_libelf_ar_open_member(ar->e_fd, ar->e_cmd, ar, offset));
+}
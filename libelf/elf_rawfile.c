@@ -41,6 +41,11 @@ elf_rawfile(Elf *e, size_t *sz)
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 	else if ((ptr = e->e_rawfile) == NULL && e->e_cmd == ELF_C_WRITE)
 		LIBELF_SET_ERROR(SEQUENCE, 0);
+	else if (e->e_flags & LIBELF_F_STREAM) {
+		/* The file image of a stream is not kept. */
+		ptr = NULL;
+		LIBELF_SET_ERROR(SEQUENCE, 0);
+	}
 
 	if (sz)
 		*sz = e ? (size_t) e->e_rawsize : 0;
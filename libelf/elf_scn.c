@@ -39,19 +39,17 @@
 ELFTC_VCSID("$Id$");
 
 /*
- * Load an ELF section table and create a list of Elf_Scn structures.
+ * Check the bounds of an ELF section table.  Section descriptors are
+ * created later, as individual sections are asked for.
  */
 int
 _libelf_load_section_headers(Elf *e, void *ehdr)
 {
-	Elf_Scn *scn;
 	uint64_t shoff;
 	Elf32_Ehdr *eh32;
 	Elf64_Ehdr *eh64;
-	int ec, swapbytes;
-	unsigned char *src;
-	size_t fsz, i, shnum;
-	_libelf_translator_function *xlator;
+	int ec;
+	size_t fsz, shnum;
 
 	assert(e != NULL);
 	assert(ehdr != NULL);
@@ -84,45 +82,68 @@ _libelf_load_section_headers(Elf *e, void *ehdr)
 		CHECK_EHDR(e, eh64);
 	}
 
-	xlator = _libelf_get_translator(ELF_T_SHDR, ELF_TOMEMORY, ec,
-	    _libelf_elfmachine(e));
+	e->e_u.e_elf.e_shoff = shoff;
+	e->e_flags |= LIBELF_F_SHDRS_LOADED;
 
-	swapbytes = e->e_byteorder != LIBELF_PRIVATE(byteorder);
-	src = e->e_rawfile + shoff;
+	return (1);
+}
 
-	/*
-	 * If the file is using extended numbering then section #0
-	 * would have already been read in.
-	 */
+/*
+ * Create the descriptor for section `ndx' from its section header
+ * in the file.
+ */
+Elf_Scn *
+_libelf_load_scn(Elf *e, size_t ndx)
+{
+	int ec;
+	size_t fsz;
+	Elf_Scn *scn;
+	_libelf_translator_function *xlator;
 
-	i = 0;
-	if (!STAILQ_EMPTY(&e->e_u.e_elf.e_scn)) {
-		assert(STAILQ_FIRST(&e->e_u.e_elf.e_scn) ==
-		    STAILQ_LAST(&e->e_u.e_elf.e_scn, _Elf_Scn, s_next));
+	assert(e->e_flags & LIBELF_F_SHDRS_LOADED);
+	assert(ndx < e->e_u.e_elf.e_nscn);
 
-		i = 1;
-		src += fsz;
-	}
+	ec = e->e_class;
+	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
 
-	for (; i < shnum; i++, src += fsz) {
-		if ((scn = _libelf_allocate_scn(e, i)) == NULL)
-			return (0);
+	if ((scn = _libelf_allocate_scn(e, ndx)) == NULL)
+		return (NULL);
 
-		(*xlator)((unsigned char *) &scn->s_shdr, sizeof(scn->s_shdr),
-		    src, (size_t) 1, swapbytes);
-
-		if (ec == ELFCLASS32) {
-			scn->s_offset = scn->s_rawoff =
-			    scn->s_shdr.s_shdr32.sh_offset;
-			scn->s_size = scn->s_shdr.s_shdr32.sh_size;
-		} else {
-			scn->s_offset = scn->s_rawoff =
-			    scn->s_shdr.s_shdr64.sh_offset;
-			scn->s_size = scn->s_shdr.s_shdr64.sh_size;
-		}
+	xlator = _libelf_get_translator(ELF_T_SHDR, ELF_TOMEMORY, ec,
+	    _libelf_elfmachine(e));
+	(*xlator)((unsigned char *) &scn->s_shdr, sizeof(scn->s_shdr),
+	    e->e_rawfile + e->e_u.e_elf.e_shoff + ndx * fsz, (size_t) 1,
+	    e->e_byteorder != LIBELF_PRIVATE(byteorder));
+
+	if (ec == ELFCLASS32) {
+		scn->s_offset = scn->s_rawoff =
+		    scn->s_shdr.s_shdr32.sh_offset;
+		scn->s_size = scn->s_shdr.s_shdr32.sh_size;
+	} else {
+		scn->s_offset = scn->s_rawoff =
+		    scn->s_shdr.s_shdr64.sh_offset;
+		scn->s_size = scn->s_shdr.s_shdr64.sh_size;
 	}
 
-	e->e_flags |= LIBELF_F_SHDRS_LOADED;
+	return (scn);
+}
+
+/*
+ * Create descriptors for all sections of an object that are yet to
+ * be read in.
+ */
+int
+_libelf_load_sections(Elf *e)
+{
+	size_t i;
+
+	assert(e->e_flags & LIBELF_F_SHDRS_LOADED);
+
+	for (i = 0; i < e->e_u.e_elf.e_nscn; i++)
+		if ((i >= e->e_u.e_elf.e_scntabsz ||
+		    e->e_u.e_elf.e_scntab[i] == NULL) &&
+		    _libelf_load_scn(e, i) == NULL)
+			return (0);
 
 	return (1);
 }
@@ -144,17 +165,31 @@ elf_getscn(Elf *e, size_t index)
 	if ((ehdr = _libelf_ehdr(e, ec, 0)) == NULL)
 		return (NULL);
 
+	LIBELF_LOCK(e);
+
+	s = NULL;
 	if (e->e_cmd != ELF_C_WRITE &&
 	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
 	    _libelf_load_section_headers(e, ehdr) == 0)
-		return (NULL);
+		goto done;
+
+	if (index < e->e_u.e_elf.e_scntabsz)
+		s = e->e_u.e_elf.e_scntab[index];
 
-	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next)
-		if (s->s_ndx == index)
-			return (s);
+	/* Read in sections from the file on first use. */
+	if (s == NULL) {
+		if (e->e_cmd != ELF_C_WRITE && index < e->e_u.e_elf.e_nscn)
+			s = _libelf_load_scn(e, index);
+		else
+			LIBELF_SET_ERROR(ARGUMENT, 0);
+	}
 
-	LIBELF_SET_ERROR(ARGUMENT, 0);
-	return (NULL);
+done:
+	LIBELF_UNLOCK(e);
+
+	assert(s == NULL || s->s_ndx == index);
+
+	return (s);
 }
 
 size_t
@@ -197,27 +232,40 @@ elf_newscn(Elf *e)
 	 * file using ELF_C_READ, mess with its internal structure and
 	 * use elf_update(...,ELF_C_NULL) to compute its new layout.
 	 */
+	LIBELF_LOCK(e);
 	if (e->e_cmd != ELF_C_WRITE &&
 	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
-	    _libelf_load_section_headers(e, ehdr) == 0)
+	    _libelf_load_section_headers(e, ehdr) == 0) {
+		LIBELF_UNLOCK(e);
 		return (NULL);
+	}
 
-	if (STAILQ_EMPTY(&e->e_u.e_elf.e_scn)) {
-		assert(e->e_u.e_elf.e_nscn == 0);
+	/*
+	 * The lock is held until the new descriptor has been entered
+	 * into the section table, as allocating it uses the arena
+	 * belonging to the descriptor.
+	 */
+	if (e->e_u.e_elf.e_nscn == 0) {
+		assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
 		if ((scn = _libelf_allocate_scn(e, (size_t) SHN_UNDEF)) ==
-		    NULL)
+		    NULL) {
+			LIBELF_UNLOCK(e);
 			return (NULL);
+		}
 		e->e_u.e_elf.e_nscn++;
 	}
 
 	assert(e->e_u.e_elf.e_nscn > 0);
 
-	if ((scn = _libelf_allocate_scn(e, e->e_u.e_elf.e_nscn)) == NULL)
+	if ((scn = _libelf_allocate_scn(e, e->e_u.e_elf.e_nscn)) == NULL) {
+		LIBELF_UNLOCK(e);
 		return (NULL);
+	}
 
 	e->e_u.e_elf.e_nscn++;
 
 	(void) elf_flagscn(scn, ELF_C_SET, ELF_F_DIRTY);
+	LIBELF_UNLOCK(e);
 
 	return (scn);
 }
@@ -231,6 +279,9 @@ elf_nextscn(Elf *e, Elf_Scn *s)
 		return (NULL);
 	}
 
-	return (s == NULL ? elf_getscn(e, (size_t) 1) :
-	    STAILQ_NEXT(s, s_next));
+	if (s == NULL)
+		return (elf_getscn(e, (size_t) 1));
+
+	return (s->s_ndx + 1 < e->e_u.e_elf.e_nscn ?
+	    elf_getscn(e, s->s_ndx + 1) : NULL);
 }
@@ -0,0 +1,652 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Read an ELF object from a descriptor that need not be seekable,
+ * handing its sections to the application in the order in which
+ * their contents appear in the file.
+ *
+ * The bytes preceding the end of the program and section header
+ * tables are saved in a "spool", so that the contents of sections
+ * placed before these tables may be retrieved once the tables have
+ * been read.  The spool is kept in memory while it is small, and is
+ * moved to a temporary file otherwise.  The contents of other
+ * sections are read into a single window buffer that is reused from
+ * section to section.
+ */
+
+#define	LIBELF_STREAM_CHUNK	(64*1024)	/* spool and skip read size */
+#define	LIBELF_STREAM_SPOOLMAX	(1024*1024)	/* in-memory spool limit */
+
+struct _Libelf_Stream {
+	int		st_fd;		/* descriptor being read */
+	uint64_t	st_pos;		/* bytes read from st_fd */
+	uint64_t	st_spooled;	/* bytes held by the spool */
+	unsigned char	*st_spool;	/* in-memory spool */
+	size_t		st_spoolsz;	/* allocated size of st_spool */
+	FILE		*st_spoolfile;	/* spool, once moved to a file */
+	unsigned char	*st_buf;	/* window and I/O buffer */
+	size_t		st_bufsz;	/* allocated size of st_buf */
+};
+
+/*
+ * Read exactly `sz' bytes from the stream.  Returns 1 on success, 0
+ * if the stream ended early and -1 on an I/O error.
+ */
+static int
+_libelf_stream_read(struct _Libelf_Stream *st, unsigned char *buf, size_t sz)
+{
+	ssize_t n;
+
+	while (sz > 0) {
+		if ((n = read(st->st_fd, buf, sz)) < 0) {
+			if (errno == EINTR)
+				continue;
+			LIBELF_SET_ERROR(IO, errno);
+			return (-1);
+		}
+		if (n == 0)
+			return (0);
+		st->st_pos += (uint64_t) n;
+		buf += n;
+		sz -= (size_t) n;
+	}
+
+	return (1);
+}
+
+/*
+ * Ensure that the window buffer can hold `sz' bytes.
+ */
+static int
+_libelf_stream_reserve(struct _Libelf_Stream *st, size_t sz)
+{
+	unsigned char *b;
+
+	if (sz <= st->st_bufsz)
+		return (1);
+
+	if ((b = realloc(st->st_buf, sz)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	st->st_buf = b;
+	st->st_bufsz = sz;
+
+	return (1);
+}
+
+/*
+ * Move the in-memory spool to a temporary file.
+ */
+static int
+_libelf_stream_spill(struct _Libelf_Stream *st)
+{
+	assert(st->st_spoolfile == NULL);
+
+	if ((st->st_spoolfile = tmpfile()) == NULL) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+
+	if (st->st_spooled > 0 && fwrite(st->st_spool, 1,
+	    (size_t) st->st_spooled, st->st_spoolfile) != st->st_spooled) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+
+	free(st->st_spool);
+	st->st_spool = NULL;
+	st->st_spoolsz = 0;
+
+	return (1);
+}
+
+/*
+ * Read the stream up to offset `end', appending the bytes read to
+ * the spool.  A stream that ends early is reported as a header error,
+ * or as not being an ELF object if it ends within the identification
+ * bytes.
+ */
+static int
+_libelf_stream_spool(struct _Libelf_Stream *st, uint64_t end)
+{
+	int rc;
+	size_t n, sz;
+	unsigned char *b;
+
+	assert(st->st_pos == st->st_spooled);
+
+	if (end <= st->st_spooled)
+		return (1);
+
+	if (st->st_spoolfile == NULL && end > LIBELF_STREAM_SPOOLMAX &&
+	    _libelf_stream_spill(st) == 0)
+		return (0);
+
+	if (st->st_spoolfile == NULL) {
+		if (end > st->st_spoolsz) {
+			for (sz = LIBELF_STREAM_CHUNK; sz < end; sz *= 2)
+				;
+			if ((b = realloc(st->st_spool, sz)) == NULL) {
+				LIBELF_SET_ERROR(RESOURCE, 0);
+				return (0);
+			}
+			st->st_spool = b;
+			st->st_spoolsz = sz;
+		}
+
+		n = (size_t) (end - st->st_spooled);
+		if ((rc = _libelf_stream_read(st, st->st_spool +
+		    st->st_spooled, n)) <= 0)
+			goto error;
+		st->st_spooled = end;
+
+		return (1);
+	}
+
+	if (_libelf_stream_reserve(st, LIBELF_STREAM_CHUNK) == 0)
+		return (0);
+
+	if (fseeko(st->st_spoolfile, (off_t) 0, SEEK_END) < 0) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+
+	while (st->st_spooled < end) {
+		n = LIBELF_STREAM_CHUNK;
+		if (end - st->st_spooled < n)
+			n = (size_t) (end - st->st_spooled);
+		if ((rc = _libelf_stream_read(st, st->st_buf, n)) <= 0)
+			goto error;
+		if (fwrite(st->st_buf, 1, n, st->st_spoolfile) != n) {
+			LIBELF_SET_ERROR(IO, errno);
+			return (0);
+		}
+		st->st_spooled += n;
+	}
+
+	return (1);
+
+error:
+	if (rc == 0 && st->st_pos < EI_NIDENT)
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+	else if (rc == 0)
+		LIBELF_SET_ERROR(HEADER, 0);
+	return (0);
+}
+
+/*
+ * Copy `sz' spooled bytes at offset `off' to `dst'.
+ */
+static int
+_libelf_stream_unspool(struct _Libelf_Stream *st, unsigned char *dst,
+    uint64_t off, size_t sz)
+{
+	assert(off + sz <= st->st_spooled);
+
+	if (st->st_spoolfile == NULL) {
+		(void) memcpy(dst, st->st_spool + off, sz);
+		return (1);
+	}
+
+	if (fseeko(st->st_spoolfile, (off_t) off, SEEK_SET) < 0 ||
+	    fread(dst, 1, sz, st->st_spoolfile) != sz) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+
+	return (1);
+}
+
+/*
+ * Fill the window buffer with the `sz' bytes at offset `off' in the
+ * file, skipping forward in the stream as needed.
+ */
+static int
+_libelf_stream_window(struct _Libelf_Stream *st, uint64_t off, uint64_t sz)
+{
+	int rc;
+	size_t n;
+	unsigned char *p;
+
+	if (sz > SIZE_MAX) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	if (_libelf_stream_reserve(st, sz > LIBELF_STREAM_CHUNK ?
+	    (size_t) sz : LIBELF_STREAM_CHUNK) == 0)
+		return (0);
+
+	p = st->st_buf;
+
+	if (off < st->st_spooled) {
+		n = (size_t) sz;
+		if (st->st_spooled - off < n)
+			n = (size_t) (st->st_spooled - off);
+		if (_libelf_stream_unspool(st, p, off, n) == 0)
+			return (0);
+		p += n;
+		off += n;
+		sz -= n;
+	}
+
+	if (sz == 0)
+		return (1);
+
+	/* Bytes read past without being spooled cannot be recovered. */
+	if (off < st->st_pos) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (0);
+	}
+
+	/*
+	 * Discard the bytes preceding the section, a chunk at a time.
+	 * Nothing has been copied into the window yet: spooled bytes
+	 * end at or before the current stream position.
+	 */
+	while (st->st_pos < off) {
+		n = LIBELF_STREAM_CHUNK;
+		if (off - st->st_pos < n)
+			n = (size_t) (off - st->st_pos);
+		if ((rc = _libelf_stream_read(st, st->st_buf, n)) <= 0)
+			goto error;
+	}
+
+	if ((rc = _libelf_stream_read(st, p, (size_t) sz)) > 0)
+		return (1);
+
+error:
+	if (rc == 0)
+		LIBELF_SET_ERROR(SECTION, 0);
+	return (0);
+}
+
+static int
+_libelf_stream_cmp(const void *a, const void *b)
+{
+	const Elf_Scn *sa, *sb;
+
+	sa = *(Elf_Scn * const *) a;
+	sb = *(Elf_Scn * const *) b;
+
+	if (sa->s_offset != sb->s_offset)
+		return (sa->s_offset < sb->s_offset ? -1 : 1);
+	return (sa->s_ndx < sb->s_ndx ? -1 : sa->s_ndx > sb->s_ndx);
+}
+
+/*
+ * Release the data descriptors of a section whose contents were not
+ * retained by the application.
+ */
+static void
+_libelf_stream_release_scn(Elf_Scn *s)
+{
+	struct _Libelf_Data *d, *td;
+
+	STAILQ_FOREACH_SAFE(d, &s->s_data, d_next, td) {
+		STAILQ_REMOVE(&s->s_data, d, _Libelf_Data, d_next);
+		(void) _libelf_release_data(d);
+	}
+
+	STAILQ_FOREACH_SAFE(d, &s->s_rawdata, d_next, td) {
+		STAILQ_REMOVE(&s->s_rawdata, d, _Libelf_Data, d_next);
+		(void) _libelf_release_data(d);
+	}
+}
+
+/*
+ * Read the ELF header and the program and section header tables,
+ * and build an ELF descriptor for an image holding just these.
+ */
+static Elf *
+_libelf_stream_headers(struct _Libelf_Stream *st)
+{
+	Elf *e;
+	int ec, swap;
+	void *ehdr;
+	unsigned char *image, *p;
+	uint16_t phnum, shnum;
+	uint64_t end, phend, phoff, shend, shoff;
+	size_t ehsz, imagesz, nphdr, nscn, phsz, shsz;
+	_libelf_translator_function *xlator;
+	union {
+		Elf32_Ehdr	eh32;
+		Elf64_Ehdr	eh64;
+	} eh;
+	union {
+		Elf32_Shdr	sh32;
+		Elf64_Shdr	sh64;
+	} sh0;
+
+	if (_libelf_stream_spool(st, (uint64_t) EI_NIDENT) == 0)
+		return (NULL);
+
+	/* The spool is in memory at this point. */
+	p = st->st_spool;
+	if (p[EI_MAG0] != ELFMAG0 || p[EI_MAG1] != ELFMAG1 ||
+	    p[EI_MAG2] != ELFMAG2 || p[EI_MAG3] != ELFMAG3) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if (p[EI_VERSION] != EV_CURRENT) {
+		LIBELF_SET_ERROR(VERSION, 0);
+		return (NULL);
+	}
+
+	ec = p[EI_CLASS];
+	if ((ec != ELFCLASS32 && ec != ELFCLASS64) ||
+	    (p[EI_DATA] != ELFDATA2LSB && p[EI_DATA] != ELFDATA2MSB)) {
+		LIBELF_SET_ERROR(HEADER, 0);
+		return (NULL);
+	}
+	swap = p[EI_DATA] != LIBELF_PRIVATE(byteorder);
+
+	ehsz = _libelf_fsize(ELF_T_EHDR, ec, EV_CURRENT, (size_t) 1);
+	phsz = _libelf_fsize(ELF_T_PHDR, ec, EV_CURRENT, (size_t) 1);
+	shsz = _libelf_fsize(ELF_T_SHDR, ec, EV_CURRENT, (size_t) 1);
+
+	if (_libelf_stream_spool(st, (uint64_t) ehsz) == 0)
+		return (NULL);
+
+	xlator = _libelf_get_translator(ELF_T_EHDR, ELF_TOMEMORY, ec, EM_NONE);
+	(*xlator)((unsigned char *) &eh, sizeof(eh), st->st_spool, (size_t) 1,
+	    swap);
+
+	if (ec == ELFCLASS32) {
+		phoff = eh.eh32.e_phoff;
+		shoff = eh.eh32.e_shoff;
+		phnum = eh.eh32.e_phnum;
+		shnum = eh.eh32.e_shnum;
+	} else {
+		phoff = eh.eh64.e_phoff;
+		shoff = eh.eh64.e_shoff;
+		phnum = eh.eh64.e_phnum;
+		shnum = eh.eh64.e_shnum;
+	}
+
+	nphdr = phnum;
+	nscn = shoff == 0 ? 0 : shnum;
+
+	/* Look up extended counts in section header #0. */
+	if (shoff != 0 && (shnum == 0 || phnum == PN_XNUM)) {
+		if (shoff > UINT64_MAX - shsz) {
+			LIBELF_SET_ERROR(HEADER, 0);
+			return (NULL);
+		}
+		if (_libelf_stream_spool(st, shoff + shsz) == 0 ||
+		    _libelf_stream_reserve(st, shsz) == 0 ||
+		    _libelf_stream_unspool(st, st->st_buf, shoff,
+			shsz) == 0)
+			return (NULL);
+		xlator = _libelf_get_translator(ELF_T_SHDR, ELF_TOMEMORY, ec,
+		    EM_NONE);
+		(*xlator)((unsigned char *) &sh0, sizeof(sh0), st->st_buf,
+		    (size_t) 1, swap);
+		if (shnum == 0)
+			nscn = (size_t) (ec == ELFCLASS32 ? sh0.sh32.sh_size :
+			    sh0.sh64.sh_size);
+		if (phnum == PN_XNUM)
+			nphdr = ec == ELFCLASS32 ? sh0.sh32.sh_info :
+			    sh0.sh64.sh_info;
+	}
+
+	if (nphdr > (SIZE_MAX - ehsz) / phsz ||
+	    nscn > (SIZE_MAX - ehsz - nphdr * phsz) / shsz ||
+	    phoff > UINT64_MAX - nphdr * phsz ||
+	    shoff > UINT64_MAX - nscn * shsz) {
+		LIBELF_SET_ERROR(HEADER, 0);
+		return (NULL);
+	}
+
+	phend = nphdr > 0 ? phoff + nphdr * phsz : 0;
+	shend = nscn > 0 ? shoff + nscn * shsz : 0;
+	end = phend > shend ? phend : shend;
+
+	if (_libelf_stream_spool(st, end) == 0)
+		return (NULL);
+
+	/* Lay out the header image as [ehdr][phdrs][shdrs]. */
+	imagesz = ehsz + nphdr * phsz + nscn * shsz;
+	if ((image = malloc(imagesz)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	if (_libelf_stream_unspool(st, image + ehsz, phoff,
+	    nphdr * phsz) == 0 ||
+	    _libelf_stream_unspool(st, image + ehsz + nphdr * phsz, shoff,
+	    nscn * shsz) == 0) {
+		free(image);
+		return (NULL);
+	}
+
+	if (ec == ELFCLASS32) {
+		eh.eh32.e_phoff = nphdr > 0 ? (Elf32_Off) ehsz : 0;
+		eh.eh32.e_shoff = nscn > 0 ? (Elf32_Off) (ehsz +
+		    nphdr * phsz) : 0;
+	} else {
+		eh.eh64.e_phoff = nphdr > 0 ? (Elf64_Off) ehsz : 0;
+		eh.eh64.e_shoff = nscn > 0 ? (Elf64_Off) (ehsz +
+		    nphdr * phsz) : 0;
+	}
+
+	xlator = _libelf_get_translator(ELF_T_EHDR, ELF_TOFILE, ec, EM_NONE);
+	(*xlator)(image, ehsz, (unsigned char *) &eh, (size_t) 1, swap);
+
+	if ((e = _libelf_memory(image, imagesz, 1)) == NULL) {
+		free(image);
+		return (NULL);
+	}
+
+	e->e_flags |= LIBELF_F_RAWFILE_MALLOC | LIBELF_F_STREAM;
+
+	/*
+	 * Translate all headers while the image is laid out as above,
+	 * then restore the offsets found in the file.
+	 */
+	if ((ehdr = _libelf_ehdr(e, ec, 0)) == NULL ||
+	    (e->e_u.e_elf.e_nphdr > 0 && _libelf_getphdr(e, ec) == NULL))
+		goto error;
+
+	if (nscn > 0) {
+		LIBELF_LOCK(e);
+		if (_libelf_load_section_headers(e, ehdr) == 0 ||
+		    _libelf_load_sections(e) == 0) {
+			LIBELF_UNLOCK(e);
+			goto error;
+		}
+		e->e_u.e_elf.e_shoff = shoff;
+		LIBELF_UNLOCK(e);
+	}
+
+	if (ec == ELFCLASS32) {
+		((Elf32_Ehdr *) ehdr)->e_phoff = (Elf32_Off) phoff;
+		((Elf32_Ehdr *) ehdr)->e_shoff = (Elf32_Off) shoff;
+	} else {
+		((Elf64_Ehdr *) ehdr)->e_phoff = phoff;
+		((Elf64_Ehdr *) ehdr)->e_shoff = shoff;
+	}
+
+	return (e);
+
+error:
+	(void) elf_end(e);
+	return (NULL);
+}
+
+/*
+ * Make the window hold the contents of section `s' and translate
+ * them, for sections that are kept regardless of the application.
+ */
+static int
+_libelf_stream_preload(struct _Libelf_Stream *st, Elf *e, Elf_Scn *s)
+{
+	Elf_Data *d;
+
+	if (_libelf_stream_window(st, s->s_offset, s->s_size) == 0)
+		return (0);
+
+	e->e_u.e_elf.e_window = st->st_buf;
+	e->e_u.e_elf.e_windowoff = s->s_offset;
+	e->e_u.e_elf.e_windowsz = (size_t) s->s_size;
+
+	d = elf_getdata(s, NULL);
+
+	e->e_u.e_elf.e_window = NULL;
+
+	return (d != NULL);
+}
+
+Elf *
+elf_stream(int fd, Elf_Stream_Handler *handler, void *arg)
+{
+	Elf *e;
+	Elf_Scn **order, *s, *strscn;
+	int rc;
+	size_t i, n, nscn;
+	uint32_t sh_type;
+	struct _Libelf_Stream st;
+
+	if (LIBELF_PRIVATE(version) == EV_NONE) {
+		LIBELF_SET_ERROR(SEQUENCE, 0);
+		return (NULL);
+	}
+
+	if (fd < 0 || handler == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	(void) memset(&st, 0, sizeof(st));
+	st.st_fd = fd;
+
+	order = NULL;
+	if ((e = _libelf_stream_headers(&st)) == NULL)
+		goto done;
+
+	nscn = e->e_u.e_elf.e_nscn;
+	if (nscn > 1 && (order = malloc((nscn - 1) * sizeof(*order))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		goto error;
+	}
+
+	/*
+	 * Translate the section name string table ahead of the other
+	 * sections when it has already been spooled, so that section
+	 * names are available to the handler.  This section is always
+	 * retained.
+	 */
+	strscn = NULL;
+	if (e->e_u.e_elf.e_strndx > 0 && e->e_u.e_elf.e_strndx < nscn) {
+		s = e->e_u.e_elf.e_scntab[e->e_u.e_elf.e_strndx];
+		if (s->s_offset <= st.st_spooled &&
+		    s->s_size <= st.st_spooled - s->s_offset) {
+			if (_libelf_stream_preload(&st, e, s) == 0)
+				goto error;
+			strscn = s;
+		}
+	}
+
+	for (i = 1, n = 0; i < nscn; i++)
+		order[n++] = e->e_u.e_elf.e_scntab[i];
+	if (n > 1)
+		qsort(order, n, sizeof(*order), _libelf_stream_cmp);
+
+	for (i = 0; i < n; i++) {
+		s = order[i];
+
+		sh_type = e->e_class == ELFCLASS32 ?
+		    s->s_shdr.s_shdr32.sh_type : s->s_shdr.s_shdr64.sh_type;
+
+		if (sh_type != SHT_NOBITS &&
+		    _libelf_stream_window(&st, s->s_offset, s->s_size) == 0)
+			goto error;
+
+		e->e_u.e_elf.e_window = st.st_buf;
+		e->e_u.e_elf.e_windowoff = s->s_offset;
+		e->e_u.e_elf.e_windowsz = sh_type == SHT_NOBITS ? 0 :
+		    (size_t) s->s_size;
+
+		rc = (*handler)(e, s, arg);
+
+		if (rc < 0 || (rc & ~(ELF_STREAM_RETAIN | ELF_STREAM_STOP))) {
+			e->e_u.e_elf.e_window = NULL;
+			LIBELF_SET_ERROR(ARGUMENT, 0);
+			goto error;
+		}
+
+		if ((rc & ELF_STREAM_RETAIN) && STAILQ_EMPTY(&s->s_data) &&
+		    elf_getdata(s, NULL) == NULL) {
+			e->e_u.e_elf.e_window = NULL;
+			goto error;
+		}
+
+		e->e_u.e_elf.e_window = NULL;
+
+		if (s != strscn && (rc & ELF_STREAM_RETAIN) == 0) {
+			LIBELF_LOCK(e);
+			_libelf_stream_release_scn(s);
+			LIBELF_UNLOCK(e);
+		}
+
+		if (rc & ELF_STREAM_STOP)
+			break;
+	}
+
+	goto done;
+
+error:
+	(void) elf_end(e);
+	e = NULL;
+
+done:
+	free(order);
+	free(st.st_buf);
+	free(st.st_spool);
+	if (st.st_spoolfile != NULL)
+		(void) fclose(st.st_spoolfile);
+
+	return (e);
+}
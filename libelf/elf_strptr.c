@@ -33,6 +33,85 @@
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Look up a string using the data descriptor remembered for section
+ * `scndx' by an earlier call.  The descriptor is forgotten when it is
+ * released, and is only used while it is the section's sole data
+ * descriptor.  Its contents and the section header may have been
+ * changed by the application since, so these are checked each time.
+ * Returns 0 if the lookup needs to take the slow path.
+ */
+static int
+_libelf_strptr_cached(Elf *e, size_t scndx, size_t offset, char **ptr)
+{
+	Elf_Scn *s;
+	uint32_t sh_type;
+	uint64_t base, sh_size;
+	struct _Libelf_Data *d;
+
+	LIBELF_LOCK(e);
+
+	if (scndx >= e->e_u.e_elf.e_scntabsz ||
+	    (s = e->e_u.e_elf.e_scntab[scndx]) == NULL ||
+	    (d = s->s_strdata) == NULL ||
+	    STAILQ_NEXT(d, d_next) != NULL ||
+	    d->d_data.d_type != ELF_T_BYTE ||
+	    d->d_data.d_buf == NULL ||
+	    (d->d_data.d_align & (d->d_data.d_align - 1)) != 0) {
+		LIBELF_UNLOCK(e);
+		return (0);
+	}
+
+	assert(STAILQ_FIRST(&s->s_data) == d);
+
+	if (e->e_class == ELFCLASS32) {
+		sh_type = s->s_shdr.s_shdr32.sh_type;
+		sh_size = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+	} else {
+		sh_type = s->s_shdr.s_shdr64.sh_type;
+		sh_size = s->s_shdr.s_shdr64.sh_size;
+	}
+
+	base = (e->e_flags & ELF_F_LAYOUT) ? d->d_data.d_off : 0;
+
+	if (sh_type != SHT_STRTAB || offset >= sh_size || offset < base ||
+	    offset - base >= d->d_data.d_size)
+		*ptr = NULL;
+	else
+		*ptr = (char *) d->d_data.d_buf + (offset - base);
+
+	if (*ptr != NULL && (d->d_flags & LIBELF_F_DATA_CACHED))
+		_libelf_cache_hit(d);
+
+	LIBELF_UNLOCK(e);
+
+	if (*ptr == NULL)
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+
+	return (1);
+}
+
+/*
+ * Remember the data descriptor of section `s' when it is the only
+ * one, so that later lookups may use _libelf_strptr_cached().
+ */
+static char *
+_libelf_strptr_remember(Elf_Scn *s, Elf_Data *d, char *ptr)
+{
+	Elf *e;
+	struct _Libelf_Data *ld;
+
+	e = s->s_elf;
+	ld = (struct _Libelf_Data *) d;
+
+	LIBELF_LOCK(e);
+	if (STAILQ_FIRST(&s->s_data) == ld && STAILQ_NEXT(ld, d_next) == NULL)
+		s->s_strdata = ld;
+	LIBELF_UNLOCK(e);
+
+	return (ptr);
+}
+
 /*
  * Convert an ELF section#,offset pair to a string pointer.
  */
@@ -43,6 +122,7 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 	Elf_Scn *s;
 	Elf_Data *d;
 	GElf_Shdr shdr;
+	char *ptr;
 	uint64_t alignment, count;
 
 	if (e == NULL || e->e_kind != ELF_K_ELF) {
@@ -50,6 +130,9 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 		return (NULL);
 	}
 
+	if (_libelf_strptr_cached(e, scndx, offset, &ptr))
+		return (ptr);
+
 	if ((s = elf_getscn(e, scndx)) == NULL ||
 	    gelf_getshdr(s, &shdr) == NULL)
 		return (NULL);
@@ -81,7 +164,8 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 
 			if (offset >= d->d_off &&
 			    offset < d->d_off + d->d_size)
-				return ((char *) d->d_buf + offset - d->d_off);
+				return (_libelf_strptr_remember(s, d,
+				    (char *) d->d_buf + offset - d->d_off));
 		}
 	} else {
 		/*
@@ -117,8 +201,8 @@ elf_strptr(Elf *e, size_t scndx, size_t offset)
 
 			if (offset < count + d->d_size) {
 				if (d->d_buf != NULL)
-					return ((char *) d->d_buf +
-					    offset - count);
+					return (_libelf_strptr_remember(s, d,
+					    (char *) d->d_buf + offset - count));
 				LIBELF_SET_ERROR(DATA, 0);
 				return (NULL);
 			}
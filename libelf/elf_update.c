@@ -93,14 +93,22 @@ enum elf_extent {
  * A extent descriptor, used when laying out an ELF object.
  */
 struct _Elf_Extent {
-	SLIST_ENTRY(_Elf_Extent) ex_next;
 	uint64_t	ex_start; /* Start of the region. */
 	uint64_t	ex_size;  /* The size of the region. */
 	enum elf_extent	ex_type;  /* Type of region. */
 	void		*ex_desc; /* Associated descriptor. */
 };
 
-SLIST_HEAD(_Elf_Extent_List, _Elf_Extent);
+/*
+ * The extents of an ELF object, kept in an array that is sorted in
+ * order of ascending offsets before the object is written out.
+ */
+struct _Elf_Extent_List {
+	struct _Elf_Extent *el_extents;	/* The extents. */
+	size_t		el_count;	/* # of extents in use. */
+	size_t		el_size;	/* # of extents allocated. */
+	int		el_sorted;	/* Non-zero if in ascending order. */
+};
 
 /*
  * Compute the extents of a section, by looking at the data
@@ -119,7 +127,7 @@ _libelf_compute_section_extents(Elf *e, Elf_Scn *s, off_t rc)
 	Elf64_Shdr *shdr64;
 	struct _Libelf_Data *ld;
 	uint64_t scn_size, scn_alignment;
-	uint64_t sh_align, sh_entsize, sh_offset, sh_size;
+	uint64_t sh_align, sh_entsize, sh_flags, sh_offset, sh_size;
 
 	ec = e->e_class;
 
@@ -270,6 +278,33 @@ _libelf_compute_section_extents(Elf *e, Elf_Scn *s, off_t rc)
 			scn_alignment = d_align;
 	}
 
+	/*
+	 * Sections that are to be stored compressed take up the space
+	 * needed by their compressed image, which is built here.  The
+	 * alignment of the uncompressed contents is recorded in the
+	 * compression header of SHF_COMPRESSED sections, and the
+	 * section itself only needs the alignment of the header.
+	 */
+	if (s->s_ctype != LIBELF_COMPRESS_NONE) {
+		sh_flags = ec == ELFCLASS32 ? (uint64_t) shdr32->sh_flags :
+		    shdr64->sh_flags;
+		if ((sh_flags & SHF_COMPRESSED) == 0 && sh_align > scn_alignment)
+			scn_alignment = sh_align;
+		if (!_libelf_compress_scn(s, scn_size, scn_alignment))
+			return (0);
+		scn_size = (uint64_t) s->s_zsize;
+		if (s->s_ctype == LIBELF_COMPRESS_CHDR) {
+			scn_alignment = _libelf_compression_align(s->s_ctype,
+			    ec);
+			if ((e->e_flags & ELF_F_LAYOUT) == 0)
+				sh_align = scn_alignment;
+			if (ec == ELFCLASS32)
+				shdr32->sh_flags |= SHF_COMPRESSED;
+			else
+				shdr64->sh_flags |= SHF_COMPRESSED;
+		}
+	}
+
 
 	/*
 	 * If the application is requesting full control over the
@@ -348,96 +383,122 @@ updatedescriptor:
 static void
 _libelf_release_extents(struct _Elf_Extent_List *extents)
 {
-	struct _Elf_Extent *ex;
-
-	while ((ex = SLIST_FIRST(extents)) != NULL) {
-		SLIST_REMOVE_HEAD(extents, ex_next);
-		free(ex);
-	}
+	free(extents->el_extents);
+	extents->el_extents = NULL;
+	extents->el_count = extents->el_size = 0;
 }
 
 /*
- * Check if an extent 's' defined by [start..start+size) is free.
- * This routine assumes that the given extent list is sorted in order
- * of ascending extent offsets.
+ * Make room for at least `count' extents in the list.
  */
 
 static int
-_libelf_extent_is_unused(struct _Elf_Extent_List *extents,
-    const uint64_t start, const uint64_t size, struct _Elf_Extent **prevt)
+_libelf_reserve_extents(struct _Elf_Extent_List *extents, size_t count)
 {
-	uint64_t tmax, tmin;
-	struct _Elf_Extent *t, *pt;
-	const uint64_t smax = start + size;
+	struct _Elf_Extent *ex;
 
-	/* First, look for overlaps with existing extents. */
-	pt = NULL;
-	SLIST_FOREACH(t, extents, ex_next) {
-		tmin = t->ex_start;
-		tmax = tmin + t->ex_size;
+	if (count <= extents->el_size)
+		return (1);
 
-		if (tmax <= start) {
-			/*
-			 * 't' lies entirely before 's': ...| t |...| s |...
-			 */
-			pt = t;
-			continue;
-		} else if (smax <= tmin) {
-			/*
-			 * 's' lies entirely before 't', and after 'pt':
-			 *      ...| pt |...| s |...| t |...
-			 */
-			assert(pt == NULL ||
-			    pt->ex_start + pt->ex_size <= start);
-			break;
-		} else
-			/* 's' and 't' overlap. */
-			return (0);
+	if (count > SIZE_MAX / sizeof(*ex) ||
+	    (ex = realloc(extents->el_extents, count * sizeof(*ex))) ==
+	    NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (0);
 	}
 
-	if (prevt)
-		*prevt = pt;
+	extents->el_extents = ex;
+	extents->el_size = count;
+
 	return (1);
 }
 
 /*
  * Insert an extent into the list of extents.
+ *
+ * When extents arrive in order of ascending offsets, which is the
+ * case when the library lays out the object, overlaps are detected
+ * here by looking at the preceding extent.  Extents arriving out of
+ * order are checked by _libelf_sort_extents() instead.
  */
 
 static int
 _libelf_insert_extent(struct _Elf_Extent_List *extents, int type,
     uint64_t start, uint64_t size, void *desc)
 {
-	struct _Elf_Extent *ex, *prevt;
+	struct _Elf_Extent *ex, *pt;
 
 	assert(type >= ELF_EXTENT_EHDR && type <= ELF_EXTENT_SHDR);
 
-	prevt = NULL;
-
-	/*
-	 * If the requested range overlaps with an existing extent,
-	 * signal an error.
-	 */
-	if (!_libelf_extent_is_unused(extents, start, size, &prevt)) {
-		LIBELF_SET_ERROR(LAYOUT, 0);
+	if (extents->el_count == extents->el_size &&
+	    !_libelf_reserve_extents(extents, extents->el_size ?
+		2 * extents->el_size : 16))
 		return (0);
-	}
 
-	/* Allocate and fill in a new extent descriptor. */
-	if ((ex = malloc(sizeof(struct _Elf_Extent))) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, errno);
-		return (0);
+	if (extents->el_count > 0 && extents->el_sorted) {
+		pt = &extents->el_extents[extents->el_count - 1];
+
+		/*
+		 * If the requested range overlaps with the preceding
+		 * extent, signal an error.
+		 */
+		if (start < pt->ex_start + pt->ex_size &&
+		    pt->ex_start < start + size) {
+			LIBELF_SET_ERROR(LAYOUT, 0);
+			return (0);
+		}
+
+		if (start < pt->ex_start)
+			extents->el_sorted = 0;
 	}
+
+	ex = &extents->el_extents[extents->el_count++];
 	ex->ex_start = start;
 	ex->ex_size = size;
 	ex->ex_desc = desc;
 	ex->ex_type = type;
 
-	/* Insert the region descriptor into the list. */
-	if (prevt)
-		SLIST_INSERT_AFTER(prevt, ex, ex_next);
-	else
-		SLIST_INSERT_HEAD(extents, ex, ex_next);
+	return (1);
+}
+
+static int
+_libelf_compare_extents(const void *a, const void *b)
+{
+	const struct _Elf_Extent *ea, *eb;
+
+	ea = a;
+	eb = b;
+
+	if (ea->ex_start < eb->ex_start)
+		return (-1);
+	return (ea->ex_start > eb->ex_start);
+}
+
+/*
+ * Sort a list of extents in order of ascending offsets, checking
+ * for overlaps.
+ */
+
+static int
+_libelf_sort_extents(struct _Elf_Extent_List *extents)
+{
+	size_t i;
+	struct _Elf_Extent *ex;
+
+	if (extents->el_sorted)
+		return (1);
+
+	ex = extents->el_extents;
+	qsort(ex, extents->el_count, sizeof(*ex), _libelf_compare_extents);
+
+	for (i = 1; i < extents->el_count; i++)
+		if (ex[i - 1].ex_start + ex[i - 1].ex_size > ex[i].ex_start) {
+			LIBELF_SET_ERROR(LAYOUT, 0);
+			return (0);
+		}
+
+	extents->el_sorted = 1;
+
 	return (1);
 }
 
@@ -450,15 +511,18 @@ _libelf_resync_sections(Elf *e, off_t rc, struct _Elf_Extent_List *extents)
 {
 	int ec;
 	Elf_Scn *s;
-	size_t sh_type;
+	size_t i, sh_type;
 
 	ec = e->e_class;
 
 	/*
-	 * Make a pass through sections, computing the extent of each
-	 * section.
+	 * Make a pass through sections in index order, computing the
+	 * extent of each section.
 	 */
-	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next) {
+	for (i = 0; i < e->e_u.e_elf.e_nscn; i++) {
+		s = e->e_u.e_elf.e_scntab[i];
+		assert(s != NULL && s->s_ndx == i);
+
 		if (ec == ELFCLASS32)
 			sh_type = s->s_shdr.s_shdr32.sh_type;
 		else
@@ -575,6 +639,10 @@ _libelf_resync_elf(Elf *e, struct _Elf_Extent_List *extents)
 
 	e->e_byteorder = eh_byteorder;
 
+	/* Allow for the EHDR, PHDR and SHDR tables, and every section. */
+	if (!_libelf_reserve_extents(extents, shnum + 3))
+		return ((off_t) -1);
+
 #define	INITIALIZE_EHDR(E,EC,V)	do {					\
 		unsigned int _version = (unsigned int) (V);		\
 		(E)->e_ident[EI_MAG0] = ELFMAG0;			\
@@ -647,8 +715,9 @@ _libelf_resync_elf(Elf *e, struct _Elf_Extent_List *extents)
 	 */
 
 	if (e->e_cmd != ELF_C_WRITE &&
-	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
-	    _libelf_load_section_headers(e, ehdr) == 0)
+	    (((e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
+	    _libelf_load_section_headers(e, ehdr) == 0) ||
+	    _libelf_load_sections(e) == 0))
 		return ((off_t) -1);
 
 	if ((rc = _libelf_resync_sections(e, rc, extents)) < 0)
@@ -687,6 +756,9 @@ _libelf_resync_elf(Elf *e, struct _Elf_Extent_List *extents)
 	} else
 		shoff = 0;
 
+	if (!_libelf_sort_extents(extents))
+		return ((off_t) -1);
+
 	/*
 	 * Set the fields of the Executable Header that could potentially use
 	 * extended numbering.
@@ -711,12 +783,324 @@ _libelf_resync_elf(Elf *e, struct _Elf_Extent_List *extents)
 	return (rc);
 }
 
+/*
+ * Output handling.
+ *
+ * Objects opened in ELF_C_RDWR mode whose layout has changed are
+ * assembled in memory and written out at the end, as the contents of
+ * sections that were not modified by the application are read back
+ * from the file that is being overwritten.  Other objects are
+ * written out one extent at a time.  Small pieces are gathered in a
+ * staging buffer, data that does not need translation is written out
+ * from where it lies, and translated data uses a buffer sized for the
+ * largest such piece, so that the memory needed does not depend on
+ * the size of the file.
+ */
+
+#define	LIBELF_SINK_BUFSZ	(64 * 1024)
+
+struct _Elf_Sink {
+	int		sk_fd;		/* Output file descriptor. */
+	unsigned char	*sk_image;	/* File image, if not streaming. */
+	uint64_t	sk_offset;	/* Current offset in the file. */
+	unsigned char	*sk_buf;	/* Staging buffer. */
+	size_t		sk_count;	/* Bytes pending in the staging buffer. */
+	unsigned char	*sk_tmp;	/* Buffer for large translations. */
+	size_t		sk_tmpsz;	/* Size of the above. */
+};
+
+static int
+_libelf_sink_write(int fd, const unsigned char *buf, size_t sz)
+{
+	ssize_t n;
+
+	while (sz > 0) {
+		if ((n = write(fd, buf, sz)) < 0) {
+			if (errno == EINTR)
+				continue;
+			LIBELF_SET_ERROR(IO, errno);
+			return (0);
+		}
+		if (n == 0) {
+			LIBELF_SET_ERROR(IO, 0);
+			return (0);
+		}
+		buf += n;
+		sz -= (size_t) n;
+	}
+
+	return (1);
+}
+
+static int
+_libelf_sink_flush(struct _Elf_Sink *sk)
+{
+	if (sk->sk_count > 0 &&
+	    !_libelf_sink_write(sk->sk_fd, sk->sk_buf, sk->sk_count))
+		return (0);
+
+	sk->sk_count = 0;
+	return (1);
+}
+
+/*
+ * Return space for `sz' bytes of output at the current offset, to be
+ * followed by a call to _libelf_sink_commit().
+ */
+static unsigned char *
+_libelf_sink_reserve(struct _Elf_Sink *sk, size_t sz)
+{
+	if (sk->sk_image)
+		return (sk->sk_image + sk->sk_offset);
+
+	if (sz <= LIBELF_SINK_BUFSZ) {
+		if (sz > LIBELF_SINK_BUFSZ - sk->sk_count &&
+		    !_libelf_sink_flush(sk))
+			return (NULL);
+		return (sk->sk_buf + sk->sk_count);
+	}
+
+	if (sz > sk->sk_tmpsz) {
+		free(sk->sk_tmp);
+		if ((sk->sk_tmp = malloc(sz)) == NULL) {
+			sk->sk_tmpsz = 0;
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (NULL);
+		}
+		sk->sk_tmpsz = sz;
+	}
+
+	return (sk->sk_tmp);
+}
+
+static int
+_libelf_sink_commit(struct _Elf_Sink *sk, size_t sz)
+{
+	sk->sk_offset += sz;
+
+	if (sk->sk_image)
+		return (1);
+
+	if (sz <= LIBELF_SINK_BUFSZ) {
+		sk->sk_count += sz;
+		return (1);
+	}
+
+	return (_libelf_sink_flush(sk) &&
+	    _libelf_sink_write(sk->sk_fd, sk->sk_tmp, sz));
+}
+
+/*
+ * Copy `sz' bytes at `buf' to the output.
+ */
+static int
+_libelf_sink_copy(struct _Elf_Sink *sk, const unsigned char *buf, size_t sz)
+{
+	size_t n;
+	unsigned char *p;
+
+	if (sk->sk_image || sz <= LIBELF_SINK_BUFSZ) {
+		if ((p = _libelf_sink_reserve(sk, sz)) == NULL)
+			return (0);
+		(void) memcpy(p, buf, sz);
+		return (_libelf_sink_commit(sk, sz));
+	}
+
+	/*
+	 * Write out large pieces directly, letting the kernel copy
+	 * them if they come from a mapped file.
+	 */
+	if (!_libelf_sink_flush(sk))
+		return (0);
+
+	n = _libelf_copy_mapped(sk->sk_fd, buf, sz);
+	sk->sk_offset += sz;
+
+	return (_libelf_sink_write(sk->sk_fd, buf + n, sz - n));
+}
+
+/*
+ * Move to offset `off' in the output, filling any gap with the fill
+ * character set by elf_fill(3).  Only an in-memory image may be
+ * revisited.
+ */
+static int
+_libelf_sink_seek(struct _Elf_Sink *sk, uint64_t off)
+{
+	size_t n;
+	unsigned char *p;
+
+	if (off < sk->sk_offset) {
+		assert(sk->sk_image != NULL);
+		sk->sk_offset = off;
+		return (1);
+	}
+
+	while (sk->sk_offset < off) {
+		n = (size_t) MIN(off - sk->sk_offset, LIBELF_SINK_BUFSZ);
+		if ((p = _libelf_sink_reserve(sk, n)) == NULL)
+			return (0);
+		(void) memset(p, LIBELF_PRIVATE(fillchar), n);
+		if (!_libelf_sink_commit(sk, n))
+			return (0);
+	}
+
+	return (1);
+}
+
+/*
+ * Move to offset `off' of the underlying file, when updating an
+ * object in place.  Output gathered for consecutive offsets is
+ * written out together.
+ */
+static int
+_libelf_sink_moveto(struct _Elf_Sink *sk, uint64_t off)
+{
+	assert(sk->sk_image == NULL);
+
+	if (off == sk->sk_offset)
+		return (1);
+
+	if (!_libelf_sink_flush(sk))
+		return (0);
+
+	if (lseek(sk->sk_fd, (off_t) off, SEEK_SET) < 0) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+
+	sk->sk_offset = off;
+	return (1);
+}
+
+/*
+ * Return non-zero if the data descriptors of every section are laid
+ * out in file order, so that the object can be written out in a
+ * single pass.
+ */
+static int
+_libelf_data_is_ordered(Elf *e)
+{
+	Elf_Scn *s;
+	Elf_Data *d;
+	uint64_t end;
+	struct _Libelf_Data *ld;
+
+	if ((e->e_flags & ELF_F_LAYOUT) == 0)
+		return (1);
+
+	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next) {
+		end = 0;
+		STAILQ_FOREACH(ld, &s->s_data, d_next) {
+			d = &ld->d_data;
+			if (d->d_off < end)
+				return (0);
+			end = d->d_off + _libelf_fsize(d->d_type, e->e_class,
+			    e->e_version, (size_t) (d->d_size /
+			    _libelf_msize(d->d_type, e->e_class,
+			    e->e_version)));
+		}
+	}
+
+	return (1);
+}
+
+/*
+ * Check that the sections of an object can be written out, and set
+ * up the buffer needed for its largest translated piece, so that a
+ * streaming update does not discard the existing contents of the file
+ * only to fail part way through.
+ */
+static int
+_libelf_sink_prepare(Elf *e, struct _Elf_Sink *sk,
+    struct _Elf_Extent_List *extents)
+{
+	int ec;
+	Elf_Scn *s;
+	Elf_Data *d;
+	uint32_t sh_type;
+	uint64_t sh_size;
+	struct _Elf_Extent *ex;
+	struct _Libelf_Data *ld;
+	size_t fsz, maxsz, msz;
+
+	ec = e->e_class;
+	maxsz = 0;
+
+	for (ex = extents->el_extents;
+	     ex < extents->el_extents + extents->el_count; ex++) {
+		if (ex->ex_type != ELF_EXTENT_SECTION) {
+			if (ex->ex_size > maxsz)
+				maxsz = (size_t) ex->ex_size;
+			continue;
+		}
+
+		s = ex->ex_desc;
+		if (ec == ELFCLASS32) {
+			sh_type = s->s_shdr.s_shdr32.sh_type;
+			sh_size = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+		} else {
+			sh_type = s->s_shdr.s_shdr64.sh_type;
+			sh_size = s->s_shdr.s_shdr64.sh_size;
+		}
+
+		if (sh_type == SHT_NOBITS || sh_type == SHT_NULL ||
+		    sh_size == 0)
+			continue;
+
+		if (STAILQ_EMPTY(&s->s_data)) {
+			if (elf_rawdata(s, NULL) == NULL)
+				return (0);
+			continue;
+		}
+
+		if (s->s_ctype != LIBELF_COMPRESS_NONE)
+			continue;
+
+		STAILQ_FOREACH(ld, &s->s_data, d_next) {
+			d = &ld->d_data;
+
+			/* See the checks in _libelf_xlate(). */
+			if (d->d_buf == NULL ||
+			    (uintptr_t) d->d_buf % _libelf_malign(d->d_type,
+			    ec)) {
+				LIBELF_SET_ERROR(DATA, 0);
+				return (0);
+			}
+
+			if (_libelf_xlate_is_copy(d->d_type, ec,
+			    e->e_byteorder))
+				continue;
+
+			if ((msz = _libelf_msize(d->d_type, ec,
+			    e->e_version)) == 0)
+				return (0);
+			fsz = _libelf_fsize(d->d_type, ec, e->e_version,
+			    (size_t) (d->d_size / msz));
+			if (fsz > maxsz)
+				maxsz = fsz;
+		}
+	}
+
+	if (maxsz > LIBELF_SINK_BUFSZ && maxsz > sk->sk_tmpsz) {
+		free(sk->sk_tmp);
+		if ((sk->sk_tmp = malloc(maxsz)) == NULL) {
+			sk->sk_tmpsz = 0;
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (0);
+		}
+		sk->sk_tmpsz = maxsz;
+	}
+
+	return (1);
+}
+
 /*
  * Write out the contents of an ELF section.
  */
 
 static off_t
-_libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_scn(Elf *e, struct _Elf_Sink *sk, struct _Elf_Extent *ex)
 {
 	off_t rc;
 	int ec, em;
@@ -773,25 +1157,37 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 			d = &ld->d_data;
 
-			if ((uint64_t) rc < sh_off + d->d_off)
-				(void) memset(nf + rc,
-				    LIBELF_PRIVATE(fillchar),
-				    (size_t) (sh_off + d->d_off -
-					(uint64_t) rc));
-			rc = (off_t) (sh_off + d->d_off);
+			if (!_libelf_sink_seek(sk, sh_off + d->d_off))
+				return ((off_t) -1);
 
 			assert(d->d_buf != NULL);
 			assert(d->d_type == ELF_T_BYTE);
 			assert(d->d_version == e->e_version);
 
-			(void) memcpy(nf + rc,
+			if (!_libelf_sink_copy(sk,
 			    e->e_rawfile + s->s_rawoff + d->d_off,
-			    (size_t) d->d_size);
-
-			rc += (off_t) d->d_size;
+			    (size_t) d->d_size))
+				return ((off_t) -1);
 		}
 
-		return (rc);
+		return ((off_t) sk->sk_offset);
+	}
+
+	/*
+	 * Sections stored compressed have had their image built by
+	 * the prior call to _libelf_resync_elf().
+	 */
+	if (s->s_ctype != LIBELF_COMPRESS_NONE) {
+		assert(s->s_zimage != NULL);
+
+		if (!_libelf_sink_copy(sk, s->s_zimage, s->s_zsize) ||
+		    !_libelf_sink_seek(sk, sh_off + sh_size))
+			return ((off_t) -1);
+
+		free(s->s_zimage);
+		s->s_zimage = NULL;
+
+		return ((off_t) sk->sk_offset);
 	}
 
 	/*
@@ -809,12 +1205,8 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 		if ((msz = _libelf_msize(d->d_type, ec, e->e_version)) == 0)
 			return ((off_t) -1);
 
-		if ((uint64_t) rc < sh_off + d->d_off)
-			(void) memset(nf + rc,
-			    LIBELF_PRIVATE(fillchar),
-			    (size_t) (sh_off + d->d_off - (uint64_t) rc));
-
-		rc = (off_t) (sh_off + d->d_off);
+		if (!_libelf_sink_seek(sk, sh_off + d->d_off))
+			return ((off_t) -1);
 
 		assert(d->d_buf != NULL);
 		assert(d->d_version == e->e_version);
@@ -825,17 +1217,43 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 		fsz = _libelf_fsize(d->d_type, ec, e->e_version, nobjects);
 
-		dst.d_buf    = nf + rc;
-		dst.d_size   = fsz;
+		if (sh_off + d->d_off + fsz > (uint64_t) rc)
+			rc = (off_t) (sh_off + d->d_off + fsz);
+
+		/*
+		 * When streaming, write out data that needs no
+		 * translation without copying it first.
+		 */
+		if (sk->sk_image == NULL &&
+		    _libelf_xlate_is_copy(d->d_type, ec, e->e_byteorder) &&
+		    (uintptr_t) d->d_buf % _libelf_malign(d->d_type, ec) == 0) {
+			if (!_libelf_sink_copy(sk, d->d_buf, fsz))
+				return ((off_t) -1);
+			continue;
+		}
+
+		if ((dst.d_buf = _libelf_sink_reserve(sk, fsz)) == NULL)
+			return ((off_t) -1);
+		dst.d_size = fsz;
 
 		if (_libelf_xlate(&dst, d, e->e_byteorder, ec, em, ELF_TOFILE)
 		    == NULL)
 			return ((off_t) -1);
 
-		rc += (off_t) fsz;
+		if (!_libelf_sink_commit(sk, fsz))
+			return ((off_t) -1);
 	}
 
-	return (rc);
+	/*
+	 * Data descriptors placed out of order by the application
+	 * may leave the output position short of the section's end.
+	 */
+	if (sk->sk_offset < (uint64_t) rc) {
+		assert(sk->sk_image != NULL);
+		sk->sk_offset = (uint64_t) rc;
+	}
+
+	return ((off_t) sk->sk_offset);
 }
 
 /*
@@ -843,7 +1261,7 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_ehdr(Elf *e, struct _Elf_Sink *sk, struct _Elf_Extent *ex)
 {
 	int ec, em;
 	void *ehdr;
@@ -872,11 +1290,12 @@ _libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	src.d_type    = ELF_T_EHDR;
 	src.d_version = dst.d_version = e->e_version;
 
-	dst.d_buf     = nf;
+	if ((dst.d_buf = _libelf_sink_reserve(sk, fsz)) == NULL)
+		return ((off_t) -1);
 	dst.d_size    = fsz;
 
 	if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em, ELF_TOFILE) ==
-	    NULL)
+	    NULL || !_libelf_sink_commit(sk, fsz))
 		return ((off_t) -1);
 
 	return ((off_t) fsz);
@@ -887,7 +1306,7 @@ _libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_phdr(Elf *e, struct _Elf_Sink *sk, struct _Elf_Extent *ex)
 {
 	int ec, em;
 	void *ehdr;
@@ -935,10 +1354,11 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	src.d_size = phnum * msz;
 
 	dst.d_size = fsz;
-	dst.d_buf = nf + ex->ex_start;
+	if ((dst.d_buf = _libelf_sink_reserve(sk, fsz)) == NULL)
+		return ((off_t) -1);
 
 	if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em, ELF_TOFILE) ==
-	    NULL)
+	    NULL || !_libelf_sink_commit(sk, fsz))
 		return ((off_t) -1);
 
 	return ((off_t) (phoff + fsz));
@@ -949,10 +1369,11 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_shdr(Elf *e, struct _Elf_Sink *sk, struct _Elf_Extent *ex)
 {
 	int ec, em;
 	void *ehdr;
+	unsigned char *nf;
 	Elf_Scn *scn;
 	uint64_t shoff;
 	Elf32_Ehdr *eh32;
@@ -995,6 +1416,9 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
 
+	if ((nf = _libelf_sink_reserve(sk, nscn * fsz)) == NULL)
+		return ((off_t) -1);
+
 	STAILQ_FOREACH(scn, &e->e_u.e_elf.e_scn, s_next) {
 		if (ec == ELFCLASS32)
 			src.d_buf = &scn->s_shdr.s_shdr32;
@@ -1002,16 +1426,353 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 			src.d_buf = &scn->s_shdr.s_shdr64;
 
 		dst.d_size = fsz;
-		dst.d_buf = nf + ex->ex_start + scn->s_ndx * fsz;
+		dst.d_buf = nf + scn->s_ndx * fsz;
 
 		if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em,
 			ELF_TOFILE) == NULL)
 			return ((off_t) -1);
 	}
 
+	if (!_libelf_sink_commit(sk, nscn * fsz))
+		return ((off_t) -1);
+
 	return ((off_t) (ex->ex_start + nscn * fsz));
 }
 
+/*
+ * In-place updates.
+ *
+ * Applications that open an object with ELF_C_RDWR often change a
+ * few headers or the contents of a section without changing its
+ * size.  When the layout computed by _libelf_resync_elf() matches
+ * that of the file being updated, only the executable header, the
+ * program header table, the sections whose contents have been read
+ * in, and the section headers that are marked with ELF_F_DIRTY are
+ * written out, at their existing offsets.  Sections whose contents
+ * were read in are written out whether or not they were marked
+ * dirty, as functions like gelf_update_sym() and direct changes to
+ * their data buffers do not mark them so.  Other objects, including
+ * those where _libelf_resync_elf() changed a section header that was
+ * not marked dirty, are rewritten in full.
+ */
+
+/*
+ * Return non-zero if the section or any of its data descriptors
+ * has been marked dirty, in which case its section header is
+ * written out.
+ */
+static int
+_libelf_scn_is_dirty(Elf_Scn *s)
+{
+	struct _Libelf_Data *ld;
+
+	if (s->s_flags & ELF_F_DIRTY)
+		return (1);
+
+	STAILQ_FOREACH(ld, &s->s_data, d_next)
+		if (ld->d_flags & ELF_F_DIRTY)
+			return (1);
+
+	return (0);
+}
+
+/*
+ * Translate the structure of type `t' at offset `off' in the
+ * original file into `dst'.
+ */
+static int
+_libelf_read_raw(Elf *e, Elf_Type t, uint64_t off, void *dst, size_t dsz)
+{
+	size_t fsz;
+	_libelf_translator_function *xlator;
+
+	fsz = _libelf_fsize(t, e->e_class, e->e_version, (size_t) 1);
+	if (off > (uint64_t) e->e_rawsize ||
+	    fsz > (uint64_t) e->e_rawsize - off)
+		return (0);
+
+	xlator = _libelf_get_translator(t, ELF_TOMEMORY, e->e_class,
+	    _libelf_elfmachine(e));
+	return ((*xlator)(dst, dsz, e->e_rawfile + off, (size_t) 1,
+	    e->e_byteorder != LIBELF_PRIVATE(byteorder)));
+}
+
+/*
+ * Return non-zero if the extents computed for an object opened with
+ * ELF_C_RDWR are where they are in the file being updated.
+ */
+static int
+_libelf_layout_is_unchanged(Elf *e, off_t newsize,
+    struct _Elf_Extent_List *extents)
+{
+	int ec;
+	Elf_Scn *s;
+	size_t fsz, i, phnum, shnum;
+	struct _Elf_Extent *ex;
+	uint64_t phoff, shoff, sh_offset, sh_size;
+	uint32_t sh_type;
+	union {
+		Elf32_Ehdr	eh32;
+		Elf64_Ehdr	eh64;
+	} eh;
+	union {
+		Elf32_Shdr	sh32;
+		Elf64_Shdr	sh64;
+	} sh;
+
+	/*
+	 * The file needs to be mapped in, so that its mapping can be
+	 * refreshed once it has been written to.
+	 */
+	if (e->e_cmd != ELF_C_RDWR || newsize != e->e_rawsize ||
+	    (e->e_flags & LIBELF_F_SPECIAL_FILE) ||
+	    (e->e_flags & LIBELF_F_RAWFILE_MMAP) == 0 ||
+	    !_libelf_data_is_ordered(e))
+		return (0);
+
+	ec = e->e_class;
+
+	if (!_libelf_read_raw(e, ELF_T_EHDR, 0, &eh, sizeof(eh)))
+		return (0);
+
+	if (ec == ELFCLASS32) {
+		phoff = (uint64_t) eh.eh32.e_phoff;
+		shoff = (uint64_t) eh.eh32.e_shoff;
+		phnum = eh.eh32.e_phnum;
+		shnum = eh.eh32.e_shnum;
+	} else {
+		phoff = eh.eh64.e_phoff;
+		shoff = eh.eh64.e_shoff;
+		phnum = eh.eh64.e_phnum;
+		shnum = eh.eh64.e_shnum;
+	}
+
+	/* Large counts are kept in section header 0. */
+	if ((shnum == 0 && shoff != 0) || phnum == PN_XNUM) {
+		if (!_libelf_read_raw(e, ELF_T_SHDR, shoff, &sh, sizeof(sh)))
+			return (0);
+		if (shnum == 0)
+			shnum = (size_t) (ec == ELFCLASS32 ?
+			    sh.sh32.sh_size : sh.sh64.sh_size);
+		if (phnum == PN_XNUM)
+			phnum = ec == ELFCLASS32 ? sh.sh32.sh_info :
+			    sh.sh64.sh_info;
+	}
+
+	if (phnum != e->e_u.e_elf.e_nphdr || shnum != e->e_u.e_elf.e_nscn)
+		return (0);
+
+	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
+
+	for (ex = extents->el_extents;
+	     ex < extents->el_extents + extents->el_count; ex++) {
+		switch (ex->ex_type) {
+		case ELF_EXTENT_EHDR:
+			break;
+
+		case ELF_EXTENT_PHDR:
+			if (ex->ex_start != phoff)
+				return (0);
+			break;
+
+		case ELF_EXTENT_SHDR:
+			if (ex->ex_start != shoff)
+				return (0);
+			break;
+
+		case ELF_EXTENT_SECTION:
+			s = ex->ex_desc;
+			if (!_libelf_read_raw(e, ELF_T_SHDR,
+			    shoff + s->s_ndx * fsz, &sh, sizeof(sh)))
+				return (0);
+			if (ec == ELFCLASS32) {
+				sh_type   = sh.sh32.sh_type;
+				sh_offset = (uint64_t) sh.sh32.sh_offset;
+				sh_size   = (uint64_t) sh.sh32.sh_size;
+			} else {
+				sh_type   = sh.sh64.sh_type;
+				sh_offset = sh.sh64.sh_offset;
+				sh_size   = sh.sh64.sh_size;
+			}
+			if (sh_type == SHT_NOBITS || s->s_offset != sh_offset ||
+			    s->s_size != sh_size)
+				return (0);
+			break;
+
+		default:
+			assert(0);
+			break;
+		}
+	}
+
+	/*
+	 * Only the section headers of dirty sections are written out,
+	 * so any other section header needs to match the one in the
+	 * file.
+	 */
+	for (i = 0; i < e->e_u.e_elf.e_nscn; i++) {
+		s = e->e_u.e_elf.e_scntab[i];
+		assert(s != NULL && s->s_ndx == i);
+
+		if (_libelf_scn_is_dirty(s))
+			continue;
+
+		if (!_libelf_read_raw(e, ELF_T_SHDR, shoff + i * fsz, &sh,
+		    sizeof(sh)))
+			return (0);
+
+		if (ec == ELFCLASS32) {
+			if (memcmp(&sh.sh32, &s->s_shdr.s_shdr32,
+			    sizeof(sh.sh32)) != 0)
+				return (0);
+		} else if (memcmp(&sh.sh64, &s->s_shdr.s_shdr64,
+		    sizeof(sh.sh64)) != 0)
+			return (0);
+	}
+
+	return (1);
+}
+
+/*
+ * Write out the section headers of sections that have been marked
+ * dirty.
+ */
+static int
+_libelf_write_dirty_shdrs(Elf *e, struct _Elf_Sink *sk,
+    struct _Elf_Extent *ex)
+{
+	int ec, em;
+	size_t fsz, i, msz;
+	Elf_Scn *scn;
+	Elf_Data dst, src;
+
+	assert(ex->ex_type == ELF_EXTENT_SHDR);
+
+	ec = e->e_class;
+	em = _libelf_elfmachine(e);
+
+	(void) memset(&dst, 0, sizeof(dst));
+	(void) memset(&src, 0, sizeof(src));
+
+	if ((msz = _libelf_msize(ELF_T_SHDR, ec, e->e_version)) == 0)
+		return (0);
+	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
+
+	src.d_type = ELF_T_SHDR;
+	src.d_size = msz;
+	src.d_version = dst.d_version = e->e_version;
+
+	for (i = 0; i < e->e_u.e_elf.e_nscn; i++) {
+		scn = e->e_u.e_elf.e_scntab[i];
+		assert(scn != NULL && scn->s_ndx == i);
+
+		if (!_libelf_scn_is_dirty(scn))
+			continue;
+
+		if (ec == ELFCLASS32)
+			src.d_buf = &scn->s_shdr.s_shdr32;
+		else
+			src.d_buf = &scn->s_shdr.s_shdr64;
+
+		if (!_libelf_sink_moveto(sk, ex->ex_start + i * fsz) ||
+		    (dst.d_buf = _libelf_sink_reserve(sk, fsz)) == NULL)
+			return (0);
+		dst.d_size = fsz;
+
+		if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em,
+		    ELF_TOFILE) == NULL || !_libelf_sink_commit(sk, fsz))
+			return (0);
+	}
+
+	return (1);
+}
+
+/*
+ * Update an object in place, see above.
+ */
+static int
+_libelf_write_dirty_extents(Elf *e, struct _Elf_Sink *sk,
+    struct _Elf_Extent_List *extents)
+{
+	off_t nrc;
+	Elf_Scn *s;
+	struct _Elf_Extent *ex;
+#if	ELFTC_HAVE_MMAP
+	unsigned char *m;
+#endif
+
+	assert(e->e_cmd == ELF_C_RDWR);
+	assert(e->e_flags & LIBELF_F_RAWFILE_MMAP);
+
+	if (lseek(e->e_fd, (off_t) 0, SEEK_SET) < 0) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+
+	for (ex = extents->el_extents;
+	     ex < extents->el_extents + extents->el_count; ex++) {
+		nrc = 0;
+
+		switch (ex->ex_type) {
+		case ELF_EXTENT_EHDR:
+			if (!_libelf_sink_moveto(sk, ex->ex_start))
+				return (0);
+			nrc = _libelf_write_ehdr(e, sk, ex);
+			break;
+
+		case ELF_EXTENT_PHDR:
+			if (!_libelf_sink_moveto(sk, ex->ex_start))
+				return (0);
+			nrc = _libelf_write_phdr(e, sk, ex);
+			break;
+
+		case ELF_EXTENT_SECTION:
+			/*
+			 * Sections without data descriptors have not
+			 * had their contents changed.
+			 */
+			s = ex->ex_desc;
+			if (STAILQ_EMPTY(&s->s_data))
+				break;
+			if (!_libelf_sink_moveto(sk, ex->ex_start))
+				return (0);
+			nrc = _libelf_write_scn(e, sk, ex);
+			break;
+
+		case ELF_EXTENT_SHDR:
+			if (!_libelf_write_dirty_shdrs(e, sk, ex))
+				return (0);
+			break;
+
+		default:
+			assert(0);
+			break;
+		}
+
+		if (nrc < 0)
+			return (0);
+	}
+
+	if (!_libelf_sink_flush(sk))
+		return (0);
+
+	/*
+	 * Refresh the mapping of the file, as the contents of private
+	 * mappings need not reflect later changes to the file.
+	 */
+#if	ELFTC_HAVE_MMAP
+	if ((m = mmap(NULL, (size_t) e->e_rawsize, PROT_READ, MAP_PRIVATE,
+	    e->e_fd, (off_t) 0)) == MAP_FAILED) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (0);
+	}
+	(void) munmap(e->e_rawfile, (size_t) e->e_rawsize);
+	e->e_rawfile = m;
+#endif
+
+	return (1);
+}
+
 /*
  * Write out the file image.
  *
@@ -1025,6 +1786,18 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  * in ELF_C_RDWR and only retrieved/modified a few sections.  We take
  * care to avoid translating file sections unnecessarily.
  *
+ * Objects opened with ELF_C_WRITE have no such dependency on the
+ * old file contents, and are written out extent by extent as their
+ * file image is produced, unless the application placed data
+ * descriptors out of order using ELF_F_LAYOUT, or the file being
+ * written is also mapped in by an ELF_C_READ descriptor whose data
+ * could be in use.  The existing contents of the file are only
+ * discarded once _libelf_sink_prepare() has found nothing that would
+ * prevent this from succeeding.
+ *
+ * Objects opened with ELF_C_RDWR whose layout has not changed are
+ * updated in place, see _libelf_write_dirty_extents().
+ *
  * Gaps in the coverage of the file by the file's sections will be
  * filled with the fill character set by elf_fill(3).
  */
@@ -1035,43 +1808,79 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 	off_t nrc, rc;
 	Elf_Scn *scn, *tscn;
 	struct _Elf_Extent *ex;
+	struct _Elf_Sink sk;
 	unsigned char *newfile;
 
 	assert(e->e_kind == ELF_K_ELF);
 	assert(e->e_cmd == ELF_C_RDWR || e->e_cmd == ELF_C_WRITE);
 	assert(e->e_fd >= 0);
 
-	if ((newfile = malloc((size_t) newsize)) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, errno);
-		return ((off_t) -1);
+	(void) memset(&sk, 0, sizeof(sk));
+	sk.sk_fd = e->e_fd;
+	newfile = NULL;
+
+	if (_libelf_layout_is_unchanged(e, newsize, extents)) {
+		if ((sk.sk_buf = malloc(LIBELF_SINK_BUFSZ)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return ((off_t) -1);
+		}
+		if (!_libelf_write_dirty_extents(e, &sk, extents))
+			goto error;
+		rc = newsize;
+		goto done;
+	}
+
+	if (e->e_cmd == ELF_C_RDWR || !_libelf_data_is_ordered(e) ||
+	    _libelf_file_is_mapped(e->e_fd)) {
+		if ((newfile = malloc((size_t) newsize)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return ((off_t) -1);
+		}
+		sk.sk_image = newfile;
+	} else {
+		if ((sk.sk_buf = malloc(LIBELF_SINK_BUFSZ)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return ((off_t) -1);
+		}
+
+		if (!_libelf_sink_prepare(e, &sk, extents))
+			goto error;
+
+		/* Throw away the existing content of regular files. */
+		if ((e->e_flags & LIBELF_F_SPECIAL_FILE) == 0 &&
+		    (ftruncate(e->e_fd, (off_t) 0) < 0 ||
+		    lseek(e->e_fd, (off_t) 0, SEEK_SET))) {
+			LIBELF_SET_ERROR(IO, errno);
+			goto error;
+		}
 	}
 
 	nrc = rc = 0;
-	SLIST_FOREACH(ex, extents, ex_next) {
+	for (ex = extents->el_extents;
+	     ex < extents->el_extents + extents->el_count; ex++) {
 
 		/* Fill inter-extent gaps. */
-		if (ex->ex_start > (size_t) rc)
-			(void) memset(newfile + rc, LIBELF_PRIVATE(fillchar),
-			    (size_t) (ex->ex_start - (uint64_t) rc));
+		if (!_libelf_sink_seek(&sk, ex->ex_start))
+			goto error;
 
 		switch (ex->ex_type) {
 		case ELF_EXTENT_EHDR:
-			if ((nrc = _libelf_write_ehdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_ehdr(e, &sk, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_PHDR:
-			if ((nrc = _libelf_write_phdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_phdr(e, &sk, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_SECTION:
-			if ((nrc = _libelf_write_scn(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_scn(e, &sk, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_SHDR:
-			if ((nrc = _libelf_write_shdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_shdr(e, &sk, ex)) < 0)
 				goto error;
 			break;
 
@@ -1088,6 +1897,15 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 
 	assert(rc == newsize);
 
+	if (newfile == NULL) {
+		/* Write out any remaining buffered content. */
+		if (!_libelf_sink_flush(&sk))
+			goto error;
+		assert(e->e_cmd == ELF_C_WRITE);
+		assert(e->e_rawfile == NULL);
+		goto done;
+	}
+
 	/*
 	 * For regular files, throw away existing file content and
 	 * unmap any existing mappings.
@@ -1113,10 +1931,8 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 	/*
 	 * Write out the new contents.
 	 */
-	if (write(e->e_fd, newfile, (size_t) newsize) != newsize) {
-		LIBELF_SET_ERROR(IO, errno);
+	if (!_libelf_sink_write(e->e_fd, newfile, (size_t) newsize))
 		goto error;
-	}
 
 	/*
 	 * For files opened in ELF_C_RDWR mode, set up the new 'raw'
@@ -1157,7 +1973,8 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 	 * and elf_getscn() will function correctly.
 	 */
 
-	e->e_flags &= ~ELF_F_DIRTY;
+ done:
+	e->e_flags &= ~(ELF_F_DIRTY | LIBELF_F_SHDRS_LOADED);
 
 	STAILQ_FOREACH_SAFE(scn, &e->e_u.e_elf.e_scn, s_next, tscn)
 		_libelf_release_scn(scn);
@@ -1178,14 +1995,18 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		e->e_u.e_elf.e_phdr.e_phdr64 = NULL;
 	}
 
-	/* Free the temporary buffer. */
+	/* Free the temporary buffers. */
 	if (newfile)
 		free(newfile);
+	free(sk.sk_buf);
+	free(sk.sk_tmp);
 
 	return (rc);
 
  error:
 	free(newfile);
+	free(sk.sk_buf);
+	free(sk.sk_tmp);
 
 	return ((off_t) -1);
 }
@@ -1222,7 +2043,11 @@ elf_update(Elf *e, Elf_Cmd c)
 		return (rc);
 	}
 
-	SLIST_INIT(&extents);
+	extents.el_extents = NULL;
+	extents.el_count = extents.el_size = 0;
+	extents.el_sorted = 1;
+
+	LIBELF_LOCK(e);
 
 	if ((rc = _libelf_resync_elf(e, &extents)) < 0)
 		goto done;
@@ -1239,6 +2064,7 @@ elf_update(Elf *e, Elf_Cmd c)
 	rc = _libelf_write_elf(e, rc, &extents);
 
 done:
+	LIBELF_UNLOCK(e);
 	_libelf_release_extents(&extents);
 	return (rc);
 }
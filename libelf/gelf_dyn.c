@@ -28,6 +28,7 @@
 #include <gelf.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "_libelf.h"
 
@@ -93,6 +94,30 @@ gelf_getdyn(Elf_Data *ed, int ndx, GElf_Dyn *dst)
 	return (dst);
 }
 
+GElf_Dyn *
+gelf_getdyns(Elf_Data *ed, size_t first, size_t count, GElf_Dyn *dst)
+{
+	int ec;
+	size_t i;
+	void *src;
+	const Elf32_Dyn *dyn32;
+
+	if ((src = _libelf_getrange(ed, ELF_T_DYN, first, count, dst,
+	    &ec)) == NULL)
+		return (NULL);
+
+	if (ec == ELFCLASS32) {
+		dyn32 = src;
+		for (i = 0; i < count; i++) {
+			dst[i].d_tag      = dyn32[i].d_tag;
+			dst[i].d_un.d_val = (Elf64_Xword) dyn32[i].d_un.d_val;
+		}
+	} else
+		(void) memcpy(dst, src, count * sizeof(Elf64_Dyn));
+
+	return (dst);
+}
+
 int
 gelf_update_dyn(Elf_Data *ed, int ndx, GElf_Dyn *ds)
 {
@@ -28,6 +28,7 @@
 #include <gelf.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "_libelf.h"
 
@@ -95,6 +96,32 @@ gelf_getrel(Elf_Data *ed, int ndx, GElf_Rel *dst)
 	return (dst);
 }
 
+GElf_Rel *
+gelf_getrels(Elf_Data *ed, size_t first, size_t count, GElf_Rel *dst)
+{
+	int ec;
+	size_t i;
+	void *src;
+	const Elf32_Rel *rel32;
+
+	if ((src = _libelf_getrange(ed, ELF_T_REL, first, count, dst,
+	    &ec)) == NULL)
+		return (NULL);
+
+	if (ec == ELFCLASS32) {
+		rel32 = src;
+		for (i = 0; i < count; i++) {
+			dst[i].r_offset = (Elf64_Addr) rel32[i].r_offset;
+			dst[i].r_info   = ELF64_R_INFO(
+			    (Elf64_Xword) ELF32_R_SYM(rel32[i].r_info),
+			    ELF32_R_TYPE(rel32[i].r_info));
+		}
+	} else
+		(void) memcpy(dst, src, count * sizeof(Elf64_Rel));
+
+	return (dst);
+}
+
 int
 gelf_update_rel(Elf_Data *ed, int ndx, GElf_Rel *dr)
 {
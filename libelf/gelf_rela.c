@@ -28,6 +28,7 @@
 #include <gelf.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "_libelf.h"
 
@@ -96,6 +97,33 @@ gelf_getrela(Elf_Data *ed, int ndx, GElf_Rela *dst)
 	return (dst);
 }
 
+GElf_Rela *
+gelf_getrelas(Elf_Data *ed, size_t first, size_t count, GElf_Rela *dst)
+{
+	int ec;
+	size_t i;
+	void *src;
+	const Elf32_Rela *rela32;
+
+	if ((src = _libelf_getrange(ed, ELF_T_RELA, first, count, dst,
+	    &ec)) == NULL)
+		return (NULL);
+
+	if (ec == ELFCLASS32) {
+		rela32 = src;
+		for (i = 0; i < count; i++) {
+			dst[i].r_offset = (Elf64_Addr) rela32[i].r_offset;
+			dst[i].r_info   = ELF64_R_INFO(
+			    (Elf64_Xword) ELF32_R_SYM(rela32[i].r_info),
+			    ELF32_R_TYPE(rela32[i].r_info));
+			dst[i].r_addend = (Elf64_Sxword) rela32[i].r_addend;
+		}
+	} else
+		(void) memcpy(dst, src, count * sizeof(Elf64_Rela));
+
+	return (dst);
+}
+
 int
 gelf_update_rela(Elf_Data *ed, int ndx, GElf_Rela *dr)
 {
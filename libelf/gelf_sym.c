@@ -28,6 +28,7 @@
 #include <gelf.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "_libelf.h"
 
@@ -95,6 +96,34 @@ gelf_getsym(Elf_Data *ed, int ndx, GElf_Sym *dst)
 	return (dst);
 }
 
+GElf_Sym *
+gelf_getsyms(Elf_Data *ed, size_t first, size_t count, GElf_Sym *dst)
+{
+	int ec;
+	size_t i;
+	void *src;
+	const Elf32_Sym *sym32;
+
+	if ((src = _libelf_getrange(ed, ELF_T_SYM, first, count, dst,
+	    &ec)) == NULL)
+		return (NULL);
+
+	if (ec == ELFCLASS32) {
+		sym32 = src;
+		for (i = 0; i < count; i++) {
+			dst[i].st_name  = sym32[i].st_name;
+			dst[i].st_value = (Elf64_Addr) sym32[i].st_value;
+			dst[i].st_size  = (Elf64_Xword) sym32[i].st_size;
+			dst[i].st_info  = sym32[i].st_info;
+			dst[i].st_other = sym32[i].st_other;
+			dst[i].st_shndx = sym32[i].st_shndx;
+		}
+	} else
+		(void) memcpy(dst, src, count * sizeof(Elf64_Sym));
+
+	return (dst);
+}
+
 int
 gelf_update_sym(Elf_Data *ed, int ndx, GElf_Sym *gs)
 {
@@ -97,6 +97,19 @@ typedef enum {
 #define	ELF_C_FIRST	ELF_C_NULL
 #define	ELF_C_LAST	ELF_C_NUM
 
+/*
+ * Access advice for elf_advise() and elf_advisescn().
+ */
+#define	ELF_ADV_NORMAL		0	/* no particular access pattern */
+#define	ELF_ADV_RANDOM		1	/* accessed in random order */
+#define	ELF_ADV_SEQUENTIAL	2	/* accessed sequentially */
+#define	ELF_ADV_WILLNEED	3	/* will be accessed soon */
+#define	ELF_ADV_POPULATE	4	/* bring into memory now */
+#define	ELF_ADV_HUGEPAGE	5	/* back with large pages */
+
+#define	ELF_ADV_FIRST		ELF_ADV_NORMAL
+#define	ELF_ADV_LAST		ELF_ADV_HUGEPAGE
+
 /*
  * An `Elf_Data' structure describes data in an
  * ELF section.
@@ -142,6 +155,28 @@ typedef struct {
 	char		*as_name; 	/* null terminated symbol name */
 } Elf_Arsym;
 
+/*
+ * An `Elf_Cachestat' describes the state of the cache of
+ * translated section data.
+ */
+typedef struct {
+	size_t		cs_limit;	/* memory limit, or zero */
+	size_t		cs_size;	/* memory held by cached data */
+	uint64_t	cs_hits;	/* retrievals of cached data */
+	uint64_t	cs_misses;	/* translations into the cache */
+	uint64_t	cs_evictions;	/* cached data released */
+} Elf_Cachestat;
+
+/*
+ * An `Elf_Stream_Handler' is called by elf_stream() for each
+ * section of an object read from a stream, in file order.  It
+ * returns a combination of the ELF_STREAM_* flags below.
+ */
+typedef int Elf_Stream_Handler(Elf *_elf, Elf_Scn *_scn, void *_arg);
+
+#define	ELF_STREAM_RETAIN	0x1	/* keep the section's data */
+#define	ELF_STREAM_STOP		0x2	/* stop reading the stream */
+
 /*
  * Error numbers.
  */
@@ -175,12 +210,19 @@ enum Elf_Error {
 /* ELF(3) API extensions. */
 #define	ELF_F_ARCHIVE	   0x100U /* archive creation */
 #define	ELF_F_ARCHIVE_SYSV 0x200U /* SYSV style archive */
+#define	ELF_F_READONLY	   0x400U /* section data will not be modified */
+#define	ELF_F_EVICTABLE	   0x800U /* section data may be released */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
+int		elf_advise(Elf *_elf, int _advice);
+int		elf_advisescn(Elf_Scn *_scn, int _advice);
+Elf		*elf_ar_member_at(Elf *_ar, off_t _offset);
+Elf_Arsym	*elf_arsym_lookup(Elf *_ar, const char *_name);
 Elf		*elf_begin(int _fd, Elf_Cmd _cmd, Elf *_elf);
 int		elf_cntl(Elf *_elf, Elf_Cmd _cmd);
+int		elf_compress(Elf_Scn *_scn, int _type, unsigned int _flags);
 int		elf_end(Elf *_elf);
 const char	*elf_errmsg(int _error);
 int		elf_errno(void);
@@ -197,6 +239,7 @@ unsigned int	elf_flagshdr(Elf_Scn *_scn, Elf_Cmd _cmd, unsigned int _flags);
 Elf_Arhdr	*elf_getarhdr(Elf *_elf);
 Elf_Arsym	*elf_getarsym(Elf *_elf, size_t *_ptr);
 off_t		elf_getbase(Elf *_elf);
+int		elf_getcachestat(Elf_Cachestat *_cs);
 Elf_Data	*elf_getdata(Elf_Scn *, Elf_Data *);
 char		*elf_getident(Elf *_elf, size_t *_ptr);
 int		elf_getphdrnum(Elf *_elf, size_t *_dst);
@@ -207,6 +250,9 @@ int		elf_getshnum(Elf *_elf, size_t *_dst);	/* Deprecated */
 int		elf_getshdrstrndx(Elf *_elf, size_t *_dst);
 int		elf_getshstrndx(Elf *_elf, size_t *_dst); /* Deprecated */
 unsigned long	elf_hash(const char *_name);
+int		elf_hashstrings(const char *_strtab, size_t _strsz,
+			const size_t *_offsets, size_t _count,
+			uint32_t *_sysvhash, uint32_t *_gnuhash);
 Elf_Kind	elf_kind(Elf *_elf);
 Elf		*elf_memory(char *_image, size_t _size);
 size_t		elf_ndxscn(Elf_Scn *_scn);
@@ -215,11 +261,14 @@ Elf_Scn		*elf_newscn(Elf *_elf);
 Elf_Scn		*elf_nextscn(Elf *_elf, Elf_Scn *_scn);
 Elf_Cmd		elf_next(Elf *_elf);
 Elf		*elf_open(int _fd);
+Elf		*elf_open_slice(int _fd, off_t _offset, size_t _size);
 Elf		*elf_openmemory(char *_image, size_t _size);
 off_t		elf_rand(Elf *_elf, off_t _off);
 Elf_Data	*elf_rawdata(Elf_Scn *_scn, Elf_Data *_data);
 char		*elf_rawfile(Elf *_elf, size_t *_size);
+size_t		elf_setcachelimit(size_t _limit);
 int		elf_setshstrndx(Elf *_elf, size_t _shnum);
+Elf		*elf_stream(int _fd, Elf_Stream_Handler *_handler, void *_arg);
 char		*elf_strptr(Elf *_elf, size_t _section, size_t _offset);
 off_t		elf_update(Elf *_elf, Elf_Cmd _cmd);
 unsigned int	elf_version(unsigned int _version);
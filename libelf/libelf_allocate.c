@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <libelf.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -38,16 +39,151 @@
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Section and data descriptors are allocated from arenas belonging to
+ * their ELF descriptor, so that opening and closing an object costs a
+ * handful of calls to malloc() instead of several per section.  The
+ * descriptor's lock serializes access to its arenas.
+ *
+ * Arena chunks come in a few power-of-two sizes, growing with the
+ * number of chunks in the arena.  Released chunks are kept in a small
+ * process-wide cache, so that a program that opens and closes many
+ * objects in turn reuses the same memory instead of having malloc(3)
+ * return it to the system and fault it back in each time.
+ */
+
+#define	LIBELF_CHUNK_MINSHIFT	11	/* smallest chunk is 2KB */
+#define	LIBELF_CHUNK_NCLASSES	5	/* largest chunk is 32KB */
+#define	LIBELF_CHUNK_NCACHED	8	/* max cached chunks per size */
+
+#define	LIBELF_CHUNK_SIZE(C)	((size_t) 1 << (LIBELF_CHUNK_MINSHIFT + (C)))
+
+union _Libelf_Chunk {
+	struct {
+		union _Libelf_Chunk *c_next;
+		unsigned int	c_class; /* chunk size class */
+	} c_hdr;
+	/* Keep the objects following the chunk header aligned. */
+	uint64_t	c_align64;
+	long double	c_alignld;
+	void		*c_alignptr;
+};
+
+static struct {
+	union _Libelf_Chunk *cc_chunks;
+	unsigned int	cc_count;
+} _libelf_chunk_cache[LIBELF_CHUNK_NCLASSES];
+static pthread_mutex_t _libelf_chunk_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *
+_libelf_arena_alloc(struct _Libelf_Arena *a, size_t objsize)
+{
+	union _Libelf_Chunk *c;
+	unsigned int cl;
+	void *p;
+
+	if ((p = a->a_free) != NULL)
+		a->a_free = *(void **) p;
+	else {
+		if (a->a_avail == 0) {
+			cl = a->a_nchunks < LIBELF_CHUNK_NCLASSES ?
+			    a->a_nchunks : LIBELF_CHUNK_NCLASSES - 1;
+
+			(void) pthread_mutex_lock(&_libelf_chunk_cache_lock);
+			if ((c = _libelf_chunk_cache[cl].cc_chunks) != NULL) {
+				_libelf_chunk_cache[cl].cc_chunks =
+				    c->c_hdr.c_next;
+				_libelf_chunk_cache[cl].cc_count--;
+			}
+			(void) pthread_mutex_unlock(&_libelf_chunk_cache_lock);
+
+			if (c == NULL &&
+			    (c = malloc(LIBELF_CHUNK_SIZE(cl))) == NULL) {
+				LIBELF_SET_ERROR(RESOURCE, errno);
+				return (NULL);
+			}
+
+			c->c_hdr.c_next = a->a_chunks;
+			c->c_hdr.c_class = cl;
+			a->a_chunks = c;
+			a->a_nchunks++;
+			a->a_avail = (LIBELF_CHUNK_SIZE(cl) - sizeof(*c)) /
+			    objsize;
+			a->a_next = (unsigned char *) (c + 1);
+
+			assert(a->a_avail > 0);
+		}
+
+		p = a->a_next;
+		a->a_next += objsize;
+		a->a_avail--;
+	}
+
+	(void) memset(p, 0, objsize);
+
+	return (p);
+}
+
+static void
+_libelf_arena_free(struct _Libelf_Arena *a, void *p)
+{
+	*(void **) p = a->a_free;
+	a->a_free = p;
+}
+
+static void
+_libelf_arena_release(struct _Libelf_Arena *a)
+{
+	union _Libelf_Chunk *c, *tc;
+	unsigned int cl;
+
+	if (a->a_chunks == NULL)
+		return;
+
+	(void) pthread_mutex_lock(&_libelf_chunk_cache_lock);
+	for (c = a->a_chunks; c != NULL; c = tc) {
+		tc = c->c_hdr.c_next;
+		cl = c->c_hdr.c_class;
+		if (_libelf_chunk_cache[cl].cc_count < LIBELF_CHUNK_NCACHED) {
+			c->c_hdr.c_next = _libelf_chunk_cache[cl].cc_chunks;
+			_libelf_chunk_cache[cl].cc_chunks = c;
+			_libelf_chunk_cache[cl].cc_count++;
+		} else
+			free(c);
+	}
+	(void) pthread_mutex_unlock(&_libelf_chunk_cache_lock);
+
+	(void) memset(a, 0, sizeof(*a));
+}
+
 Elf *
 _libelf_allocate_elf(void)
 {
 	Elf *e;
+	int error;
+	pthread_mutexattr_t attr;
 
 	if ((e = calloc((size_t) 1, sizeof(*e))) == NULL) {
 		LIBELF_SET_ERROR(RESOURCE, errno);
 		return NULL;
 	}
 
+	if ((error = pthread_mutexattr_init(&attr)) != 0) {
+		free(e);
+		LIBELF_SET_ERROR(RESOURCE, error);
+		return NULL;
+	}
+
+	(void) pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	error = pthread_mutex_init(&e->e_lock, &attr);
+	(void) pthread_mutexattr_destroy(&attr);
+
+	if (error != 0) {
+		free(e);
+		LIBELF_SET_ERROR(RESOURCE, error);
+		return NULL;
+	}
+
 	e->e_activations = 1;
 	e->e_byteorder   = ELFDATANONE;
 	e->e_class       = ELFCLASSNONE;
@@ -84,6 +220,7 @@ _libelf_release_elf(Elf *e)
 	switch (e->e_kind) {
 	case ELF_K_AR:
 		free(e->e_u.e_ar.e_symtab);
+		free(e->e_u.e_ar.e_symhash);
 		break;
 
 	case ELF_K_ELF:
@@ -100,6 +237,11 @@ _libelf_release_elf(Elf *e)
 
 		assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
 
+		free(e->e_u.e_elf.e_scntab);
+
+		_libelf_arena_release(&e->e_u.e_elf.e_scnarena);
+		_libelf_arena_release(&e->e_u.e_elf.e_dataarena);
+
 		if (e->e_flags & LIBELF_F_AR_HEADER) {
 			arh = e->e_hdr.e_arhdr;
 			free(arh->ar_name);
@@ -113,6 +255,8 @@ _libelf_release_elf(Elf *e)
 		break;
 	}
 
+	(void) pthread_mutex_destroy(&e->e_lock);
+
 	free(e);
 }
 
@@ -121,10 +265,9 @@ _libelf_allocate_data(Elf_Scn *s)
 {
 	struct _Libelf_Data *d;
 
-	if ((d = calloc((size_t) 1, sizeof(*d))) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, 0);
+	if ((d = _libelf_arena_alloc(&s->s_elf->e_u.e_elf.e_dataarena,
+	    sizeof(*d))) == NULL)
 		return (NULL);
-	}
 
 	d->d_scn = s;
 
@@ -135,23 +278,67 @@ struct _Libelf_Data *
 _libelf_release_data(struct _Libelf_Data *d)
 {
 
+	if (d->d_flags & LIBELF_F_DATA_CACHED)
+		_libelf_cache_remove(d);
+
+	if (d->d_scn->s_strdata == d)
+		d->d_scn->s_strdata = NULL;
+
 	if (d->d_flags & LIBELF_F_DATA_MALLOCED)
 		free(d->d_data.d_buf);
 
-	free(d);
+	_libelf_arena_free(&d->d_scn->s_elf->e_u.e_elf.e_dataarena, d);
 
 	return (NULL);
 }
 
+/*
+ * Grow the table mapping section indices to section descriptors so
+ * that it can hold index `ndx'.
+ */
+static int
+_libelf_grow_scntab(Elf *e, size_t ndx)
+{
+	Elf_Scn **t;
+	size_t newsz, oldsz;
+
+	oldsz = e->e_u.e_elf.e_scntabsz;
+	if (ndx < oldsz)
+		return (1);
+
+	if (ndx >= SIZE_MAX / (2 * sizeof(*t))) {
+		LIBELF_SET_ERROR(RANGE, 0);
+		return (0);
+	}
+
+	for (newsz = oldsz > 0 ? oldsz : 16; newsz <= ndx; newsz *= 2)
+		;
+
+	if ((t = realloc(e->e_u.e_elf.e_scntab, newsz * sizeof(*t))) ==
+	    NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (0);
+	}
+
+	(void) memset(t + oldsz, 0, (newsz - oldsz) * sizeof(*t));
+
+	e->e_u.e_elf.e_scntab = t;
+	e->e_u.e_elf.e_scntabsz = newsz;
+
+	return (1);
+}
+
 Elf_Scn *
 _libelf_allocate_scn(Elf *e, size_t ndx)
 {
 	Elf_Scn *s;
 
-	if ((s = calloc((size_t) 1, sizeof(Elf_Scn))) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, errno);
+	if (_libelf_grow_scntab(e, ndx) == 0)
+		return (NULL);
+
+	if ((s = _libelf_arena_alloc(&e->e_u.e_elf.e_scnarena,
+	    sizeof(Elf_Scn))) == NULL)
 		return (NULL);
-	}
 
 	s->s_elf = e;
 	s->s_ndx = ndx;
@@ -161,6 +348,9 @@ _libelf_allocate_scn(Elf *e, size_t ndx)
 
 	STAILQ_INSERT_TAIL(&e->e_u.e_elf.e_scn, s, s_next);
 
+	assert(e->e_u.e_elf.e_scntab[ndx] == NULL);
+	e->e_u.e_elf.e_scntab[ndx] = s;
+
 	return (s);
 }
 
@@ -178,7 +368,8 @@ _libelf_release_scn(Elf_Scn *s)
 	}
 
 	STAILQ_FOREACH_SAFE(d, &s->s_rawdata, d_next, td) {
-		assert((d->d_flags & LIBELF_F_DATA_MALLOCED) == 0);
+		assert((d->d_flags & LIBELF_F_DATA_MALLOCED) == 0 ||
+		    (s->s_elf->e_flags & LIBELF_F_STREAM) != 0);
 		STAILQ_REMOVE(&s->s_rawdata, d, _Libelf_Data, d_next);
 		d = _libelf_release_data(d);
 	}
@@ -189,7 +380,11 @@ _libelf_release_scn(Elf_Scn *s)
 
 	STAILQ_REMOVE(&e->e_u.e_elf.e_scn, s, _Elf_Scn, s_next);
 
-	free(s);
+	assert(s->s_ndx < e->e_u.e_elf.e_scntabsz);
+	e->e_u.e_elf.e_scntab[s->s_ndx] = NULL;
+
+	free(s->s_zimage);
+	_libelf_arena_free(&e->e_u.e_elf.e_scnarena, s);
 
 	return (NULL);
 }
@@ -203,19 +203,22 @@ _libelf_ar_gethdr(Elf *e)
 	return (NULL);
 }
 
+/*
+ * Open the archive member whose header is at offset 'next' in archive
+ * 'elf'.  The archive's 'e_next' cursor is neither read nor updated,
+ * so distinct members may be opened concurrently.
+ */
 Elf *
-_libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf)
+_libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf, off_t next)
 {
 	Elf *e;
 	size_t nsz, sz;
-	off_t next, end;
+	off_t end;
 	struct ar_hdr *arh;
 	char *member, *namelen;
 
 	assert(elf->e_kind == ELF_K_AR);
 
-	next = elf->e_u.e_ar.e_next;
-
 	/*
 	 * `next' is only set to zero by elf_next() when the last
 	 * member of an archive is processed.
@@ -284,7 +287,9 @@ _libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf)
 	e->e_cmd = c;
 	e->e_hdr.e_rawhdr = (unsigned char *) arh;
 
+	LIBELF_LOCK(elf);
 	elf->e_u.e_ar.e_nchildren++;
+	LIBELF_UNLOCK(elf);
 	e->e_parent = elf;
 
 	return (e);
@@ -0,0 +1,174 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <libelf.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Vectorized byte swapping for arrays of fixed layout ELF types.
+ *
+ * A byte swap of an array of records is described by a permutation
+ * of a LIBELF_BSWAP_BLOCKSZ byte block: byte `i' of the output block
+ * is byte `perm[i]' of the input block.  The block size is a multiple
+ * of the file size of every ELF type handled here, so the same
+ * permutation applies to each block of the array.  As no field of
+ * these types straddles a 16 byte boundary, the permutation can be
+ * applied using the byte shuffle instructions of SSSE3 and AVX2,
+ * which operate on 16 byte lanes.
+ *
+ * The kernels below process whole blocks only and return the number
+ * of bytes converted; the caller is expected to convert any remaining
+ * records using the scalar code in "libelf_convert.m4".
+ */
+
+#if	(defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#define	LIBELF_BSWAP_X86	1
+#endif
+
+#if	LIBELF_BSWAP_X86
+
+#include <immintrin.h>
+
+/*
+ * Permute whole blocks using 16 byte vectors.  This helper is inlined
+ * into each kernel so that it uses the instruction encoding of the
+ * kernel's target.
+ */
+__attribute__((target("ssse3"), always_inline))
+static inline size_t
+_libelf_bswap_sse(unsigned char *dst, const unsigned char *src,
+    size_t sz, const unsigned char *perm)
+{
+	size_t n;
+	__m128i a, b, c, m0, m1, m2;
+
+	/* Shuffle indices are relative to the start of each lane. */
+	m0 = _mm_loadu_si128((const __m128i *) (const void *) perm);
+	m1 = _mm_sub_epi8(_mm_loadu_si128((const __m128i *) (const void *)
+	    (perm + 16)), _mm_set1_epi8(16));
+	m2 = _mm_sub_epi8(_mm_loadu_si128((const __m128i *) (const void *)
+	    (perm + 32)), _mm_set1_epi8(32));
+
+	for (n = 0; sz - n >= LIBELF_BSWAP_BLOCKSZ;
+	     n += LIBELF_BSWAP_BLOCKSZ) {
+		a = _mm_loadu_si128((const __m128i *) (const void *)
+		    (src + n));
+		b = _mm_loadu_si128((const __m128i *) (const void *)
+		    (src + n + 16));
+		c = _mm_loadu_si128((const __m128i *) (const void *)
+		    (src + n + 32));
+		_mm_storeu_si128((__m128i *) (void *) (dst + n),
+		    _mm_shuffle_epi8(a, m0));
+		_mm_storeu_si128((__m128i *) (void *) (dst + n + 16),
+		    _mm_shuffle_epi8(b, m1));
+		_mm_storeu_si128((__m128i *) (void *) (dst + n + 32),
+		    _mm_shuffle_epi8(c, m2));
+	}
+
+	return (n);
+}
+
+__attribute__((target("ssse3")))
+static size_t
+_libelf_bswap_ssse3(unsigned char *dst, const unsigned char *src,
+    size_t sz, const unsigned char *perm)
+{
+	return (_libelf_bswap_sse(dst, src, sz, perm));
+}
+
+/*
+ * The AVX2 kernel works on pairs of blocks, as three 32 byte vectors
+ * cover two of them.  The lanes of those vectors use the lane masks
+ * of a single block in the order (0,1), (2,0) and (1,2).
+ */
+__attribute__((target("avx2")))
+static size_t
+_libelf_bswap_avx2(unsigned char *dst, const unsigned char *src,
+    size_t sz, const unsigned char *perm)
+{
+	size_t n;
+	__m128i l0, l1, l2;
+	__m256i a, b, c, m0, m1, m2;
+
+	l0 = _mm_loadu_si128((const __m128i *) (const void *) perm);
+	l1 = _mm_sub_epi8(_mm_loadu_si128((const __m128i *) (const void *)
+	    (perm + 16)), _mm_set1_epi8(16));
+	l2 = _mm_sub_epi8(_mm_loadu_si128((const __m128i *) (const void *)
+	    (perm + 32)), _mm_set1_epi8(32));
+
+	m0 = _mm256_inserti128_si256(_mm256_castsi128_si256(l0), l1, 1);
+	m1 = _mm256_inserti128_si256(_mm256_castsi128_si256(l2), l0, 1);
+	m2 = _mm256_inserti128_si256(_mm256_castsi128_si256(l1), l2, 1);
+
+	for (n = 0; sz - n >= 2 * LIBELF_BSWAP_BLOCKSZ;
+	     n += 2 * LIBELF_BSWAP_BLOCKSZ) {
+		a = _mm256_loadu_si256((const __m256i *) (const void *)
+		    (src + n));
+		b = _mm256_loadu_si256((const __m256i *) (const void *)
+		    (src + n + 32));
+		c = _mm256_loadu_si256((const __m256i *) (const void *)
+		    (src + n + 64));
+		_mm256_storeu_si256((__m256i *) (void *) (dst + n),
+		    _mm256_shuffle_epi8(a, m0));
+		_mm256_storeu_si256((__m256i *) (void *) (dst + n + 32),
+		    _mm256_shuffle_epi8(b, m1));
+		_mm256_storeu_si256((__m256i *) (void *) (dst + n + 64),
+		    _mm256_shuffle_epi8(c, m2));
+	}
+
+	/* Handle any remaining whole block. */
+	n += _libelf_bswap_sse(dst + n, src + n, sz - n, perm);
+
+	/* Avoid SSE/AVX transition penalties in our caller. */
+	_mm256_zeroupper();
+
+	return (n);
+}
+
+#endif	/* LIBELF_BSWAP_X86 */
+
+/*
+ * Return the best byte swapping kernel supported by the CPU that we
+ * are running on, or NULL if only the scalar converters may be used.
+ * The result is cached by the caller.
+ */
+_libelf_bswap_function *
+_libelf_get_bswap_kernel(void)
+{
+#if	LIBELF_BSWAP_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return (_libelf_bswap_avx2);
+	if (__builtin_cpu_supports("ssse3"))
+		return (_libelf_bswap_ssse3);
+#endif
+	return (NULL);
+}
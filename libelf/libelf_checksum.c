@@ -25,23 +25,123 @@
  */
 
 #include <gelf.h>
+#include <stdint.h>
 
 #include "_libelf.h"
 
 ELFTC_VCSID("$Id$");
 
-static unsigned long
-_libelf_sum(unsigned long c, const unsigned char *s, size_t size)
+/*
+ * Byte summation kernels.
+ *
+ * The checksum is the sum of the bytes of the sections covered,
+ * modulo the range of an `unsigned long'.  The vectorized kernels
+ * below use the `sum of absolute differences' instructions of SSE2
+ * and AVX2 against a zero vector, which add up groups of 8 bytes into
+ * 64 bit lanes.
+ */
+
+typedef uint64_t _libelf_sum_function(const unsigned char *_s, size_t _sz);
+
+static uint64_t
+_libelf_sum_scalar(const unsigned char *s, size_t sz)
 {
-	if (s == NULL || size == 0)
-		return (c);
+	uint64_t c;
 
-	while (size--)
+	for (c = 0; sz > 0; sz--)
 		c += *s++;
 
 	return (c);
 }
 
+#if	(defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#define	LIBELF_CHECKSUM_X86	1
+#endif
+
+#if	LIBELF_CHECKSUM_X86
+
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+static uint64_t
+_libelf_sum_sse2(const unsigned char *s, size_t sz)
+{
+	size_t n;
+	uint64_t lanes[2];
+	__m128i a, b, z;
+
+	z = _mm_setzero_si128();
+	a = b = z;
+
+	for (n = 0; sz - n >= 32; n += 32) {
+		a = _mm_add_epi64(a, _mm_sad_epu8(_mm_loadu_si128(
+		    (const __m128i *) (const void *) (s + n)), z));
+		b = _mm_add_epi64(b, _mm_sad_epu8(_mm_loadu_si128(
+		    (const __m128i *) (const void *) (s + n + 16)), z));
+	}
+
+	_mm_storeu_si128((__m128i *) (void *) lanes, _mm_add_epi64(a, b));
+
+	return (lanes[0] + lanes[1] + _libelf_sum_scalar(s + n, sz - n));
+}
+
+__attribute__((target("avx2")))
+static uint64_t
+_libelf_sum_avx2(const unsigned char *s, size_t sz)
+{
+	size_t n;
+	uint64_t lanes[4];
+	__m256i a, b, z;
+
+	z = _mm256_setzero_si256();
+	a = b = z;
+
+	for (n = 0; sz - n >= 64; n += 64) {
+		a = _mm256_add_epi64(a, _mm256_sad_epu8(_mm256_loadu_si256(
+		    (const __m256i *) (const void *) (s + n)), z));
+		b = _mm256_add_epi64(b, _mm256_sad_epu8(_mm256_loadu_si256(
+		    (const __m256i *) (const void *) (s + n + 32)), z));
+	}
+
+	_mm256_storeu_si256((__m256i *) (void *) lanes,
+	    _mm256_add_epi64(a, b));
+
+	/* Avoid SSE/AVX transition penalties in our caller. */
+	_mm256_zeroupper();
+
+	return (lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+	    _libelf_sum_scalar(s + n, sz - n));
+}
+
+#endif	/* LIBELF_CHECKSUM_X86 */
+
+/*
+ * Return the best summation kernel supported by the CPU that we are
+ * running on.
+ */
+static _libelf_sum_function *
+_libelf_get_sum_kernel(void)
+{
+#if	LIBELF_CHECKSUM_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return (_libelf_sum_avx2);
+	if (__builtin_cpu_supports("sse2"))
+		return (_libelf_sum_sse2);
+#endif
+	return (_libelf_sum_scalar);
+}
+
+static unsigned long
+_libelf_sum(_libelf_sum_function *kernel, unsigned long c,
+    const unsigned char *s, size_t size)
+{
+	if (s == NULL || size == 0)
+		return (c);
+
+	return (c + (unsigned long) (*kernel)(s, size));
+}
+
 long
 _libelf_checksum(Elf *e, int elfclass)
 {
@@ -51,6 +151,7 @@ _libelf_checksum(Elf *e, int elfclass)
 	unsigned long checksum;
 	GElf_Ehdr eh;
 	GElf_Shdr shdr;
+	_libelf_sum_function *kernel;
 
 	if (e == NULL) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
@@ -72,8 +173,13 @@ _libelf_checksum(Elf *e, int elfclass)
 	 * The first section is always SHN_UNDEF and can be skipped.
 	 * Non-allocatable sections are skipped, as are sections that
 	 * could be affected by utilities such as strip(1).
+	 *
+	 * Section contents are summed as they appear in the file, so
+	 * no translation is needed.
 	 */
 
+	kernel = _libelf_get_sum_kernel();
+
 	checksum = 0;
 	for (shn = 1; shn < e->e_u.e_elf.e_nscn; shn++) {
 		if ((scn = elf_getscn(e, shn)) == NULL)
@@ -87,7 +193,7 @@ _libelf_checksum(Elf *e, int elfclass)
 
 		d = NULL;
 		while ((d = elf_rawdata(scn, d)) != NULL)
-			checksum = _libelf_sum(checksum,
+			checksum = _libelf_sum(kernel, checksum,
 			    (unsigned char *) d->d_buf, (size_t) d->d_size);
 	}
 
@@ -0,0 +1,474 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/param.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <libelf.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define	ZLIB_CONST
+#include <zlib.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Support for sections whose contents are stored compressed in the
+ * file.  Two formats are understood:
+ *
+ * - Sections with the SHF_COMPRESSED flag set, whose contents start
+ *   with an Elf32_Chdr or Elf64_Chdr header in the byte order of the
+ *   file, followed by a zlib stream.
+ *
+ * - The older GNU format used for ".zdebug*" sections, whose contents
+ *   start with the four bytes "ZLIB" and the uncompressed size as an
+ *   eight byte big-endian value, followed by a zlib stream.
+ */
+
+#define	LIBELF_CHDR32_SIZE	12
+#define	LIBELF_CHDR64_SIZE	24
+#define	LIBELF_ZDEBUG_MAGIC	"ZLIB"
+#define	LIBELF_ZDEBUG_PREFIX	".zdebug"
+#define	LIBELF_ZDEBUG_SIZE	12
+
+static uint64_t
+_libelf_get_word(const unsigned char *p, size_t sz, int msb)
+{
+	size_t i;
+	uint64_t v;
+
+	v = 0;
+	for (i = 0; i < sz; i++)
+		v |= (uint64_t) p[msb ? i : sz - i - 1] << (8 * (sz - i - 1));
+
+	return (v);
+}
+
+static void
+_libelf_put_word(unsigned char *p, size_t sz, uint64_t v, int msb)
+{
+	size_t i;
+
+	for (i = 0; i < sz; i++)
+		p[msb ? sz - i - 1 : i] = (unsigned char) (v >> (8 * i));
+}
+
+/*
+ * Return the size of the header that precedes the compressed stream.
+ */
+static size_t
+_libelf_compression_hdrsz(int ctype, int elfclass)
+{
+	if (ctype == LIBELF_COMPRESS_GNU)
+		return (LIBELF_ZDEBUG_SIZE);
+
+	assert(ctype == LIBELF_COMPRESS_CHDR);
+
+	return (elfclass == ELFCLASS32 ? LIBELF_CHDR32_SIZE :
+	    LIBELF_CHDR64_SIZE);
+}
+
+/*
+ * Return the file alignment of a section stored in format `ctype'.
+ */
+uint64_t
+_libelf_compression_align(int ctype, int elfclass)
+{
+	if (ctype == LIBELF_COMPRESS_GNU)
+		return (1);
+
+	return (elfclass == ELFCLASS32 ? 4 : 8);
+}
+
+/*
+ * Determine how the contents of section `s' are stored in the file
+ * underlying its ELF descriptor.  The caller holds the lock for the
+ * section's ELF descriptor.
+ */
+int
+_libelf_compression_type(Elf_Scn *s)
+{
+	Elf *e;
+	int error;
+	const char *name;
+	const unsigned char *src;
+	uint64_t sh_flags, sh_offset, sh_size;
+	uint32_t sh_name, sh_type;
+
+	e = s->s_elf;
+
+	if (e->e_class == ELFCLASS32) {
+		sh_flags  = (uint64_t) s->s_shdr.s_shdr32.sh_flags;
+		sh_name   = s->s_shdr.s_shdr32.sh_name;
+		sh_offset = (uint64_t) s->s_shdr.s_shdr32.sh_offset;
+		sh_size   = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+		sh_type   = s->s_shdr.s_shdr32.sh_type;
+	} else {
+		sh_flags  = s->s_shdr.s_shdr64.sh_flags;
+		sh_name   = s->s_shdr.s_shdr64.sh_name;
+		sh_offset = s->s_shdr.s_shdr64.sh_offset;
+		sh_size   = s->s_shdr.s_shdr64.sh_size;
+		sh_type   = s->s_shdr.s_shdr64.sh_type;
+	}
+
+	if (sh_type == SHT_NULL || sh_type == SHT_NOBITS)
+		return (LIBELF_COMPRESS_NONE);
+
+	if (sh_flags & SHF_COMPRESSED)
+		return (LIBELF_COMPRESS_CHDR);
+
+	if (sh_type != SHT_PROGBITS || (sh_flags & SHF_ALLOC) ||
+	    sh_size < LIBELF_ZDEBUG_SIZE ||
+	    e->e_u.e_elf.e_strndx == 0 ||
+	    e->e_u.e_elf.e_strndx == s->s_ndx)
+		return (LIBELF_COMPRESS_NONE);
+
+	/*
+	 * Look at the name of the section only if its contents look
+	 * like those of a ".zdebug" section, so that sections in
+	 * the common case do not pay for a string table lookup.
+	 * Contents or names that are unavailable are not an error
+	 * here; keep any pending error.
+	 */
+	error = LIBELF_THREAD_PRIVATE(error);
+	if ((src = _libelf_rawbytes(e, sh_offset,
+	    sizeof(LIBELF_ZDEBUG_MAGIC) - 1)) == NULL ||
+	    memcmp(src, LIBELF_ZDEBUG_MAGIC,
+		sizeof(LIBELF_ZDEBUG_MAGIC) - 1) != 0) {
+		LIBELF_THREAD_PRIVATE(error) = error;
+		return (LIBELF_COMPRESS_NONE);
+	}
+
+	if ((name = elf_strptr(e, e->e_u.e_elf.e_strndx, sh_name)) == NULL) {
+		LIBELF_THREAD_PRIVATE(error) = error;
+		return (LIBELF_COMPRESS_NONE);
+	}
+
+	return (strncmp(name, LIBELF_ZDEBUG_PREFIX,
+	    sizeof(LIBELF_ZDEBUG_PREFIX) - 1) == 0 ? LIBELF_COMPRESS_GNU :
+	    LIBELF_COMPRESS_NONE);
+}
+
+/*
+ * Inflate the zlib stream at `src' into exactly `dsz' bytes at `dst'.
+ */
+static int
+_libelf_inflate(unsigned char *dst, size_t dsz, const unsigned char *src,
+    size_t ssz)
+{
+	int rc;
+	size_t n;
+	z_stream zs;
+
+	(void) memset(&zs, 0, sizeof(zs));
+
+	if (inflateInit(&zs) != Z_OK) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	zs.next_in = src;
+	zs.next_out = dst;
+
+	/* zlib counts in units of `uInt', so feed it in pieces. */
+	do {
+		if (zs.avail_in == 0 && ssz > 0) {
+			n = MIN(ssz, UINT_MAX);
+			zs.avail_in = (uInt) n;
+			ssz -= n;
+		}
+		if (zs.avail_out == 0 && dsz > 0) {
+			n = MIN(dsz, UINT_MAX);
+			zs.avail_out = (uInt) n;
+			dsz -= n;
+		}
+		rc = inflate(&zs, Z_NO_FLUSH);
+	} while (rc == Z_OK);
+
+	(void) inflateEnd(&zs);
+
+	if (rc != Z_STREAM_END || zs.avail_out != 0 || dsz != 0) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (0);
+	}
+
+	return (1);
+}
+
+/*
+ * Return a malloc'ed buffer holding the file representation of the
+ * uncompressed contents of section `s', stored in format `ctype'.
+ * The size and the alignment of the uncompressed contents are
+ * returned in `*size' and `*align'.  The caller holds the lock for
+ * the section's ELF descriptor.
+ */
+unsigned char *
+_libelf_inflate_scn(Elf_Scn *s, int ctype, uint64_t *size, uint64_t *align)
+{
+	Elf *e;
+	int ec, msb;
+	size_t hdrsz;
+	unsigned char *buf;
+	const unsigned char *src;
+	uint64_t ch_addralign, ch_size, ch_type, sh_align, sh_offset, sh_size;
+
+	e = s->s_elf;
+	ec = e->e_class;
+	msb = e->e_byteorder == ELFDATA2MSB;
+
+	if (ec == ELFCLASS32) {
+		sh_offset = (uint64_t) s->s_shdr.s_shdr32.sh_offset;
+		sh_size   = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+		sh_align  = (uint64_t) s->s_shdr.s_shdr32.sh_addralign;
+	} else {
+		sh_offset = s->s_shdr.s_shdr64.sh_offset;
+		sh_size   = s->s_shdr.s_shdr64.sh_size;
+		sh_align  = s->s_shdr.s_shdr64.sh_addralign;
+	}
+
+	hdrsz = _libelf_compression_hdrsz(ctype, ec);
+	if (sh_size < hdrsz) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (NULL);
+	}
+
+	if ((src = _libelf_rawbytes(e, sh_offset, sh_size)) == NULL)
+		return (NULL);
+
+	if (ctype == LIBELF_COMPRESS_GNU) {
+		ch_type = ELFCOMPRESS_ZLIB;
+		ch_size = _libelf_get_word(src + 4, 8, 1);
+		ch_addralign = sh_align;
+	} else if (ec == ELFCLASS32) {
+		ch_type = _libelf_get_word(src, 4, msb);
+		ch_size = _libelf_get_word(src + 4, 4, msb);
+		ch_addralign = _libelf_get_word(src + 8, 4, msb);
+	} else {
+		ch_type = _libelf_get_word(src, 4, msb);
+		ch_size = _libelf_get_word(src + 8, 8, msb);
+		ch_addralign = _libelf_get_word(src + 16, 8, msb);
+	}
+
+	if (ch_type != ELFCOMPRESS_ZLIB) {
+		LIBELF_SET_ERROR(UNIMPL, 0);
+		return (NULL);
+	}
+
+	if (ch_addralign == 0)
+		ch_addralign = 1;
+
+	if (ch_addralign & (ch_addralign - 1)) {
+		LIBELF_SET_ERROR(SECTION, 0);
+		return (NULL);
+	}
+
+	if (ch_size > SIZE_MAX) {
+		LIBELF_SET_ERROR(RANGE, 0);
+		return (NULL);
+	}
+
+	if ((buf = malloc(ch_size > 0 ? (size_t) ch_size : 1)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (NULL);
+	}
+
+	if (!_libelf_inflate(buf, (size_t) ch_size, src + hdrsz,
+	    (size_t) (sh_size - hdrsz))) {
+		free(buf);
+		return (NULL);
+	}
+
+	*size = ch_size;
+	*align = ch_addralign;
+
+	return (buf);
+}
+
+/*
+ * Deflate `ssz' bytes at `src' into the `dcap' byte buffer at `dst'.
+ * The size of the compressed stream is returned in `*dsz'.
+ */
+static int
+_libelf_deflate(unsigned char *dst, size_t dcap, size_t *dsz,
+    const unsigned char *src, size_t ssz)
+{
+	int rc;
+	size_t n;
+	z_stream zs;
+
+	(void) memset(&zs, 0, sizeof(zs));
+
+	if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	zs.next_in = src;
+	zs.next_out = dst;
+
+	do {
+		if (zs.avail_in == 0 && ssz > 0) {
+			n = MIN(ssz, UINT_MAX);
+			zs.avail_in = (uInt) n;
+			ssz -= n;
+		}
+		if (zs.avail_out == 0 && dcap > 0) {
+			n = MIN(dcap, UINT_MAX);
+			zs.avail_out = (uInt) n;
+			dcap -= n;
+		}
+		rc = deflate(&zs, ssz > 0 ? Z_NO_FLUSH : Z_FINISH);
+	} while (rc == Z_OK);
+
+	*dsz = (size_t) (zs.next_out - dst);
+
+	(void) deflateEnd(&zs);
+
+	if (rc != Z_STREAM_END) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	return (1);
+}
+
+/*
+ * Build the compressed image of section `s' for elf_update(), from
+ * the section's data descriptors.  Argument `size' is the size of the
+ * section's uncompressed file representation, and `align' is its
+ * alignment.  The data descriptors are expected to have been laid
+ * out.  The caller holds the lock for the section's ELF descriptor.
+ */
+int
+_libelf_compress_scn(Elf_Scn *s, uint64_t size, uint64_t align)
+{
+	Elf *e;
+	Elf_Data *d, dst;
+	struct _Libelf_Data *ld;
+	unsigned char *image, *z;
+	int ctype, ec, em, msb;
+	size_t hdrsz, msz, zsz;
+
+	e = s->s_elf;
+	ec = e->e_class;
+	em = _libelf_elfmachine(e);
+	ctype = s->s_ctype;
+	msb = e->e_byteorder == ELFDATA2MSB;
+
+	assert(ctype == LIBELF_COMPRESS_CHDR || ctype == LIBELF_COMPRESS_GNU);
+
+	free(s->s_zimage);
+	s->s_zimage = NULL;
+	s->s_zsize = 0;
+
+	if (size > SIZE_MAX || size > ULONG_MAX ||
+	    (ec == ELFCLASS32 && (size > UINT32_MAX || align > UINT32_MAX))) {
+		LIBELF_SET_ERROR(RANGE, 0);
+		return (0);
+	}
+
+	/*
+	 * Assemble the file representation of the section's contents.
+	 */
+	if ((image = malloc(size > 0 ? (size_t) size : 1)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (0);
+	}
+
+	(void) memset(image, LIBELF_PRIVATE(fillchar), (size_t) size);
+
+	dst.d_version = e->e_version;
+
+	STAILQ_FOREACH(ld, &s->s_data, d_next) {
+		d = &ld->d_data;
+
+		if (d->d_buf == NULL || d->d_size == 0)
+			continue;
+
+		msz = _libelf_msize(d->d_type, ec, e->e_version);
+		assert(msz > 0 && d->d_size % msz == 0);
+
+		dst.d_buf = image + d->d_off;
+		dst.d_size = _libelf_fsize(d->d_type, ec, e->e_version,
+		    (size_t) (d->d_size / msz));
+
+		assert(d->d_off + dst.d_size <= size);
+
+		if (_libelf_xlate(&dst, d, e->e_byteorder, ec, em,
+		    ELF_TOFILE) == NULL)
+			goto error;
+	}
+
+	/*
+	 * Compress it, after space for the compression header.
+	 */
+	hdrsz = _libelf_compression_hdrsz(ctype, ec);
+	zsz = compressBound((uLong) size);
+
+	if ((z = malloc(hdrsz + zsz)) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		goto error;
+	}
+
+	if (ctype == LIBELF_COMPRESS_GNU) {
+		(void) memcpy(z, LIBELF_ZDEBUG_MAGIC,
+		    sizeof(LIBELF_ZDEBUG_MAGIC) - 1);
+		_libelf_put_word(z + 4, 8, size, 1);
+	} else if (ec == ELFCLASS32) {
+		_libelf_put_word(z, 4, ELFCOMPRESS_ZLIB, msb);
+		_libelf_put_word(z + 4, 4, size, msb);
+		_libelf_put_word(z + 8, 4, align, msb);
+	} else {
+		_libelf_put_word(z, 4, ELFCOMPRESS_ZLIB, msb);
+		_libelf_put_word(z + 4, 4, 0, msb);
+		_libelf_put_word(z + 8, 8, size, msb);
+		_libelf_put_word(z + 16, 8, align, msb);
+	}
+
+	if (!_libelf_deflate(z + hdrsz, zsz, &zsz, image, (size_t) size)) {
+		free(z);
+		goto error;
+	}
+
+	free(image);
+
+	s->s_zimage = z;
+	s->s_zsize = hdrsz + zsz;
+
+	return (1);
+
+error:
+	free(image);
+	return (0);
+}
@@ -524,6 +524,78 @@ _libelf_cvt_$1$5_tom(unsigned char *dst, size_t dsz, unsigned char *src,
 	return (1);
 }')
 
+#
+# Vectorized byte swapping.
+#
+
+# BSWAP_TYPE_LIST -- ELF types with a fixed layout whose file and
+# memory representations coincide, together with the byte swapping
+# permutations to use for each ELF class.  A permutation of `-'
+# denotes a type that does not exist in that ELF class.
+define(`BSWAP_TYPE_LIST',
+	``ADDR,		_libelf_bswap_word,	_libelf_bswap_quad',
+	`DYN,		_libelf_bswap_word,	_libelf_bswap_quad',
+	`HALF,		_libelf_bswap_half,	_libelf_bswap_half',
+	`LWORD,		_libelf_bswap_quad,	_libelf_bswap_quad',
+	`OFF,		_libelf_bswap_word,	_libelf_bswap_quad',
+	`REL,		_libelf_bswap_word,	_libelf_bswap_quad',
+	`RELA,		_libelf_bswap_word,	_libelf_bswap_quad',
+	`SWORD,		_libelf_bswap_word,	_libelf_bswap_word',
+	`SXWORD,	-,			_libelf_bswap_quad',
+	`SYM,		_libelf_bswap_sym32,	_libelf_bswap_sym64',
+	`WORD,		_libelf_bswap_word,	_libelf_bswap_word',
+	`XWORD,		-,			_libelf_bswap_quad',
+	`_,		_,			_'')
+
+# SCALAR_CONV(ELFTYPE,SIZE) -- The name prefix of the scalar converters.
+define(`SCALAR_CONV',
+  `ifdef(`PRIM_'$1,
+    `ifdef(`SIZEDEP_'$1,`_libelf_cvt_$1$2',`_libelf_cvt_$1')',
+    `_libelf_cvt_$1$2')')
+
+# MAKEBSWAPFUNC(ELFTYPE,SIZE,PERM,DIRECTION) -- Generate a converter
+# that hands whole blocks to the vectorized kernel and the remaining
+# elements to the scalar converter.
+define(`MAKEBSWAPFUNC',`
+static int
+_libelf_cvt_$1$2_$4_bswap(unsigned char *dst, size_t dsz,
+    unsigned char *src, size_t count, int byteswap)
+{
+	return (_libelf_cvt_bswap(dst, dsz, src, count, byteswap,
+	    elf$2_fsize(ELF_T_$1, (size_t) 1, EV_CURRENT),
+	    $3, SCALAR_CONV($1,$2)_$4));
+}')
+
+# MAKEBSWAPFUNCS(ELFTYPE,PERM32,PERM64)
+define(`MAKEBSWAPFUNCS',
+  `ifelse($2,`-',`',`MAKEBSWAPFUNC($1,32,$2,tof)MAKEBSWAPFUNC($1,32,$2,tom)')dnl
+MAKEBSWAPFUNC($1,64,$3,tof)MAKEBSWAPFUNC($1,64,$3,tom)')
+
+# MAKE_BSWAP_CONVERTERS(BSWAPTYPELIST) -- Generate conversion functions.
+define(`MAKE_BSWAP_CONVERTERS',
+  `ifelse($#,1,`',
+    `MAKEBSWAPFUNCS($1)MAKE_BSWAP_CONVERTERS(shift($@))')')
+
+# BSWAP_CONV(ELFTYPE,SIZE,PERM,DIRECTION)
+define(`BSWAP_CONV',
+  `ifelse($3,`-',`.$4$2 = NULL',`.$4$2 = _libelf_cvt_$1$2_$4_bswap')')
+
+# BSWAP_CONVERTER_NAME(ELFTYPE,PERM32,PERM64)
+define(`BSWAP_CONVERTER_NAME',
+  `	[ELF_T_$1] = {
+		BSWAP_CONV($1,32,$2,tof),
+		BSWAP_CONV($1,32,$2,tom),
+		BSWAP_CONV($1,64,$3,tof),
+		BSWAP_CONV($1,64,$3,tom)
+	},
+
+')
+
+# BSWAP_CONVERTER_NAMES(BSWAPTYPELIST)
+define(`BSWAP_CONVERTER_NAMES',
+  `ifelse($#,1,`',
+    `BSWAP_CONVERTER_NAME($1)BSWAP_CONVERTER_NAMES(shift($@))')')
+
 divert(0)
 
 /*
@@ -1036,6 +1108,86 @@ _libelf_cvt_NOTE_tof(unsigned char *dst, size_t dsz, unsigned char *src,
 	return (1);
 }
 
+/*
+ * Byte swapping permutations used by the vectorized converters, one
+ * LIBELF_BSWAP_BLOCKSZ sized block each.  See "libelf_bswap.c".
+ */
+
+#define	_P2(B)		(B) + 1, (B)
+#define	_P4(B)		(B) + 3, (B) + 2, (B) + 1, (B)
+#define	_P8(B)		_P4((B) + 4), _P4(B)
+#define	_P8_2(B)	_P2(B), _P2((B) + 2), _P2((B) + 4), _P2((B) + 6)
+#define	_P16_4(B)	_P4(B), _P4((B) + 4), _P4((B) + 8), _P4((B) + 12)
+#define	_P_SYM32(B)	_P4(B), _P4((B) + 4), _P4((B) + 8), (B) + 12,	\
+			(B) + 13, _P2((B) + 14)
+#define	_P_SYM64(B)	_P4(B), (B) + 4, (B) + 5, _P2((B) + 6),		\
+			_P8((B) + 8), _P8((B) + 16)
+
+static const unsigned char _libelf_bswap_half[LIBELF_BSWAP_BLOCKSZ] = {
+	_P8_2(0), _P8_2(8), _P8_2(16), _P8_2(24), _P8_2(32), _P8_2(40)
+};
+
+static const unsigned char _libelf_bswap_word[LIBELF_BSWAP_BLOCKSZ] = {
+	_P16_4(0), _P16_4(16), _P16_4(32)
+};
+
+static const unsigned char _libelf_bswap_quad[LIBELF_BSWAP_BLOCKSZ] = {
+	_P8(0), _P8(8), _P8(16), _P8(24), _P8(32), _P8(40)
+};
+
+static const unsigned char _libelf_bswap_sym32[LIBELF_BSWAP_BLOCKSZ] = {
+	_P_SYM32(0), _P_SYM32(16), _P_SYM32(32)
+};
+
+static const unsigned char _libelf_bswap_sym64[LIBELF_BSWAP_BLOCKSZ] = {
+	_P_SYM64(0), _P_SYM64(24)
+};
+
+/*
+ * The byte swapping kernel for the CPU that we are running on, chosen
+ * once by _libelf_get_translator().  The vectorized converters are
+ * only handed out when this is not NULL.
+ */
+static pthread_once_t _libelf_bswap_once = PTHREAD_ONCE_INIT;
+static _libelf_bswap_function *_libelf_bswap_kernel;
+
+static void
+_libelf_init_bswap_kernel(void)
+{
+	_libelf_bswap_kernel = _libelf_get_bswap_kernel();
+}
+
+/*
+ * Convert `count' elements of size `fsz' using the vectorized byte
+ * swapping kernel for as many whole blocks as possible, and the scalar
+ * converter `scalar' for the rest.
+ */
+static int
+_libelf_cvt_bswap(unsigned char *dst, size_t dsz, unsigned char *src,
+    size_t count, int byteswap, size_t fsz, const unsigned char *perm,
+    _libelf_translator_function *scalar)
+{
+	size_t n;
+
+	assert(_libelf_bswap_kernel != NULL);
+
+	n = 0;
+	if (byteswap && dsz >= count * fsz)
+		n = (*_libelf_bswap_kernel)(dst, src, count * fsz, perm);
+
+	if (n == count * fsz)
+		return (1);
+
+	assert(n % fsz == 0);
+
+	return ((*scalar)(dst + n, dsz - n, src + n, count - n / fsz,
+	    byteswap));
+}
+
+/*[*/
+MAKE_BSWAP_CONVERTERS(BSWAP_TYPE_LIST)
+/*]*/
+
 struct converters {
 	int	(*tof32)(unsigned char *dst, size_t dsz, unsigned char *src,
 		    size_t cnt, int byteswap);
@@ -1072,6 +1224,15 @@ CONVERTER_NAMES(ELF_TYPE_LIST)
 	}
 };
 
+/*
+ * Converters using the vectorized byte swapping kernels.
+ */
+static struct converters cvt_bswap[ELF_T_NUM] = {
+	/*[*/
+BSWAP_CONVERTER_NAMES(BSWAP_TYPE_LIST)
+	/*]*/
+};
+
 /*
  * Return a translator function for the specified ELF section type, conversion
  * direction, ELF class and ELF machine.
@@ -1079,6 +1240,8 @@ CONVERTER_NAMES(ELF_TYPE_LIST)
 _libelf_translator_function *
 _libelf_get_translator(Elf_Type t, int direction, int elfclass, int elfmachine)
 {
+	struct converters *cv;
+
 	assert(elfclass == ELFCLASS32 || elfclass == ELFCLASS64);
 	assert(direction == ELF_TOFILE || direction == ELF_TOMEMORY);
 	assert(t >= ELF_T_FIRST && t <= ELF_T_LAST);
@@ -1086,7 +1249,16 @@ _libelf_get_translator(Elf_Type t, int direction, int elfclass, int elfmachine)
 	/* TODO: Handle MIPS64 REL{,A} sections (ticket #559). */
 	(void) elfmachine;
 
+	/*
+	 * Prefer the vectorized converters if the CPU supports them.
+	 */
+	(void) pthread_once(&_libelf_bswap_once, _libelf_init_bswap_kernel);
+	if (cvt_bswap[t].tof64 != NULL && _libelf_bswap_kernel != NULL)
+		cv = &cvt_bswap[t];
+	else
+		cv = &cvt[t];
+
 	return ((elfclass == ELFCLASS32) ?
-	    (direction == ELF_TOFILE ? cvt[t].tof32 : cvt[t].tom32) :
-	    (direction == ELF_TOFILE ? cvt[t].tof64 : cvt[t].tom64));
+	    (direction == ELF_TOFILE ? cv->tof32 : cv->tom32) :
+	    (direction == ELF_TOFILE ? cv->tof64 : cv->tom64));
 }
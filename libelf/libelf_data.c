@@ -24,6 +24,7 @@
  * SUCH DAMAGE.
  */
 
+#include <assert.h>
 #include <libelf.h>
 
 #include "_libelf.h"
@@ -105,3 +106,92 @@ _libelf_xlate_shtype(uint32_t sht)
 		return (-1);
 	}
 }
+
+/*
+ * Validate a request for entries [first, first + count) of type 't'
+ * held in data descriptor 'ed', for use by the gelf_get*s() family.
+ *
+ * On success, return a pointer to the first requested entry in memory
+ * and set '*elfclass' to the class of the containing ELF object.
+ */
+void *
+_libelf_getrange(Elf_Data *ed, Elf_Type t, size_t first, size_t count,
+    void *dst, int *elfclass)
+{
+	int ec;
+	Elf *e;
+	size_t msz, nent;
+	Elf_Scn *scn;
+	uint32_t sh_type;
+	struct _Libelf_Data *d;
+
+	d = (struct _Libelf_Data *) ed;
+
+	if (d == NULL || dst == NULL ||
+	    (scn = d->d_scn) == NULL ||
+	    (e = scn->s_elf) == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	ec = e->e_class;
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (ec == ELFCLASS32)
+		sh_type = scn->s_shdr.s_shdr32.sh_type;
+	else
+		sh_type = scn->s_shdr.s_shdr64.sh_type;
+
+	if (_libelf_xlate_shtype(sh_type) != (int) t) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((msz = _libelf_msize(t, ec, e->e_version)) == 0)
+		return (NULL);
+
+	nent = d->d_data.d_size / msz;
+	if (first > nent || count > nent - first) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	*elfclass = ec;
+
+	return ((char *) d->d_data.d_buf + first * msz);
+}
+
+/*
+ * Return a pointer to the `sz' bytes at offset `off' in the file
+ * image of ELF descriptor `e'.  For objects read by elf_stream(3),
+ * only the contents of the section currently being handed to the
+ * application are available.
+ */
+unsigned char *
+_libelf_rawbytes(Elf *e, uint64_t off, uint64_t sz)
+{
+	uint64_t woff, wsz;
+
+	if ((e->e_flags & LIBELF_F_STREAM) == 0) {
+		if (off > (uint64_t) e->e_rawsize ||
+		    sz > (uint64_t) e->e_rawsize - off) {
+			LIBELF_SET_ERROR(SECTION, 0);
+			return (NULL);
+		}
+		return (e->e_rawfile + off);
+	}
+
+	/* Empty ranges need no contents. */
+	if (sz == 0)
+		return (e->e_rawfile);
+
+	woff = e->e_u.e_elf.e_windowoff;
+	wsz = (uint64_t) e->e_u.e_elf.e_windowsz;
+	if (e->e_u.e_elf.e_window == NULL || off < woff ||
+	    sz > wsz || off - woff > wsz - sz) {
+		LIBELF_SET_ERROR(SEQUENCE, 0);
+		return (NULL);
+	}
+
+	return (e->e_u.e_elf.e_window + (off - woff));
+}
@@ -102,8 +102,12 @@ _libelf_load_extended(Elf *e, int ec, uint64_t shoff, uint16_t phnum,
 		eh->e_version = LIBELF_PRIVATE(version);		\
 	} while (0)
 
-void *
-_libelf_ehdr(Elf *e, int ec, int allocate)
+/*
+ * Retrieve the ELF header, translating it in if needed.  The caller
+ * holds the descriptor's lock.
+ */
+static void *
+_libelf_get_ehdr(Elf *e, int ec, int allocate)
 {
 	void *ehdr;
 	size_t fsz, msz;
@@ -112,13 +116,6 @@ _libelf_ehdr(Elf *e, int ec, int allocate)
 	int (*xlator)(unsigned char *_d, size_t _dsz, unsigned char *_s,
 	    size_t _c, int _swap);
 
-	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
-
-	if (e == NULL || e->e_kind != ELF_K_ELF) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
-
 	if (e->e_class != ELFCLASSNONE && e->e_class != ec) {
 		LIBELF_SET_ERROR(CLASS, 0);
 		return (NULL);
@@ -210,3 +207,22 @@ _libelf_ehdr(Elf *e, int ec, int allocate)
 
 	return (ehdr);
 }
+
+void *
+_libelf_ehdr(Elf *e, int ec, int allocate)
+{
+	void *ehdr;
+
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (e == NULL || e->e_kind != ELF_K_ELF) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	LIBELF_LOCK(e);
+	ehdr = _libelf_get_ehdr(e, ec, allocate);
+	LIBELF_UNLOCK(e);
+
+	return (ehdr);
+}
@@ -37,10 +37,12 @@ ELFTC_VCSID("$Id$");
 static Elf_Scn *
 _libelf_getscn0(Elf *e)
 {
-	Elf_Scn *s;
+	if (e->e_u.e_elf.e_scntabsz > 0 && e->e_u.e_elf.e_scntab[0] != NULL)
+		return (e->e_u.e_elf.e_scntab[0]);
 
-	if ((s = STAILQ_FIRST(&e->e_u.e_elf.e_scn)) != NULL)
-		return (s);
+	if (e->e_cmd != ELF_C_WRITE && e->e_u.e_elf.e_nscn > 0 &&
+	    (e->e_flags & LIBELF_F_SHDRS_LOADED))
+		return (_libelf_load_scn(e, (size_t) SHN_UNDEF));
 
 	return (_libelf_allocate_scn(e, (size_t) SHN_UNDEF));
 }
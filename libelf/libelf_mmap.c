@@ -0,0 +1,238 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#if	defined(__linux__) && !defined(_GNU_SOURCE)
+#define	_GNU_SOURCE		/* For copy_file_range(2). */
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <errno.h>
+#include <libelf.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Bookkeeping for files mapped in by ELF_C_READ descriptors.
+ *
+ * Applications that copy sections from one object to another usually
+ * point the data descriptors of the new object at the data of the old
+ * one, which for a mapped file lies inside its mapping.  Recording
+ * where each file is mapped lets elf_update(3) hand such data to the
+ * kernel using copy_file_range(2), without bringing it into memory.
+ * It also lets elf_update(3) notice that the file it is about to
+ * overwrite is mapped in, and that its contents are still needed.
+ */
+
+#if	ELFTC_HAVE_MMAP
+
+struct _libelf_mapping {
+	SLIST_ENTRY(_libelf_mapping) m_next;
+	const unsigned char *m_base;	/* Start of the mapping. */
+	size_t		m_size;		/* Size of the mapping. */
+	int		m_fd;		/* File descriptor mapped. */
+	off_t		m_off;		/* File offset of m_base. */
+	dev_t		m_dev;		/* Identity of the file ... */
+	ino_t		m_ino;		/* ... mapped. */
+};
+
+static SLIST_HEAD(, _libelf_mapping) _libelf_mappings =
+    SLIST_HEAD_INITIALIZER(_libelf_mappings);
+static pthread_mutex_t _libelf_mappings_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Record a mapping of the bytes at offset `off' of file descriptor
+ * `fd'.  Failures are not fatal, as the mapping is then simply not
+ * used for copying.
+ */
+void
+_libelf_register_mapping(const unsigned char *base, size_t size, int fd,
+    off_t off)
+{
+	struct stat sb;
+	struct _libelf_mapping *m;
+
+	if (fstat(fd, &sb) < 0 || (m = malloc(sizeof(*m))) == NULL)
+		return;
+
+	m->m_base = base;
+	m->m_size = size;
+	m->m_fd   = fd;
+	m->m_off  = off;
+	m->m_dev  = sb.st_dev;
+	m->m_ino  = sb.st_ino;
+
+	(void) pthread_mutex_lock(&_libelf_mappings_lock);
+	SLIST_INSERT_HEAD(&_libelf_mappings, m, m_next);
+	(void) pthread_mutex_unlock(&_libelf_mappings_lock);
+}
+
+/*
+ * Forget the mapping starting at `base', if any.
+ */
+void
+_libelf_unregister_mapping(const unsigned char *base)
+{
+	struct _libelf_mapping *m;
+
+	(void) pthread_mutex_lock(&_libelf_mappings_lock);
+	SLIST_FOREACH(m, &_libelf_mappings, m_next)
+		if (m->m_base == base)
+			break;
+	if (m != NULL)
+		SLIST_REMOVE(&_libelf_mappings, m, _libelf_mapping, m_next);
+	(void) pthread_mutex_unlock(&_libelf_mappings_lock);
+
+	free(m);
+}
+
+/*
+ * Return non-zero if the file open on descriptor `fd' is mapped in
+ * by an ELF_C_READ descriptor.
+ */
+int
+_libelf_file_is_mapped(int fd)
+{
+	struct stat sb;
+	struct _libelf_mapping *m;
+
+	if (fstat(fd, &sb) < 0 || !S_ISREG(sb.st_mode))
+		return (0);
+
+	(void) pthread_mutex_lock(&_libelf_mappings_lock);
+	SLIST_FOREACH(m, &_libelf_mappings, m_next)
+		if (m->m_dev == sb.st_dev && m->m_ino == sb.st_ino)
+			break;
+	(void) pthread_mutex_unlock(&_libelf_mappings_lock);
+
+	return (m != NULL);
+}
+
+#if	ELFTC_HAVE_COPY_FILE_RANGE
+/*
+ * Write `sz' bytes at `buf' to the current position of file
+ * descriptor `fd', if they lie within a known mapping.  Returns the
+ * number of bytes written, which may be less than `sz' if the
+ * copy could not be done in the kernel; the caller is expected to
+ * write out the rest.
+ */
+size_t
+_libelf_copy_mapped(int fd, const unsigned char *buf, size_t sz)
+{
+	int mfd;
+	ssize_t n;
+	size_t done;
+	loff_t off;
+	struct stat sb;
+	dev_t dev;
+	ino_t ino;
+	struct _libelf_mapping *m;
+
+	(void) pthread_mutex_lock(&_libelf_mappings_lock);
+	SLIST_FOREACH(m, &_libelf_mappings, m_next)
+		if (buf >= m->m_base && sz <= m->m_size &&
+		    (size_t) (buf - m->m_base) <= m->m_size - sz)
+			break;
+	if (m != NULL) {
+		mfd = m->m_fd;
+		dev = m->m_dev;
+		ino = m->m_ino;
+		off = (loff_t) m->m_off + (loff_t) (buf - m->m_base);
+	}
+	(void) pthread_mutex_unlock(&_libelf_mappings_lock);
+
+	if (m == NULL)
+		return (0);
+
+	/*
+	 * The application could have closed the descriptor it used
+	 * to create the mapping, and the descriptor number could
+	 * have been reused since.
+	 */
+	if (fstat(mfd, &sb) < 0 || sb.st_dev != dev || sb.st_ino != ino)
+		return (0);
+
+	for (done = 0; done < sz; done += (size_t) n) {
+		n = copy_file_range(mfd, &off, fd, NULL, sz - done, 0);
+		if (n < 0 && errno == EINTR) {
+			n = 0;
+			continue;
+		}
+		if (n <= 0)
+			break;
+	}
+
+	return (done);
+}
+#endif	/* ELFTC_HAVE_COPY_FILE_RANGE */
+
+#else	/* !ELFTC_HAVE_MMAP */
+
+void
+_libelf_register_mapping(const unsigned char *base, size_t size, int fd,
+    off_t off)
+{
+	(void) base;
+	(void) size;
+	(void) fd;
+	(void) off;
+}
+
+void
+_libelf_unregister_mapping(const unsigned char *base)
+{
+	(void) base;
+}
+
+int
+_libelf_file_is_mapped(int fd)
+{
+	(void) fd;
+
+	return (0);
+}
+
+#endif	/* ELFTC_HAVE_MMAP */
+
+#if	!ELFTC_HAVE_MMAP || !ELFTC_HAVE_COPY_FILE_RANGE
+size_t
+_libelf_copy_mapped(int fd, const unsigned char *buf, size_t sz)
+{
+	(void) fd;
+	(void) buf;
+	(void) sz;
+
+	return (0);
+}
+#endif
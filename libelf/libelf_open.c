@@ -245,5 +245,130 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 	e->e_fd = fd;
 	e->e_cmd = c;
 
+	/*
+	 * Remember where read-only files are mapped, for the benefit
+	 * of elf_update(3) on objects that reuse their data.
+	 */
+	if (c == ELF_C_READ && (flags & LIBELF_F_RAWFILE_MMAP))
+		_libelf_register_mapping(m, fsize, fd, (off_t) 0);
+
+	return (e);
+}
+
+#if	ELFTC_HAVE_MMAP
+/*
+ * Return the offset of file offset `off' within its page.
+ */
+static size_t
+_libelf_page_offset(off_t off)
+{
+	long pagesz;
+
+	if ((pagesz = sysconf(_SC_PAGESIZE)) <= 0)
+		pagesz = 4096;
+
+	return ((size_t) (off % pagesz));
+}
+
+/*
+ * Remove the mapping holding the file image of ELF descriptor `e',
+ * which need not start at a page boundary.
+ */
+void
+_libelf_unmap_rawfile(Elf *e)
+{
+	size_t delta;
+
+	delta = _libelf_page_offset(e->e_rawoff);
+	(void) munmap(e->e_rawfile - delta, (size_t) e->e_rawsize + delta);
+}
+#endif
+
+/*
+ * Open the `sz' bytes at offset `off' in the regular file referenced
+ * by file descriptor `fd' as an ELF object or ar(1) archive.  Only
+ * the pages holding these bytes are mapped in.
+ */
+
+Elf *
+_libelf_open_slice(int fd, off_t off, size_t sz)
+{
+	Elf *e;
+	ssize_t n;
+	size_t done;
+	struct stat sb;
+	unsigned int flags;
+	unsigned char *m;
+#if	ELFTC_HAVE_MMAP
+	void *p;
+	size_t delta;
+#endif
+
+	if (fstat(fd, &sb) < 0) {
+		LIBELF_SET_ERROR(IO, errno);
+		return (NULL);
+	}
+
+	if (!S_ISREG(sb.st_mode) || off < 0 || sz == 0 ||
+	    off > sb.st_size || (uint64_t) sz > (uint64_t) (sb.st_size - off)) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	m = NULL;
+	flags = 0;
+
+#if	ELFTC_HAVE_MMAP
+	/* mmap(2) needs a page aligned file offset. */
+	delta = _libelf_page_offset(off);
+	if (sz <= SIZE_MAX - delta &&
+	    (p = mmap(NULL, sz + delta, PROT_READ, MAP_PRIVATE, fd,
+	    off - (off_t) delta)) != MAP_FAILED) {
+		m = (unsigned char *) p + delta;
+		flags = LIBELF_F_RAWFILE_MMAP;
+	}
+#endif
+
+	/* Fall back to reading the slice in. */
+	if (m == NULL) {
+		if ((m = malloc(sz)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, 0);
+			return (NULL);
+		}
+
+		for (done = 0; done < sz; done += (size_t) n) {
+			n = pread(fd, m + done, sz - done, off + (off_t) done);
+			if (n < 0 && errno == EINTR) {
+				n = 0;
+				continue;
+			}
+			if (n <= 0) {
+				LIBELF_SET_ERROR(IO, n < 0 ? errno : 0);
+				free(m);
+				return (NULL);
+			}
+		}
+
+		flags = LIBELF_F_RAWFILE_MALLOC;
+	}
+
+	if ((e = _libelf_memory(m, sz, 1)) == NULL) {
+		if (flags & LIBELF_F_RAWFILE_MALLOC)
+			free(m);
+#if	ELFTC_HAVE_MMAP
+		else
+			(void) munmap(m - delta, sz + delta);
+#endif
+		return (NULL);
+	}
+
+	e->e_flags |= flags;
+	e->e_fd = fd;
+	e->e_cmd = ELF_C_READ;
+	e->e_rawoff = off;
+
+	if (flags & LIBELF_F_RAWFILE_MMAP)
+		_libelf_register_mapping(m, sz, fd, off);
+
 	return (e);
 }
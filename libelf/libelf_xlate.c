@@ -147,3 +147,35 @@ _libelf_xlate(Elf_Data *dst, const Elf_Data *src, unsigned int encoding,
 
 	return (dst);
 }
+
+/*
+ * Return non-zero if translating data of type `t' between its file
+ * and memory representations, for an object of class `elfclass' with
+ * byte order `byteorder', amounts to a plain copy.
+ */
+
+int
+_libelf_xlate_is_copy(Elf_Type t, int elfclass, unsigned int byteorder)
+{
+	if (t == ELF_T_BYTE)
+		return (1);
+
+	if (byteorder != LIBELF_PRIVATE(byteorder))
+		return (0);
+
+	/*
+	 * Types with a variable-sized representation are always
+	 * passed through their translators, which validate them.
+	 */
+	switch (t) {
+	case ELF_T_GNUHASH:
+	case ELF_T_VDEF:
+	case ELF_T_VNEED:
+		return (0);
+	default:
+		break;
+	}
+
+	return (_libelf_fsize(t, elfclass, EV_CURRENT, (size_t) 1) ==
+	    _libelf_msize(t, elfclass, EV_CURRENT));
+}
@@ -172,6 +172,7 @@ p->t_table == NULL || p->s_table == NULL || p->filename == NULL)
 #define	IS_SYM_TYPE(t)		((t) == '?' || isalpha((t)) != 0)
 #define	IS_UNDEF_SYM_TYPE(t)	((t) == 'U' || (t) == 'v' || (t) == 'w')
 #define	UNUSED(p)		((void)p)
+#define	SYM_BATCH_SIZE		256	/* symbols converted per call */
 
 static int		cmp_name(const void *, const void *);
 static int		cmp_none(const void *, const void *);
@@ -619,14 +620,14 @@ get_sym(Elf *elf, struct sym_head *headp, int shnum, size_t dynndx,
 	Elf_Scn *scn;
 	Elf_Data *data;
 	GElf_Shdr shdr;
-	GElf_Sym sym;
+	GElf_Sym syms[SYM_BATCH_SIZE], *sym;
 	struct filter_entry *fep;
-	size_t ndx;
+	size_t count, j, k, ndx, nsyms, symsz;
 	int rtn;
 	const char *sym_name;
 	char type;
 	bool filter;
-	int i, j;
+	int i;
 
 	assert(elf != NULL);
 	assert(headp != NULL);
@@ -652,26 +653,44 @@ get_sym(Elf *elf, struct sym_head *headp, int shnum, size_t dynndx,
 
 		ndx = shdr.sh_type == SHT_DYNSYM ? dynndx : strndx;
 
+		if ((symsz = gelf_fsize(elf, ELF_T_SYM, 1, EV_CURRENT)) == 0) {
+			warnx("gelf_fsize failed: %s", elf_errmsg(-1));
+			continue;
+		}
+
 		data = NULL;
 		while ((data = elf_getdata(scn, data)) != NULL) {
-			j = 1;
-			while (gelf_getsym(data, j++, &sym) != NULL) {
-				sym_name = get_sym_name(elf, &sym, ndx,
-				    sec_table, sec_table_size);
-				filter = false;
-				type = get_sym_type(&sym, type_table);
-				SLIST_FOREACH(fep, &nm_out_filter,
-				    filter_entries) {
-					if (!fep->fn(type, &sym, sym_name)) {
-						filter = true;
-						break;
-					}
+			nsyms = data->d_size / symsz;
+			for (j = 1; j < nsyms; j += count) {
+				count = nsyms - j;
+				if (count > SYM_BATCH_SIZE)
+					count = SYM_BATCH_SIZE;
+				if (gelf_getsyms(data, j, count, syms) ==
+				    NULL) {
+					warnx("gelf_getsyms failed: %s",
+					    elf_errmsg(-1));
+					break;
 				}
-				if (filter == false) {
-					if (sym_list_insert(headp, sym_name,
-					    &sym) == 0)
-						return (0);
-					rtn++;
+				for (k = 0; k < count; k++) {
+					sym = &syms[k];
+					sym_name = get_sym_name(elf, sym, ndx,
+					    sec_table, sec_table_size);
+					filter = false;
+					type = get_sym_type(sym, type_table);
+					SLIST_FOREACH(fep, &nm_out_filter,
+					    filter_entries) {
+						if (!fep->fn(type, sym,
+						    sym_name)) {
+							filter = true;
+							break;
+						}
+					}
+					if (filter == false) {
+						if (sym_list_insert(headp,
+						    sym_name, sym) == 0)
+							return (0);
+						rtn++;
+					}
 				}
 			}
 		}
@@ -0,0 +1,74 @@
+#!/bin/sh
+#
+# $Id$
+#
+# Check the order in which archive members are extracted.
+#
+# The archive's symbol table lists `c', `b' and `a' in that order, and
+# each member refers to the next one, so resolving `a' needs several
+# passes over the symbol table.  Member `d' is never referenced.
+#
+# A second archive lists `v' for member `x' ahead of member `w', which
+# defines both `w' and `v'.  Once `w' is extracted nothing is left
+# undefined, so the symbol table is not swept again and `x' is skipped.
+
+test_log=test.log
+LD=`cd ../../ld && /bin/pwd`/ld
+CC=${CC:-cc}
+AR=${AR:-ar}
+TMPDIR=/tmp/ld-test.$$
+
+trap 'rm -rf ${TMPDIR}' 0 2 3 15
+
+exec >${test_log} 2>&1
+echo @TEST-RUN: `date`
+
+mkdir -p ${TMPDIR} || exit 1
+
+echo 'int c(void) { return (3); }' > ${TMPDIR}/c.c
+echo 'int c(void); int b(void) { return (c()); }' > ${TMPDIR}/b.c
+echo 'int b(void); int a(void) { return (b()); }' > ${TMPDIR}/a.c
+echo 'int d(void) { return (4); }' > ${TMPDIR}/d.c
+echo 'int a(void); void _start(void) { (void) a(); }' > ${TMPDIR}/main.c
+echo 'int v(void) { return (1); }' > ${TMPDIR}/x.c
+echo 'int v(void) { return (2); } int w(void) { return (v()); }' > \
+    ${TMPDIR}/w.c
+echo 'int w(void); void _start(void) { (void) w(); }' > ${TMPDIR}/mainw.c
+
+for f in main a b c d mainw w x; do
+	${CC} -c -fno-pic -o ${TMPDIR}/${f}.o ${TMPDIR}/${f}.c || exit 1
+done
+(cd ${TMPDIR} && ${AR} rc libt.a c.o d.o b.o a.o) || exit 1
+(cd ${TMPDIR} && ${AR} rc libu.a x.o w.o) || exit 1
+
+cat > ${TMPDIR}/expected <<EOT
+libt.a(a.o)                   main.o (a)
+libt.a(b.o)                   libt.a(a.o) (b)
+libt.a(c.o)                   libt.a(b.o) (c)
+EOT
+
+(cd ${TMPDIR} && ${LD} -M -o a.out main.o libt.a > map) || exit 1
+awk '/^Extracted archive members:/ { getline; n = 1; next }
+    n && /^$/ { exit } n { print }' ${TMPDIR}/map > ${TMPDIR}/actual
+
+if diff -u ${TMPDIR}/expected ${TMPDIR}/actual; then
+	echo "archive member extraction order - ok"
+else
+	echo "archive member extraction order - not ok"
+	exit 1
+fi
+
+cat > ${TMPDIR}/expected <<EOT
+libu.a(w.o)                   mainw.o (w)
+EOT
+
+(cd ${TMPDIR} && ${LD} -M -o a.out mainw.o libu.a > map) || exit 1
+awk '/^Extracted archive members:/ { getline; n = 1; next }
+    n && /^$/ { exit } n { print }' ${TMPDIR}/map > ${TMPDIR}/actual
+
+if diff -u ${TMPDIR}/expected ${TMPDIR}/actual; then
+	echo "archive member not extracted for a defined name - ok"
+else
+	echo "archive member not extracted for a defined name - not ok"
+	exit 1
+fi
@@ -0,0 +1,165 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * A driver for libdwarf benchmarks.
+ */
+
+#include <err.h>
+#include <libdwarf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "_elftc.h"
+
+#include "bench.h"
+
+static struct bench_scenario scenarios[] = {
+	{ "offdie", "resolve every reference attribute with dwarf_offdie_b",
+	  bench_offdie },
+	{ "sibling", "step over the DIE tree of every unit with dwarf_siblingof",
+	  bench_sibling },
+	{ NULL, NULL, NULL }
+};
+
+double
+bench_time(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(EXIT_FAILURE, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+char *
+bench_path(const struct bench_options *bo, const char *name)
+{
+	char *p;
+	size_t sz;
+
+	sz = strlen(bo->bo_dir) + strlen(name) + 2;
+	if ((p = malloc(sz)) == NULL)
+		err(EXIT_FAILURE, "malloc");
+	(void) snprintf(p, sz, "%s/%s", bo->bo_dir, name);
+
+	return (p);
+}
+
+/*
+ * Each result is printed as one line with four fields: the scenario,
+ * the variant measured, the number of operations performed and the
+ * elapsed time in seconds.  Lines starting with '#' are comments.
+ */
+void
+bench_report(const char *scenario, const char *variant, size_t count,
+    double seconds)
+{
+	(void) printf("%-12s %-16s %10zu %12.6f\n", scenario, variant, count,
+	    seconds);
+}
+
+static void
+usage(void)
+{
+	struct bench_scenario *bn;
+
+	(void) fprintf(stderr, "usage: %s [-c dies] [-d dir] [-f file] "
+	    "[-n units] [-r repeat] [scenario...]\n", ELFTC_GETPROGNAME());
+	for (bn = scenarios; bn->bn_name; bn++)
+		(void) fprintf(stderr, "  %-12s %s\n", bn->bn_name,
+		    bn->bn_descr);
+	exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char **argv)
+{
+	int i, opt;
+	struct bench_options bo;
+	struct bench_scenario *bn;
+
+	bo.bo_cache = 4096;
+	bo.bo_dir = ".";
+	bo.bo_file = NULL;
+	bo.bo_ncu = 20000;
+	bo.bo_repeat = 1;
+
+	while ((opt = getopt(argc, argv, "c:d:f:n:r:")) != -1) {
+		switch (opt) {
+		case 'c':
+			bo.bo_cache = (size_t) strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			bo.bo_dir = optarg;
+			break;
+		case 'f':
+			bo.bo_file = optarg;
+			break;
+		case 'n':
+			bo.bo_ncu = (size_t) strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			bo.bo_repeat = atoi(optarg);
+			break;
+		default:
+			usage();
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (bo.bo_ncu == 0 || bo.bo_repeat <= 0)
+		usage();
+
+	if (bo.bo_file != NULL)
+		(void) printf("# file=%s repeat=%d\n", bo.bo_file,
+		    bo.bo_repeat);
+	else
+		(void) printf("# units=%zu repeat=%d\n", bo.bo_ncu,
+		    bo.bo_repeat);
+	(void) printf("# scenario variant count seconds\n");
+
+	for (bn = scenarios; bn->bn_name; bn++) {
+		if (argc > 0) {
+			for (i = 0; i < argc; i++)
+				if (strcmp(argv[i], bn->bn_name) == 0)
+					break;
+			if (i == argc)
+				continue;
+		}
+		(*bn->bn_fn)(&bo);
+	}
+
+	exit(EXIT_SUCCESS);
+}
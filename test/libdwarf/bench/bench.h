@@ -0,0 +1,62 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#ifndef	_BENCH_H_
+#define	_BENCH_H_
+
+#include <stddef.h>
+
+/*
+ * Options common to all benchmark scenarios.
+ */
+struct bench_options {
+	const char	*bo_dir;	/* directory for generated files */
+	const char	*bo_file;	/* object to use instead, if any */
+	size_t		bo_cache;	/* DIE cache limit, or zero */
+	size_t		bo_ncu;		/* number of compilation units */
+	int		bo_repeat;	/* number of timed iterations */
+};
+
+typedef void bench_fn(const struct bench_options *_bo);
+
+struct bench_scenario {
+	const char	*bn_name;
+	const char	*bn_descr;
+	bench_fn	*bn_fn;
+};
+
+void	bench_gen_dwarf(const char *_path, size_t _ncu);
+char	*bench_path(const struct bench_options *_bo, const char *_name);
+void	bench_report(const char *_scenario, const char *_variant,
+    size_t _count, double _seconds);
+double	bench_time(void);
+
+bench_fn	bench_offdie;
+bench_fn	bench_sibling;
+
+#endif	/* _BENCH_H_ */
@@ -0,0 +1,242 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Generate a synthetic object with a large number of compilation
+ * units for libdwarf benchmarks.
+ *
+ * Each unit holds a base type and BENCH_GEN_NVAR variables.  Half of
+ * the variables refer to the base type of their own unit with a
+ * DW_FORM_ref4 attribute, the other half refer to the base type of
+ * another unit with a DW_FORM_ref_addr attribute, the way types are
+ * shared across units in large C++ programs.
+ */
+
+#include <dwarf.h>
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define	BENCH_GEN_NVAR		8
+
+/* Abbreviation codes. */
+#define	BENCH_AB_CU		1
+#define	BENCH_AB_BASE		2
+#define	BENCH_AB_VAR_LOCAL	3
+#define	BENCH_AB_VAR_GLOBAL	4
+
+static const uint8_t bench_abbrev[] = {
+	BENCH_AB_CU, DW_TAG_compile_unit, DW_CHILDREN_yes,
+	    DW_AT_name, DW_FORM_string,
+	    DW_AT_language, DW_FORM_data1,
+	    0, 0,
+	BENCH_AB_BASE, DW_TAG_base_type, DW_CHILDREN_no,
+	    DW_AT_name, DW_FORM_string,
+	    DW_AT_byte_size, DW_FORM_data1,
+	    DW_AT_encoding, DW_FORM_data1,
+	    0, 0,
+	BENCH_AB_VAR_LOCAL, DW_TAG_variable, DW_CHILDREN_no,
+	    DW_AT_name, DW_FORM_string,
+	    DW_AT_type, DW_FORM_ref4,
+	    0, 0,
+	BENCH_AB_VAR_GLOBAL, DW_TAG_variable, DW_CHILDREN_no,
+	    DW_AT_name, DW_FORM_string,
+	    DW_AT_type, DW_FORM_ref_addr,
+	    0, 0,
+	0
+};
+
+struct bench_buf {
+	uint8_t		*bb_buf;
+	size_t		bb_size;
+};
+
+static void
+bb_put(struct bench_buf *bb, uint64_t v, size_t width)
+{
+	size_t i;
+
+	for (i = 0; i < width; i++, v >>= 8)
+		bb->bb_buf[bb->bb_size++] = (uint8_t) (v & 0xFF);
+}
+
+static void
+bb_string(struct bench_buf *bb, const char *s)
+{
+	size_t n;
+
+	n = strlen(s) + 1;
+	(void) memcpy(bb->bb_buf + bb->bb_size, s, n);
+	bb->bb_size += n;
+}
+
+/*
+ * Names have a fixed width, so that all units have the same size and
+ * the offset of any DIE can be computed up front.
+ */
+#define	BENCH_NAMESZ		10	/* "t%08zu" and NUL */
+#define	BENCH_CU_HDRSZ		11	/* DWARF4, 32-bit format */
+#define	BENCH_CU_DIESZ		(1 + BENCH_NAMESZ + 1)
+#define	BENCH_BASE_DIESZ	(1 + BENCH_NAMESZ + 1 + 1)
+#define	BENCH_VAR_DIESZ		(1 + BENCH_NAMESZ + 4)
+#define	BENCH_CU_SIZE		(BENCH_CU_HDRSZ + BENCH_CU_DIESZ +	\
+	BENCH_BASE_DIESZ + BENCH_GEN_NVAR * BENCH_VAR_DIESZ + 1)
+
+static void
+bench_gen_info(struct bench_buf *bb, size_t ncu)
+{
+	char name[BENCH_NAMESZ + 1];
+	size_t base, i, j, start, target;
+
+	base = BENCH_CU_HDRSZ + BENCH_CU_DIESZ;
+
+	for (i = 0; i < ncu; i++) {
+		start = bb->bb_size;
+
+		bb_put(bb, BENCH_CU_SIZE - 4, 4);	/* unit_length */
+		bb_put(bb, 4, 2);			/* version */
+		bb_put(bb, 0, 4);			/* debug_abbrev_offset */
+		bb_put(bb, 8, 1);			/* address_size */
+
+		bb_put(bb, BENCH_AB_CU, 1);
+		(void) snprintf(name, sizeof(name), "u%08zu", i % 100000000);
+		bb_string(bb, name);
+		bb_put(bb, DW_LANG_C99, 1);
+
+		bb_put(bb, BENCH_AB_BASE, 1);
+		(void) snprintf(name, sizeof(name), "t%08zu", i % 100000000);
+		bb_string(bb, name);
+		bb_put(bb, 4, 1);			/* DW_AT_byte_size */
+		bb_put(bb, DW_ATE_signed, 1);
+
+		for (j = 0; j < BENCH_GEN_NVAR; j++) {
+			(void) snprintf(name, sizeof(name), "v%08zu",
+			    (i * BENCH_GEN_NVAR + j) % 100000000);
+			if (j % 2 == 0) {
+				bb_put(bb, BENCH_AB_VAR_LOCAL, 1);
+				bb_string(bb, name);
+				bb_put(bb, base, 4);
+			} else {
+				/* Spread references over the whole section. */
+				target = (i * 7919 + j * 104729) % ncu;
+				bb_put(bb, BENCH_AB_VAR_GLOBAL, 1);
+				bb_string(bb, name);
+				bb_put(bb, target * BENCH_CU_SIZE + base, 4);
+			}
+		}
+
+		bb_put(bb, 0, 1);			/* End of children. */
+
+		if (bb->bb_size - start != BENCH_CU_SIZE)
+			errx(EXIT_FAILURE, "bench_gen_info: bad unit size");
+	}
+}
+
+static void
+bench_gen_scn(Elf *e, const char *path, struct bench_buf *shstrtab,
+    const char *name, uint32_t type, void *buf, size_t size)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+
+	if ((scn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(scn)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	d->d_buf = buf;
+	d->d_size = size;
+	d->d_align = 1;
+	d->d_type = ELF_T_BYTE;
+
+	sh.sh_name = (uint32_t) shstrtab->bb_size;
+	sh.sh_type = type;
+	sh.sh_addralign = 1;
+	bb_string(shstrtab, name);
+
+	if (gelf_update_shdr(scn, &sh) == 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+}
+
+void
+bench_gen_dwarf(const char *path, size_t ncu)
+{
+	Elf *e;
+	int fd;
+	GElf_Ehdr eh;
+	struct bench_buf info, shstrtab;
+	uint8_t shstrbuf[64];	/* Large enough for the three names. */
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(EXIT_FAILURE, "elf_version: %s", elf_errmsg(-1));
+
+	info.bb_size = 0;
+	if ((info.bb_buf = malloc(ncu * BENCH_CU_SIZE)) == NULL)
+		err(EXIT_FAILURE, "malloc");
+	bench_gen_info(&info, ncu);
+
+	shstrtab.bb_buf = shstrbuf;
+	shstrtab.bb_size = 0;
+	bb_string(&shstrtab, "");
+
+	if ((fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+	    gelf_newehdr(e, ELFCLASS64) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	eh.e_ident[EI_DATA] = ELFDATA2LSB;
+	eh.e_type = ET_REL;
+	eh.e_machine = EM_X86_64;
+
+	bench_gen_scn(e, path, &shstrtab, ".debug_abbrev", SHT_PROGBITS,
+	    (void *) (uintptr_t) bench_abbrev, sizeof(bench_abbrev));
+	bench_gen_scn(e, path, &shstrtab, ".debug_info", SHT_PROGBITS,
+	    info.bb_buf, info.bb_size);
+	bench_gen_scn(e, path, &shstrtab, ".shstrtab", SHT_STRTAB,
+	    shstrbuf, sizeof(shstrbuf));
+
+	eh.e_shstrndx = 3;
+	if (gelf_update_ehdr(e, &eh) == 0 || elf_update(e, ELF_C_WRITE) < 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	(void) elf_end(e);
+	(void) close(fd);
+	free(info.bb_buf);
+}
@@ -0,0 +1,223 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for resolving references between DIEs.
+ */
+
+#include <dwarf.h>
+#include <err.h>
+#include <fcntl.h>
+#include <libdwarf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+struct bench_refs {
+	Dwarf_Off	*br_off;
+	size_t		br_count;
+	size_t		br_cap;
+	size_t		br_ndie;
+};
+
+static void
+bench_refs_add(struct bench_refs *br, Dwarf_Off off)
+{
+	if (br->br_count == br->br_cap) {
+		br->br_cap = br->br_cap ? 2 * br->br_cap : 1024;
+		if ((br->br_off = realloc(br->br_off, br->br_cap *
+		    sizeof(br->br_off[0]))) == NULL)
+			err(EXIT_FAILURE, "realloc");
+	}
+
+	br->br_off[br->br_count++] = off;
+}
+
+/*
+ * Record the target of each reference attribute of a DIE.
+ */
+static void
+bench_collect_die(Dwarf_Die die, struct bench_refs *br)
+{
+	Dwarf_Attribute *attrs;
+	Dwarf_Error de;
+	Dwarf_Half form;
+	Dwarf_Off off;
+	Dwarf_Signed i, n;
+	int r;
+
+	br->br_ndie++;
+
+	if ((r = dwarf_attrlist(die, &attrs, &n, &de)) == DW_DLV_NO_ENTRY)
+		return;
+	if (r != DW_DLV_OK)
+		errx(EXIT_FAILURE, "dwarf_attrlist: %s", dwarf_errmsg(de));
+
+	for (i = 0; i < n; i++) {
+		if (dwarf_whatform(attrs[i], &form, &de) != DW_DLV_OK)
+			errx(EXIT_FAILURE, "dwarf_whatform: %s",
+			    dwarf_errmsg(de));
+		switch (form) {
+		case DW_FORM_ref_addr:
+		case DW_FORM_ref1:
+		case DW_FORM_ref2:
+		case DW_FORM_ref4:
+		case DW_FORM_ref8:
+		case DW_FORM_ref_udata:
+			if (dwarf_global_formref(attrs[i], &off, &de) !=
+			    DW_DLV_OK)
+				errx(EXIT_FAILURE, "dwarf_global_formref: %s",
+				    dwarf_errmsg(de));
+			bench_refs_add(br, off);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+static void
+bench_collect(Dwarf_Debug dbg, Dwarf_Die die, struct bench_refs *br)
+{
+	Dwarf_Die child, next;
+	Dwarf_Error de;
+	int r;
+
+	while (die != NULL) {
+		bench_collect_die(die, br);
+
+		if ((r = dwarf_child(die, &child, &de)) == DW_DLV_OK)
+			bench_collect(dbg, child, br);
+		else if (r == DW_DLV_ERROR)
+			errx(EXIT_FAILURE, "dwarf_child: %s",
+			    dwarf_errmsg(de));
+
+		if ((r = dwarf_siblingof(dbg, die, &next, &de)) ==
+		    DW_DLV_ERROR)
+			errx(EXIT_FAILURE, "dwarf_siblingof: %s",
+			    dwarf_errmsg(de));
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		die = (r == DW_DLV_OK) ? next : NULL;
+	}
+}
+
+/*
+ * Resolve every collected reference with dwarf_offdie_b().
+ */
+static void
+bench_resolve(Dwarf_Debug dbg, const struct bench_options *bo,
+    const struct bench_refs *br, const char *variant)
+{
+	Dwarf_Die die;
+	Dwarf_Error de;
+	double t;
+	int rep;
+	size_t i, n;
+
+	n = 0;
+	t = bench_time();
+	for (rep = 0; rep < bo->bo_repeat; rep++)
+		for (i = 0; i < br->br_count; i++, n++) {
+			if (dwarf_offdie_b(dbg, br->br_off[i], 1, &die, &de) !=
+			    DW_DLV_OK)
+				errx(EXIT_FAILURE, "dwarf_offdie_b: %s",
+				    dwarf_errmsg(de));
+			dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		}
+	bench_report("offdie", variant, n, bench_time() - t);
+}
+
+/*
+ * Collect every reference attribute of the object, then resolve the
+ * references with dwarf_offdie_b(), as a debugger or symbolizer does
+ * when it follows DW_AT_type and DW_AT_abstract_origin chains.
+ */
+void
+bench_offdie(const struct bench_options *bo)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Die die;
+	Dwarf_Error de;
+	Dwarf_Unsigned hits, misses, next;
+	char *path;
+	double t;
+	int fd, r;
+	struct bench_refs br;
+
+	path = NULL;
+	if (bo->bo_file == NULL) {
+		path = bench_path(bo, "offdie.o");
+		bench_gen_dwarf(path, bo->bo_ncu);
+	}
+
+	if ((fd = open(bo->bo_file ? bo->bo_file : path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open");
+	if (dwarf_init(fd, DW_DLC_READ, NULL, NULL, &dbg, &de) != DW_DLV_OK)
+		errx(EXIT_FAILURE, "dwarf_init: %s", dwarf_errmsg(de));
+
+	br.br_off = NULL;
+	br.br_count = br.br_cap = br.br_ndie = 0;
+
+	t = bench_time();
+	while ((r = dwarf_next_cu_header_b(dbg, NULL, NULL, NULL, NULL, NULL,
+	    NULL, &next, &de)) == DW_DLV_OK) {
+		if (dwarf_siblingof(dbg, NULL, &die, &de) != DW_DLV_OK)
+			errx(EXIT_FAILURE, "dwarf_siblingof: %s",
+			    dwarf_errmsg(de));
+		bench_collect(dbg, die, &br);
+	}
+	if (r == DW_DLV_ERROR)
+		errx(EXIT_FAILURE, "dwarf_next_cu_header_b: %s",
+		    dwarf_errmsg(de));
+	bench_report("offdie", "traverse", br.br_ndie, bench_time() - t);
+
+	bench_resolve(dbg, bo, &br, "dwarf_offdie_b");
+
+	/* Repeat with the DIE cache enabled. */
+	if (bo->bo_cache > 0) {
+		(void) dwarf_set_die_cache_limit(dbg, bo->bo_cache);
+		bench_resolve(dbg, bo, &br, "cached");
+		if (dwarf_get_die_cache_stats(dbg, &hits, &misses, &de) !=
+		    DW_DLV_OK)
+			errx(EXIT_FAILURE, "dwarf_get_die_cache_stats: %s",
+			    dwarf_errmsg(de));
+		(void) printf("# cache limit=%zu hits=%ju misses=%ju\n",
+		    bo->bo_cache, (uintmax_t) hits, (uintmax_t) misses);
+	}
+
+	(void) dwarf_finish(dbg, &de);
+	(void) close(fd);
+	free(br.br_off);
+	if (path != NULL) {
+		(void) unlink(path);
+		free(path);
+	}
+}
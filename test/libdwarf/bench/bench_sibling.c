@@ -0,0 +1,101 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for stepping over DIE subtrees.
+ */
+
+#include <dwarf.h>
+#include <err.h>
+#include <fcntl.h>
+#include <libdwarf.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Step over the DIE tree of every unit with dwarf_siblingof(), the
+ * way tools looking for top-level DIEs skip the entries they do not
+ * need.  Unit DIEs have no DW_AT_sibling attribute, so each call scans
+ * the whole unit.
+ */
+void
+bench_sibling(const struct bench_options *bo)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Die die, sib;
+	Dwarf_Error de;
+	Dwarf_Unsigned next;
+	char *path;
+	double t;
+	int fd, r, rep;
+	size_t n;
+
+	path = NULL;
+	if (bo->bo_file == NULL) {
+		path = bench_path(bo, "sibling.o");
+		bench_gen_dwarf(path, bo->bo_ncu);
+	}
+
+	if ((fd = open(bo->bo_file ? bo->bo_file : path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open");
+	if (dwarf_init(fd, DW_DLC_READ, NULL, NULL, &dbg, &de) != DW_DLV_OK)
+		errx(EXIT_FAILURE, "dwarf_init: %s", dwarf_errmsg(de));
+
+	n = 0;
+	t = bench_time();
+	for (rep = 0; rep < bo->bo_repeat; rep++) {
+		while ((r = dwarf_next_cu_header_b(dbg, NULL, NULL, NULL, NULL,
+		    NULL, NULL, &next, &de)) == DW_DLV_OK) {
+			if (dwarf_siblingof(dbg, NULL, &die, &de) !=
+			    DW_DLV_OK)
+				errx(EXIT_FAILURE, "dwarf_siblingof: %s",
+				    dwarf_errmsg(de));
+			if ((r = dwarf_siblingof(dbg, die, &sib, &de)) ==
+			    DW_DLV_ERROR)
+				errx(EXIT_FAILURE, "dwarf_siblingof: %s",
+				    dwarf_errmsg(de));
+			if (r == DW_DLV_OK)
+				dwarf_dealloc(dbg, sib, DW_DLA_DIE);
+			dwarf_dealloc(dbg, die, DW_DLA_DIE);
+			n++;
+		}
+		if (r == DW_DLV_ERROR)
+			errx(EXIT_FAILURE, "dwarf_next_cu_header_b: %s",
+			    dwarf_errmsg(de));
+	}
+	bench_report("sibling", "dwarf_siblingof", n, bench_time() - t);
+
+	(void) dwarf_finish(dbg, &de);
+	(void) close(fd);
+	if (path != NULL) {
+		(void) unlink(path);
+		free(path);
+	}
+}
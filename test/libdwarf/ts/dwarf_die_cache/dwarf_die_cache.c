@@ -0,0 +1,352 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <assert.h>
+#include <dwarf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libdwarf.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver.h"
+#include "tet_api.h"
+
+/*
+ * Test case for the DIE cache: dwarf_set_die_cache_limit and
+ * dwarf_get_die_cache_stats.
+ */
+
+static void tp_dwarf_die_cache(void);
+static void tp_dwarf_die_cache_evict(void);
+static void tp_dwarf_die_cache_finish(void);
+static void tp_dwarf_die_cache_sanity(void);
+static struct dwarf_tp dwarf_tp_array[] = {
+	{"tp_dwarf_die_cache", tp_dwarf_die_cache},
+	{"tp_dwarf_die_cache_evict", tp_dwarf_die_cache_evict},
+	{"tp_dwarf_die_cache_finish", tp_dwarf_die_cache_finish},
+	{"tp_dwarf_die_cache_sanity", tp_dwarf_die_cache_sanity},
+	{NULL, NULL},
+};
+static int result = TET_UNRESOLVED;
+#include "driver.c"
+#include "die_traverse.c"
+
+#define	_MAX_DIE	8192
+static Dwarf_Off die_off[_MAX_DIE];
+static Dwarf_Half die_tag[_MAX_DIE];
+static int die_max;
+
+static void
+_dwarf_die_cache_collect(Dwarf_Die die)
+{
+	Dwarf_Error de;
+
+	if (die_max >= _MAX_DIE)
+		return;
+
+	if (dwarf_dieoffset(die, &die_off[die_max], &de) != DW_DLV_OK ||
+	    dwarf_tag(die, &die_tag[die_max], &de) != DW_DLV_OK) {
+		tet_printf("dwarf_dieoffset or dwarf_tag failed: %s\n",
+		    dwarf_errmsg(de));
+		result = TET_FAIL;
+		return;
+	}
+	die_max++;
+}
+
+static void
+tp_dwarf_die_cache(void)
+{
+#ifndef	TCGEN
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Die die, die0;
+	Dwarf_Half tag;
+	Dwarf_Off off;
+	Dwarf_Unsigned hits, misses;
+	int fd, i;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	die_max = 0;
+	_die_traverse(dbg, _dwarf_die_cache_collect);
+
+	tet_infoline("DIEs requested twice are returned from the cache");
+
+	(void) dwarf_set_die_cache_limit(dbg, 16);
+
+	for (i = 0; i < die_max; i++) {
+		if (dwarf_offdie(dbg, die_off[i], &die, &de) != DW_DLV_OK ||
+		    dwarf_offdie(dbg, die_off[i], &die0, &de) != DW_DLV_OK) {
+			tet_printf("dwarf_offdie failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+		if (die != die0) {
+			tet_printf("DIE at offset %#jx was not cached\n",
+			    (uintmax_t) die_off[i]);
+			result = TET_FAIL;
+		}
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		if (dwarf_dieoffset(die0, &off, &de) != DW_DLV_OK ||
+		    dwarf_tag(die0, &tag, &de) != DW_DLV_OK) {
+			tet_printf("dwarf_dieoffset or dwarf_tag failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+		if (off != die_off[i] || tag != die_tag[i]) {
+			tet_printf("cached DIE at offset %#jx differs\n",
+			    (uintmax_t) die_off[i]);
+			result = TET_FAIL;
+		}
+		dwarf_dealloc(dbg, die0, DW_DLA_DIE);
+	}
+
+	if (dwarf_get_die_cache_stats(dbg, &hits, &misses, &de) !=
+	    DW_DLV_OK) {
+		tet_printf("dwarf_get_die_cache_stats failed: %s\n",
+		    dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+	if (hits != (Dwarf_Unsigned) die_max ||
+	    misses != (Dwarf_Unsigned) die_max) {
+		tet_printf("unexpected cache statistics: hits %ju misses %ju"
+		    " DIEs %d\n", (uintmax_t) hits, (uintmax_t) misses,
+		    die_max);
+		result = TET_FAIL;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+#else
+	result = TET_PASS;
+#endif	/* !TCGEN */
+	TS_RESULT(result);
+}
+
+static void
+tp_dwarf_die_cache_evict(void)
+{
+#ifndef	TCGEN
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Die die, die0, die1;
+	Dwarf_Off off;
+	Dwarf_Unsigned hits, misses;
+	int fd;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	die_max = 0;
+	_die_traverse(dbg, _dwarf_die_cache_collect);
+	if (die_max < 2) {
+		tet_infoline("test object has too few DIEs");
+		goto done;
+	}
+
+	tet_infoline("evicted DIEs stay valid until deallocated");
+
+	/* The first two DIEs belong to the same compilation unit. */
+	(void) dwarf_set_die_cache_limit(dbg, 1);
+	if (dwarf_offdie(dbg, die_off[0], &die, &de) != DW_DLV_OK ||
+	    dwarf_offdie(dbg, die_off[1], &die0, &de) != DW_DLV_OK ||
+	    dwarf_offdie(dbg, die_off[0], &die1, &de) != DW_DLV_OK) {
+		tet_printf("dwarf_offdie failed: %s\n", dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+	if (die == die1) {
+		tet_infoline("evicted DIE was returned again");
+		result = TET_FAIL;
+	}
+	if (dwarf_dieoffset(die, &off, &de) != DW_DLV_OK ||
+	    off != die_off[0]) {
+		tet_infoline("evicted DIE is no longer valid");
+		result = TET_FAIL;
+	}
+	dwarf_dealloc(dbg, die, DW_DLA_DIE);
+	dwarf_dealloc(dbg, die0, DW_DLA_DIE);
+
+	/* Disabling the cache leaves returned DIEs valid. */
+	if (dwarf_set_die_cache_limit(dbg, 0) != 1) {
+		tet_infoline("dwarf_set_die_cache_limit did not return the"
+		    " previous limit");
+		result = TET_FAIL;
+	}
+	if (dwarf_dieoffset(die1, &off, &de) != DW_DLV_OK ||
+	    off != die_off[0]) {
+		tet_infoline("DIE is no longer valid after disabling the"
+		    " cache");
+		result = TET_FAIL;
+	}
+	dwarf_dealloc(dbg, die1, DW_DLA_DIE);
+
+	if (dwarf_get_die_cache_stats(dbg, &hits, &misses, &de) !=
+	    DW_DLV_OK) {
+		tet_printf("dwarf_get_die_cache_stats failed: %s\n",
+		    dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+	if (hits != 0 || misses != 3) {
+		tet_printf("unexpected cache statistics: hits %ju misses"
+		    " %ju\n", (uintmax_t) hits, (uintmax_t) misses);
+		result = TET_FAIL;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+#else
+	result = TET_PASS;
+#endif	/* !TCGEN */
+	TS_RESULT(result);
+}
+
+static void
+tp_dwarf_die_cache_finish(void)
+{
+#ifndef	TCGEN
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Die die, die0, die1;
+	Dwarf_Attribute *attrs;
+	Dwarf_Signed attrcount;
+	int fd;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	die_max = 0;
+	_die_traverse(dbg, _dwarf_die_cache_collect);
+	if (die_max < 2) {
+		tet_infoline("test object has too few DIEs");
+		goto done;
+	}
+
+	tet_infoline("DIEs can be deallocated after dwarf_finish");
+
+	(void) dwarf_set_die_cache_limit(dbg, 16);
+	if (dwarf_offdie(dbg, die_off[0], &die, &de) != DW_DLV_OK ||
+	    dwarf_offdie(dbg, die_off[0], &die0, &de) != DW_DLV_OK ||
+	    dwarf_offdie(dbg, die_off[1], &die1, &de) != DW_DLV_OK) {
+		tet_printf("dwarf_offdie failed: %s\n", dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+	if (dwarf_attrlist(die1, &attrs, &attrcount, &de) == DW_DLV_ERROR) {
+		tet_printf("dwarf_attrlist failed: %s\n", dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+
+	TS_DWARF_FINISH(dbg, de);
+	dbg = NULL;
+
+	dwarf_dealloc(NULL, die, DW_DLA_DIE);
+	dwarf_dealloc(NULL, die0, DW_DLA_DIE);
+	dwarf_dealloc(NULL, die1, DW_DLA_DIE);
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	if (dbg != NULL)
+		TS_DWARF_FINISH(dbg, de);
+#else
+	result = TET_PASS;
+#endif	/* !TCGEN */
+	TS_RESULT(result);
+}
+
+static void
+tp_dwarf_die_cache_sanity(void)
+{
+#ifndef	TCGEN
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Unsigned hits, misses;
+	int fd;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	if (dwarf_get_die_cache_stats(NULL, &hits, &misses, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_get_die_cache_stats didn't return"
+		    " DW_DLV_ERROR when called with NULL dbg");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_get_die_cache_stats(dbg, NULL, &misses, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_get_die_cache_stats didn't return"
+		    " DW_DLV_ERROR when called with NULL hits");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_get_die_cache_stats(dbg, &hits, &misses, &de) !=
+	    DW_DLV_OK || hits != 0 || misses != 0) {
+		tet_infoline("DIE cache is not initially empty");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_set_die_cache_limit(dbg, 8) != 0) {
+		tet_infoline("DIE cache is not initially disabled");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+#else
+	result = TET_PASS;
+#endif	/* !TCGEN */
+	TS_RESULT(result);
+}
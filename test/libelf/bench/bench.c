@@ -0,0 +1,214 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * A driver for libelf benchmarks.
+ */
+
+#include <err.h>
+#include <libelf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "_elftc.h"
+
+#include "bench.h"
+
+static struct bench_scenario scenarios[] = {
+	{ "advise", "scan a 64MB object, cold and warm, with access advice",
+	  bench_advise },
+	{ "archive", "iterate over the members of an archive",
+	  bench_archive },
+	{ "checksum", "checksum a 1GB object", bench_checksum },
+	{ "getscn", "look up every section by index", bench_getscn },
+	{ "hash", "hash the names of 1M symbols", bench_hash },
+	{ "note", "open an object 1000 times, reading one note section",
+	  bench_note },
+	{ "open", "open an object 1000 times, reading its 1000 sections",
+	  bench_open },
+	{ "strptr", "look up the names of all sections, 20 times",
+	  bench_strptr },
+	{ "symbols", "read a symbol table, and look up all symbol names",
+	  bench_symbols },
+	{ "update", "lay out an object, and update one section in place",
+	  bench_update },
+	{ NULL, NULL, NULL }
+};
+
+double
+bench_time(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(EXIT_FAILURE, "clock_gettime");
+
+	return ((double) ts.tv_sec + (double) ts.tv_nsec / 1e9);
+}
+
+char *
+bench_path(const struct bench_options *bo, const char *name)
+{
+	char *p;
+	size_t sz;
+
+	sz = strlen(bo->bo_dir) + strlen(name) + 2;
+	if ((p = malloc(sz)) == NULL)
+		err(EXIT_FAILURE, "malloc");
+	(void) snprintf(p, sz, "%s/%s", bo->bo_dir, name);
+
+	return (p);
+}
+
+/*
+ * Each result is printed as one line with four fields: the scenario,
+ * the variant measured, the number of operations performed and the
+ * elapsed time in seconds.  Lines starting with '#' are comments.
+ */
+void
+bench_report(const char *scenario, const char *variant, size_t count,
+    double seconds)
+{
+	(void) printf("%-12s %-16s %10zu %12.6f\n", scenario, variant, count,
+	    seconds);
+}
+
+/*
+ * Initialize an object specification from the command line options.
+ */
+void
+bench_spec_init(struct bench_elf_spec *bs, const struct bench_options *bo)
+{
+	bs->bs_class = bo->bo_class;
+	bs->bs_byteorder = bo->bo_byteorder;
+	bs->bs_nscn = bo->bo_nscn;
+	bs->bs_scnsize = 16;
+	bs->bs_note = 0;
+	bs->bs_nsym = 0;
+	bs->bs_namelen = 0;
+}
+
+static void
+usage(void)
+{
+	struct bench_scenario *bn;
+
+	(void) fprintf(stderr, "usage: %s [-b] [-c 32|64] [-d dir] "
+	    "[-l namelen] [-m members] [-n sections] [-r repeat]\n"
+	    "       [-s symbols] [scenario...]\n", ELFTC_GETPROGNAME());
+	for (bn = scenarios; bn->bn_name; bn++)
+		(void) fprintf(stderr, "  %-12s %s\n", bn->bn_name,
+		    bn->bn_descr);
+	exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char **argv)
+{
+	int i, opt;
+	struct bench_options bo;
+	struct bench_scenario *bn;
+
+	bo.bo_dir = ".";
+	bo.bo_class = ELFCLASS64;
+	bo.bo_byteorder = ELFDATA2LSB;
+	bo.bo_nscn = 200000;
+	bo.bo_nsym = 1000000;
+	bo.bo_namelen = 0;
+	bo.bo_nmember = 10000;
+	bo.bo_repeat = 1;
+
+	while ((opt = getopt(argc, argv, "bc:d:l:m:n:r:s:")) != -1) {
+		switch (opt) {
+		case 'b':
+			bo.bo_byteorder = ELFDATA2MSB;
+			break;
+		case 'c':
+			if (strcmp(optarg, "32") == 0)
+				bo.bo_class = ELFCLASS32;
+			else if (strcmp(optarg, "64") == 0)
+				bo.bo_class = ELFCLASS64;
+			else
+				usage();
+			break;
+		case 'd':
+			bo.bo_dir = optarg;
+			break;
+		case 'l':
+			bo.bo_namelen = (size_t) strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			bo.bo_nmember = (size_t) strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			bo.bo_nscn = (size_t) strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			bo.bo_repeat = atoi(optarg);
+			break;
+		case 's':
+			bo.bo_nsym = (size_t) strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (bo.bo_nscn == 0 || bo.bo_nsym == 0 || bo.bo_nmember == 0 ||
+	    bo.bo_repeat <= 0)
+		usage();
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(EXIT_FAILURE, "elf_version: %s", elf_errmsg(-1));
+
+	(void) printf("# class=%d byteorder=%s sections=%zu symbols=%zu "
+	    "namelen=%zu members=%zu repeat=%d\n",
+	    bo.bo_class == ELFCLASS32 ? 32 : 64,
+	    bo.bo_byteorder == ELFDATA2MSB ? "msb" : "lsb", bo.bo_nscn,
+	    bo.bo_nsym, bo.bo_namelen, bo.bo_nmember, bo.bo_repeat);
+	(void) printf("# scenario variant count seconds\n");
+
+	for (bn = scenarios; bn->bn_name; bn++) {
+		if (argc > 0) {
+			for (i = 0; i < argc; i++)
+				if (strcmp(argv[i], bn->bn_name) == 0)
+					break;
+			if (i == argc)
+				continue;
+		}
+		(*bn->bn_fn)(&bo);
+	}
+
+	exit(EXIT_SUCCESS);
+}
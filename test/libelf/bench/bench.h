@@ -0,0 +1,90 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#ifndef	_BENCH_H_
+#define	_BENCH_H_
+
+#include <stddef.h>
+
+/*
+ * Parameters for a synthetic ELF object.
+ */
+struct bench_elf_spec {
+	int		bs_class;	/* ELFCLASS32 or ELFCLASS64 */
+	int		bs_byteorder;	/* ELFDATA2LSB or ELFDATA2MSB */
+	size_t		bs_nscn;	/* number of SHT_PROGBITS sections */
+	size_t		bs_scnsize;	/* size of each PROGBITS section */
+	int		bs_note;	/* make section 1 a build-id note */
+	size_t		bs_nsym;	/* number of symbols, or zero */
+	size_t		bs_namelen;	/* minimum length of symbol names */
+};
+
+/*
+ * Options common to all benchmark scenarios.
+ */
+struct bench_options {
+	const char	*bo_dir;	/* directory for generated files */
+	int		bo_class;	/* ELF class of generated objects */
+	int		bo_byteorder;	/* byte order of generated objects */
+	size_t		bo_nscn;	/* number of sections */
+	size_t		bo_nsym;	/* number of symbols */
+	size_t		bo_namelen;	/* minimum length of symbol names */
+	size_t		bo_nmember;	/* number of archive members */
+	int		bo_repeat;	/* number of timed iterations */
+};
+
+typedef void bench_fn(const struct bench_options *_bo);
+
+struct bench_scenario {
+	const char	*bn_name;
+	const char	*bn_descr;
+	bench_fn	*bn_fn;
+};
+
+void	bench_gen_ar(const char *_path, const struct bench_elf_spec *_bs,
+    size_t _nmember);
+void	bench_gen_elf(const char *_path, const struct bench_elf_spec *_bs);
+char	*bench_path(const struct bench_options *_bo, const char *_name);
+void	bench_report(const char *_scenario, const char *_variant,
+    size_t _count, double _seconds);
+void	bench_spec_init(struct bench_elf_spec *_bs,
+    const struct bench_options *_bo);
+double	bench_time(void);
+
+bench_fn	bench_advise;
+bench_fn	bench_archive;
+bench_fn	bench_checksum;
+bench_fn	bench_getscn;
+bench_fn	bench_hash;
+bench_fn	bench_note;
+bench_fn	bench_open;
+bench_fn	bench_strptr;
+bench_fn	bench_symbols;
+bench_fn	bench_update;
+
+#endif	/* _BENCH_H_ */
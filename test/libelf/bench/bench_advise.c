@@ -0,0 +1,175 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for scans of an object with and without access advice,
+ * starting from a cold and from a warm page cache.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define	BENCH_ADVISE_NSCN	1024
+#define	BENCH_ADVISE_SCNSIZE	(64 * 1024)
+
+/* Advise the section following the one being read. */
+#define	BENCH_ADVISE_AHEAD	(-1)
+
+static const struct {
+	const char	*ba_name;
+	int		ba_advice;
+} bench_advice[] = {
+	{ "none",	-2 },
+	{ "normal",	ELF_ADV_NORMAL },
+	{ "sequential",	ELF_ADV_SEQUENTIAL },
+	{ "random",	ELF_ADV_RANDOM },
+	{ "willneed",	ELF_ADV_WILLNEED },
+	{ "ahead",	BENCH_ADVISE_AHEAD },
+	{ "populate",	ELF_ADV_POPULATE },
+	{ "hugepage",	ELF_ADV_HUGEPAGE },
+	{ NULL,		0 }
+};
+
+/*
+ * Remove the pages of file `path' from the page cache, so that the
+ * next scan reads it from storage.  Returns zero if this is not
+ * possible.
+ */
+static int
+drop_cache(const char *path)
+{
+#if	defined(POSIX_FADV_DONTNEED)
+	int fd, r;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+	r = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	(void) close(fd);
+
+	return (r);
+#else
+	(void) path;
+	return (0);
+#endif
+}
+
+/*
+ * Open `path', apply `advice' and read every byte of every section.
+ */
+static unsigned int
+scan(const char *path, int advice)
+{
+	Elf *e;
+	int fd;
+	Elf_Data *d;
+	Elf_Scn *scn, *next;
+	unsigned int sum;
+	const unsigned char *p, *q;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+	    elf_flagelf(e, ELF_C_SET, ELF_F_READONLY) == 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	if (advice >= ELF_ADV_FIRST && elf_advise(e, advice) != 0)
+		errx(EXIT_FAILURE, "elf_advise: %s", elf_errmsg(-1));
+
+	sum = 0;
+	for (scn = elf_nextscn(e, NULL); scn != NULL; scn = next) {
+		next = elf_nextscn(e, scn);
+		if (advice == BENCH_ADVISE_AHEAD && next != NULL &&
+		    elf_advisescn(next, ELF_ADV_WILLNEED) != 0)
+			errx(EXIT_FAILURE, "elf_advisescn: %s",
+			    elf_errmsg(-1));
+		if ((d = elf_getdata(scn, NULL)) == NULL)
+			errx(EXIT_FAILURE, "elf_getdata: %s", elf_errmsg(-1));
+		for (p = d->d_buf, q = p + d->d_size; p < q; p++)
+			sum += *p;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	return (sum);
+}
+
+void
+bench_advise(const struct bench_options *bo)
+{
+	int i, r;
+	char *path;
+	double t;
+	unsigned int ref, sum;
+	char variant[32];
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+	bs.bs_nscn = BENCH_ADVISE_NSCN;
+	bs.bs_scnsize = BENCH_ADVISE_SCNSIZE;
+
+	path = bench_path(bo, "advise.o");
+	bench_gen_elf(path, &bs);
+
+	/* Every scan is checked against the first, to keep it honest. */
+	ref = scan(path, ELF_ADV_NORMAL);
+
+	for (i = 0; bench_advice[i].ba_name != NULL; i++) {
+		if (drop_cache(path)) {
+			t = bench_time();
+			sum = scan(path, bench_advice[i].ba_advice);
+			(void) snprintf(variant, sizeof(variant), "cold/%s",
+			    bench_advice[i].ba_name);
+			bench_report("advise", variant, BENCH_ADVISE_NSCN,
+			    bench_time() - t);
+			if (sum != ref)
+				errx(EXIT_FAILURE, "\"%s\": inconsistent "
+				    "contents", path);
+		}
+
+		t = bench_time();
+		for (r = 0; r < bo->bo_repeat; r++)
+			if (scan(path, bench_advice[i].ba_advice) != ref)
+				errx(EXIT_FAILURE, "\"%s\": inconsistent "
+				    "contents", path);
+		(void) snprintf(variant, sizeof(variant), "warm/%s",
+		    bench_advice[i].ba_name);
+		bench_report("advise", variant,
+		    (size_t) bo->bo_repeat * BENCH_ADVISE_NSCN,
+		    bench_time() - t);
+	}
+
+	(void) unlink(path);
+	free(path);
+}
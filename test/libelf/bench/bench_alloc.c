@@ -0,0 +1,140 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for the allocation of descriptors when objects are
+ * repeatedly opened and closed, as ranlib(1) and nm(1) do for the
+ * members of large archives.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define	BENCH_OPEN_NSCN		1000
+#define	BENCH_OPEN_OPENS	1000
+
+/*
+ * Measure the heap memory held by an open object, using the
+ * allocator statistics that glibc provides.
+ */
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || \
+    (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+
+#define	BENCH_HAVE_HEAP_SIZE	1
+
+static size_t
+bench_heap_size(void)
+{
+	return (mallinfo2().uordblks);
+}
+#else
+#define	BENCH_HAVE_HEAP_SIZE	0
+
+static size_t
+bench_heap_size(void)
+{
+	return (0);
+}
+#endif
+
+static Elf *
+open_object(int fd, const char *path, unsigned int flags)
+{
+	Elf *e;
+	Elf_Scn *scn;
+
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+	    elf_flagelf(e, ELF_C_SET, flags) != flags)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+	for (scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; )
+		if (elf_getdata(scn, NULL) == NULL)
+			errx(EXIT_FAILURE, "elf_getdata: %s", elf_errmsg(-1));
+
+	return (e);
+}
+
+static void
+time_open(const struct bench_options *bo, int fd, const char *path,
+    const char *variant, unsigned int flags)
+{
+	Elf *e;
+	double t;
+	int r;
+	size_t heap, i, n;
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		for (i = 0; i < BENCH_OPEN_OPENS; i++, n++)
+			(void) elf_end(open_object(fd, path, flags));
+	bench_report("open", variant, n, bench_time() - t);
+
+	/*
+	 * Report the heap memory held by one open object, outside of
+	 * the timed loop.
+	 */
+	if (BENCH_HAVE_HEAP_SIZE) {
+		heap = bench_heap_size();
+		e = open_object(fd, path, flags);
+		heap = bench_heap_size() - heap;
+		(void) elf_end(e);
+		(void) printf("%-12s %-16s %10d %12zu\n", "open", "heap-bytes",
+		    1, heap);
+	}
+}
+
+void
+bench_open(const struct bench_options *bo)
+{
+	int fd;
+	char *path;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+	bs.bs_nscn = BENCH_OPEN_NSCN;
+
+	path = bench_path(bo, "open.o");
+	bench_gen_elf(path, &bs);
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	time_open(bo, fd, path, "getdata", 0);
+	time_open(bo, fd, path, "getdata-readonly", ELF_F_READONLY);
+
+	(void) close(fd);
+	(void) unlink(path);
+	free(path);
+}
@@ -0,0 +1,120 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for archive iteration.
+ */
+
+#include <ar.h>
+#include <err.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define	BENCH_AR_NSCN		16
+
+/*
+ * Iterate over the members of an archive, once opening each member
+ * only, and once also reading its section headers.
+ */
+static size_t
+bench_ar_iterate(int fd, Elf *ar, const char *path, int getscn)
+{
+	Elf *e;
+	int error;
+	size_t n, shnum;
+	Elf_Cmd cmd;
+
+	n = 0;
+	cmd = ELF_C_READ;
+	while ((e = elf_begin(fd, cmd, ar)) != NULL) {
+		if (getscn && (elf_getshdrnum(e, &shnum) != 0 ||
+		    elf_getscn(e, shnum - 1) == NULL))
+			errx(EXIT_FAILURE, "\"%s\": %s", path,
+			    elf_errmsg(-1));
+		cmd = elf_next(e);
+		(void) elf_end(e);
+		n++;
+	}
+
+	if ((error = elf_errno()) != 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(error));
+
+	return (n);
+}
+
+void
+bench_archive(const struct bench_options *bo)
+{
+	Elf *ar;
+	int fd, r;
+	char *path;
+	double t;
+	size_t n;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+	bs.bs_nscn = BENCH_AR_NSCN;
+
+	path = bench_path(bo, "archive.a");
+	bench_gen_ar(path, &bs, bo->bo_nmember);
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	if ((ar = elf_begin(fd, ELF_C_READ, NULL)) == NULL)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+	if (elf_kind(ar) != ELF_K_AR)
+		errx(EXIT_FAILURE, "\"%s\": not an archive", path);
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++) {
+		if (elf_rand(ar, SARMAG) != SARMAG)
+			errx(EXIT_FAILURE, "elf_rand: %s", elf_errmsg(-1));
+		n += bench_ar_iterate(fd, ar, path, 0);
+	}
+	bench_report("archive", "elf_next", n, bench_time() - t);
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++) {
+		if (elf_rand(ar, SARMAG) != SARMAG)
+			errx(EXIT_FAILURE, "elf_rand: %s", elf_errmsg(-1));
+		n += bench_ar_iterate(fd, ar, path, 1);
+	}
+	bench_report("archive", "elf_getscn", n, bench_time() - t);
+
+	(void) elf_end(ar);
+	(void) close(fd);
+	(void) unlink(path);
+	free(path);
+}
@@ -0,0 +1,131 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for the checksum of a large object.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/* A 1GB object. */
+#define	BENCH_CHECKSUM_NSCN	1024
+#define	BENCH_CHECKSUM_SCNSIZE	(1024 * 1024)
+
+/*
+ * Compute the checksum of `e' a byte at a time, the way gelf_checksum()
+ * used to.
+ */
+static long
+checksum_bytes(Elf *e)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	unsigned long c;
+	const unsigned char *p, *q;
+
+	c = 0;
+	for (scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; ) {
+		if (gelf_getshdr(scn, &sh) == NULL)
+			errx(EXIT_FAILURE, "gelf_getshdr: %s", elf_errmsg(-1));
+		if ((sh.sh_flags & SHF_ALLOC) == 0 ||
+		    sh.sh_type == SHT_DYNAMIC || sh.sh_type == SHT_DYNSYM)
+			continue;
+		for (d = NULL; (d = elf_rawdata(scn, d)) != NULL; )
+			for (p = d->d_buf, q = p + d->d_size; p < q; p++)
+				c += *p;
+	}
+
+	return ((long) (((c >> 16) & 0xFFFFUL) + (c & 0xFFFFUL)));
+}
+
+static void
+time_checksum(const struct bench_options *bo, const char *path,
+    const char *variant, long (*fn)(Elf *), long ref)
+{
+	Elf *e;
+	int fd, r;
+	double t;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++) {
+		if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL)
+			errx(EXIT_FAILURE, "\"%s\": %s", path,
+			    elf_errmsg(-1));
+		if ((*fn)(e) != ref)
+			errx(EXIT_FAILURE, "\"%s\": inconsistent checksum",
+			    path);
+		(void) elf_end(e);
+	}
+	bench_report("checksum", variant,
+	    (size_t) bo->bo_repeat * BENCH_CHECKSUM_NSCN, bench_time() - t);
+
+	(void) close(fd);
+}
+
+void
+bench_checksum(const struct bench_options *bo)
+{
+	Elf *e;
+	int fd;
+	long ref;
+	char *path;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+	bs.bs_nscn = BENCH_CHECKSUM_NSCN;
+	bs.bs_scnsize = BENCH_CHECKSUM_SCNSIZE;
+
+	path = bench_path(bo, "checksum.o");
+	bench_gen_elf(path, &bs);
+
+	/* Compute the reference value, warming the page cache. */
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+	ref = checksum_bytes(e);
+	(void) elf_end(e);
+	(void) close(fd);
+
+	time_checksum(bo, path, "bytewise", checksum_bytes, ref);
+	time_checksum(bo, path, "gelf_checksum", gelf_checksum, ref);
+
+	(void) unlink(path);
+	free(path);
+}
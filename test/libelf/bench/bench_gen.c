@@ -0,0 +1,406 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Generate synthetic ELF objects for benchmarks.
+ *
+ * Objects are written out byte-by-byte instead of through libelf, so
+ * that the generator does not depend on the code being measured.
+ */
+
+#include <ar.h>
+#include <err.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+struct bench_buf {
+	unsigned char	*bb_buf;
+	size_t		bb_size;	/* number of bytes in use */
+	size_t		bb_cap;		/* allocated size */
+	int		bb_msb;		/* use big-endian byte order */
+};
+
+static void
+bb_init(struct bench_buf *bb, int byteorder)
+{
+	bb->bb_buf = NULL;
+	bb->bb_size = bb->bb_cap = 0;
+	bb->bb_msb = (byteorder == ELFDATA2MSB);
+}
+
+static unsigned char *
+bb_reserve(struct bench_buf *bb, size_t n)
+{
+	unsigned char *p;
+
+	if (bb->bb_size + n > bb->bb_cap) {
+		bb->bb_cap = bb->bb_cap ? bb->bb_cap : 4096;
+		while (bb->bb_size + n > bb->bb_cap)
+			bb->bb_cap *= 2;
+		if ((bb->bb_buf = realloc(bb->bb_buf, bb->bb_cap)) == NULL)
+			err(EXIT_FAILURE, "realloc");
+	}
+
+	p = bb->bb_buf + bb->bb_size;
+	bb->bb_size += n;
+
+	return (p);
+}
+
+static void
+bb_bytes(struct bench_buf *bb, const void *src, size_t n)
+{
+	(void) memcpy(bb_reserve(bb, n), src, n);
+}
+
+/* Append an integer of `width' bytes in the buffer's byte order. */
+static void
+bb_put(struct bench_buf *bb, uint64_t v, size_t width)
+{
+	size_t i;
+	unsigned char *p;
+
+	p = bb_reserve(bb, width);
+	for (i = 0; i < width; i++, v >>= 8)
+		p[bb->bb_msb ? width - i - 1 : i] = (unsigned char) (v & 0xFF);
+}
+
+static void
+bb_align(struct bench_buf *bb, size_t align)
+{
+	size_t pad;
+
+	if ((pad = bb->bb_size % align) != 0)
+		(void) memset(bb_reserve(bb, align - pad), 0, align - pad);
+}
+
+/* Append a string, returning its offset in the buffer. */
+static size_t
+bb_string(struct bench_buf *bb, const char *s)
+{
+	size_t off;
+
+	off = bb->bb_size;
+	bb_bytes(bb, s, strlen(s) + 1);
+
+	return (off);
+}
+
+struct bench_shdr {
+	uint32_t	sh_name;
+	uint32_t	sh_type;
+	uint64_t	sh_flags;
+	uint64_t	sh_offset;
+	uint64_t	sh_size;
+	uint32_t	sh_link;
+	uint32_t	sh_info;
+	uint64_t	sh_addralign;
+	uint64_t	sh_entsize;
+};
+
+static void
+bb_shdr(struct bench_buf *bb, int ec, const struct bench_shdr *sh)
+{
+	size_t w;
+
+	w = (ec == ELFCLASS32) ? 4 : 8;
+
+	bb_put(bb, sh->sh_name, 4);
+	bb_put(bb, sh->sh_type, 4);
+	bb_put(bb, sh->sh_flags, w);
+	bb_put(bb, 0, w);			/* sh_addr */
+	bb_put(bb, sh->sh_offset, w);
+	bb_put(bb, sh->sh_size, w);
+	bb_put(bb, sh->sh_link, 4);
+	bb_put(bb, sh->sh_info, 4);
+	bb_put(bb, sh->sh_addralign, w);
+	bb_put(bb, sh->sh_entsize, w);
+}
+
+static void
+bb_sym(struct bench_buf *bb, int ec, uint32_t name, uint64_t value,
+    uint64_t size, unsigned char info, uint16_t shndx)
+{
+	if (ec == ELFCLASS32) {
+		bb_put(bb, name, 4);
+		bb_put(bb, value, 4);
+		bb_put(bb, size, 4);
+		bb_put(bb, info, 1);
+		bb_put(bb, 0, 1);		/* st_other */
+		bb_put(bb, shndx, 2);
+	} else {
+		bb_put(bb, name, 4);
+		bb_put(bb, info, 1);
+		bb_put(bb, 0, 1);		/* st_other */
+		bb_put(bb, shndx, 2);
+		bb_put(bb, value, 8);
+		bb_put(bb, size, 8);
+	}
+}
+
+/*
+ * Append the symbol table described by `bs' to `f', and the names of
+ * its symbols to the string table `st'.
+ *
+ * Symbol names are "s<n>", padded with underscores to `bs_namelen'
+ * bytes, and symbols are spread over the PROGBITS sections that do not
+ * need extended section indices.
+ */
+static void
+bench_gen_symtab(struct bench_buf *f, struct bench_buf *st,
+    const struct bench_elf_spec *bs)
+{
+	char *name;
+	size_t i, len, nshndx, sz;
+	uint16_t shndx;
+
+	sz = bs->bs_namelen > 32 ? bs->bs_namelen + 1 : 33;
+	if ((name = malloc(sz)) == NULL)
+		err(EXIT_FAILURE, "malloc");
+
+	nshndx = bs->bs_nscn < SHN_LORESERVE - 1 ? bs->bs_nscn :
+	    SHN_LORESERVE - 1;
+
+	(void) bb_string(st, "");
+	bb_sym(f, bs->bs_class, 0, 0, 0, 0, SHN_UNDEF);
+
+	for (i = 0; i < bs->bs_nsym; i++) {
+		len = (size_t) snprintf(name, sz, "s%zu", i);
+		if (len < bs->bs_namelen) {
+			(void) memset(name + len, '_', bs->bs_namelen - len);
+			name[bs->bs_namelen] = '\0';
+		}
+		shndx = nshndx ? (uint16_t) (1 + i % nshndx) : SHN_ABS;
+		bb_sym(f, bs->bs_class, (uint32_t) bb_string(st, name),
+		    (uint64_t) i * 16, 16,
+		    (unsigned char) ELF64_ST_INFO(STB_GLOBAL, STT_FUNC), shndx);
+	}
+
+	free(name);
+}
+
+/*
+ * Build the object described by `bs' in `f'.
+ */
+static void
+bench_gen_image(struct bench_buf *f, const struct bench_elf_spec *bs)
+{
+	int ec;
+	char name[32];
+	unsigned char *ident;
+	struct bench_shdr *sh;
+	struct bench_buf s, st;
+	size_t i, ehsz, nscn, shnum, shoff, shstrndx, strndx, symndx, w;
+
+	ec = bs->bs_class;
+	w = (ec == ELFCLASS32) ? 4 : 8;
+	ehsz = (ec == ELFCLASS32) ? 52 : 64;
+
+	/* Section 0, the PROGBITS sections, [.symtab, .strtab,] .shstrtab. */
+	nscn = bs->bs_nscn;
+	symndx = bs->bs_nsym ? nscn + 1 : 0;
+	strndx = bs->bs_nsym ? nscn + 2 : 0;
+	shnum = nscn + (bs->bs_nsym ? 4 : 2);
+	shstrndx = shnum - 1;
+
+	if ((sh = calloc(shnum, sizeof(*sh))) == NULL)
+		err(EXIT_FAILURE, "calloc");
+
+	bb_init(f, bs->bs_byteorder);
+	bb_init(&s, bs->bs_byteorder);
+	bb_init(&st, bs->bs_byteorder);
+
+	/* Leave space for the ELF header. */
+	(void) memset(bb_reserve(f, ehsz), 0, ehsz);
+
+	(void) bb_string(&s, "");
+
+	for (i = 1; i <= nscn; i++) {
+		if (i == 1 && bs->bs_note) {
+			sh[i].sh_name = (uint32_t) bb_string(&s,
+			    ".note.gnu.build-id");
+			sh[i].sh_type = SHT_NOTE;
+			sh[i].sh_flags = SHF_ALLOC;
+			sh[i].sh_addralign = 4;
+
+			bb_align(f, 4);
+			sh[i].sh_offset = f->bb_size;
+			bb_put(f, 4, 4);		/* n_namesz */
+			bb_put(f, 20, 4);		/* n_descsz */
+			bb_put(f, NT_GNU_BUILD_ID, 4);
+			bb_bytes(f, "GNU", 4);
+			(void) memset(bb_reserve(f, 20), 0xA5, 20);
+			sh[i].sh_size = f->bb_size - sh[i].sh_offset;
+			continue;
+		}
+
+		(void) snprintf(name, sizeof(name), ".text.f%zu", i);
+		sh[i].sh_name = (uint32_t) bb_string(&s, name);
+		sh[i].sh_type = SHT_PROGBITS;
+		sh[i].sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+		sh[i].sh_addralign = w;
+
+		bb_align(f, w);
+		sh[i].sh_offset = f->bb_size;
+		sh[i].sh_size = bs->bs_scnsize;
+		(void) memset(bb_reserve(f, bs->bs_scnsize), (int) (i & 0xFF),
+		    bs->bs_scnsize);
+	}
+
+	if (bs->bs_nsym) {
+		sh[symndx].sh_name = (uint32_t) bb_string(&s, ".symtab");
+		sh[symndx].sh_type = SHT_SYMTAB;
+		sh[symndx].sh_link = (uint32_t) strndx;
+		sh[symndx].sh_info = 1;		/* All symbols are global. */
+		sh[symndx].sh_addralign = w;
+		sh[symndx].sh_entsize = (ec == ELFCLASS32) ? 16 : 24;
+
+		bb_align(f, w);
+		sh[symndx].sh_offset = f->bb_size;
+		bench_gen_symtab(f, &st, bs);
+		sh[symndx].sh_size = f->bb_size - sh[symndx].sh_offset;
+
+		sh[strndx].sh_name = (uint32_t) bb_string(&s, ".strtab");
+		sh[strndx].sh_type = SHT_STRTAB;
+		sh[strndx].sh_addralign = 1;
+		sh[strndx].sh_offset = f->bb_size;
+		sh[strndx].sh_size = st.bb_size;
+		bb_bytes(f, st.bb_buf, st.bb_size);
+	}
+
+	sh[shstrndx].sh_name = (uint32_t) bb_string(&s, ".shstrtab");
+	sh[shstrndx].sh_type = SHT_STRTAB;
+	sh[shstrndx].sh_addralign = 1;
+	sh[shstrndx].sh_offset = f->bb_size;
+	sh[shstrndx].sh_size = s.bb_size;
+	bb_bytes(f, s.bb_buf, s.bb_size);
+
+	/* Use extended section numbering if needed. */
+	if (shnum >= SHN_LORESERVE) {
+		sh[0].sh_size = shnum;
+		sh[0].sh_link = (uint32_t) shstrndx;
+	}
+
+	bb_align(f, w);
+	shoff = f->bb_size;
+	for (i = 0; i < shnum; i++)
+		bb_shdr(f, ec, &sh[i]);
+
+	/* Fill in the ELF header. */
+	s.bb_size = 0;
+	ident = bb_reserve(&s, EI_NIDENT);
+	(void) memset(ident, 0, EI_NIDENT);
+	ident[EI_MAG0] = ELFMAG0;
+	ident[EI_MAG1] = ELFMAG1;
+	ident[EI_MAG2] = ELFMAG2;
+	ident[EI_MAG3] = ELFMAG3;
+	ident[EI_CLASS] = (unsigned char) ec;
+	ident[EI_DATA] = (unsigned char) bs->bs_byteorder;
+	ident[EI_VERSION] = EV_CURRENT;
+
+	bb_put(&s, ET_REL, 2);
+	bb_put(&s, EM_NONE, 2);
+	bb_put(&s, EV_CURRENT, 4);
+	bb_put(&s, 0, w);			/* e_entry */
+	bb_put(&s, 0, w);			/* e_phoff */
+	bb_put(&s, shoff, w);
+	bb_put(&s, 0, 4);			/* e_flags */
+	bb_put(&s, ehsz, 2);
+	bb_put(&s, 0, 2);			/* e_phentsize */
+	bb_put(&s, 0, 2);			/* e_phnum */
+	bb_put(&s, ec == ELFCLASS32 ? 40 : 64, 2);
+	bb_put(&s, shnum >= SHN_LORESERVE ? 0 : shnum, 2);
+	bb_put(&s, shnum >= SHN_LORESERVE ? SHN_XINDEX : shstrndx, 2);
+	(void) memcpy(f->bb_buf, s.bb_buf, ehsz);
+
+	free(s.bb_buf);
+	free(st.bb_buf);
+	free(sh);
+}
+
+static void
+bench_write(const char *path, const struct bench_buf *bb)
+{
+	int fd;
+
+	if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+	if (write(fd, bb->bb_buf, bb->bb_size) != (ssize_t) bb->bb_size)
+		err(EXIT_FAILURE, "write \"%s\"", path);
+	(void) close(fd);
+}
+
+void
+bench_gen_elf(const char *path, const struct bench_elf_spec *bs)
+{
+	struct bench_buf f;
+
+	bench_gen_image(&f, bs);
+	bench_write(path, &f);
+	free(f.bb_buf);
+}
+
+/*
+ * Generate an archive with `nmember' copies of the object described
+ * by `bs'.  The archive has no symbol table.
+ */
+void
+bench_gen_ar(const char *path, const struct bench_elf_spec *bs,
+    size_t nmember)
+{
+	size_t i;
+	char hdr[sizeof(struct ar_hdr) + 1], name[sizeof(hdr)];
+	struct bench_buf a, f;
+
+	bench_gen_image(&f, bs);
+
+	bb_init(&a, bs->bs_byteorder);
+	bb_bytes(&a, ARMAG, SARMAG);
+
+	for (i = 0; i < nmember; i++) {
+		(void) snprintf(name, sizeof(name), "m%zu.o/", i);
+		(void) snprintf(hdr, sizeof(hdr), "%-16.16s%-12d%-6d%-6d%-8o"
+		    "%-10zu%s", name, 0, 0, 0, 0644, f.bb_size, ARFMAG);
+		bb_bytes(&a, hdr, sizeof(struct ar_hdr));
+		bb_bytes(&a, f.bb_buf, f.bb_size);
+		if (a.bb_size % 2)
+			bb_bytes(&a, "\n", 1);
+	}
+
+	bench_write(path, &a);
+
+	free(a.bb_buf);
+	free(f.bb_buf);
+}
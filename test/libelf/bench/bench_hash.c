@@ -0,0 +1,135 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for hashing the names in a large symbol table.
+ */
+
+#include <err.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+/* The dynamic symbol table of a large DSO. */
+#define	BENCH_HASH_NSYM		(1024 * 1024)
+
+/*
+ * Hash each name separately, the way .hash and .gnu.hash section
+ * producers usually do.
+ */
+static void
+hash_each(const char *strtab, const size_t *offsets, size_t count,
+    uint32_t *sysv, uint32_t *gnu)
+{
+	const unsigned char *s;
+	uint32_t h;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		sysv[i] = (uint32_t) elf_hash(strtab + offsets[i]);
+		h = 5381;
+		for (s = (const unsigned char *) strtab + offsets[i];
+		     *s != '\0'; s++)
+			h = h * 33 + *s;
+		gnu[i] = h;
+	}
+}
+
+static void
+hash_batch(const char *strtab, size_t strsz, const size_t *offsets,
+    size_t count, uint32_t *sysv, uint32_t *gnu)
+{
+	if (elf_hashstrings(strtab, strsz, offsets, count, sysv, gnu) < 0)
+		errx(EXIT_FAILURE, "elf_hashstrings: %s", elf_errmsg(-1));
+}
+
+void
+bench_hash(const struct bench_options *bo)
+{
+	char *strtab, *p;
+	size_t i, j, len, strsz, *offsets;
+	uint32_t *sysv, *gnu, *refsysv, *refgnu;
+	double t;
+	int r;
+
+	/*
+	 * Build a string table holding names of varying length, in
+	 * the style of C++ mangled names.
+	 */
+	srandom(1);
+	strsz = 1 + BENCH_HASH_NSYM * 64;
+	if ((strtab = malloc(strsz)) == NULL ||
+	    (offsets = malloc(BENCH_HASH_NSYM * sizeof(*offsets))) == NULL ||
+	    (sysv = malloc(BENCH_HASH_NSYM * sizeof(*sysv))) == NULL ||
+	    (gnu = malloc(BENCH_HASH_NSYM * sizeof(*gnu))) == NULL ||
+	    (refsysv = malloc(BENCH_HASH_NSYM * sizeof(*sysv))) == NULL ||
+	    (refgnu = malloc(BENCH_HASH_NSYM * sizeof(*gnu))) == NULL)
+		err(EXIT_FAILURE, "malloc");
+
+	p = strtab;
+	*p++ = '\0';
+	for (i = 0; i < BENCH_HASH_NSYM; i++) {
+		offsets[i] = (size_t) (p - strtab);
+		len = 8 + (size_t) random() % 56;
+		(void) memcpy(p, "_ZN", 3);
+		for (j = 3; j < len; j++)
+			p[j] = "abcdefghijklmnopqrstuvwxyz0123456789_"
+			    [random() % 37];
+		p[len] = '\0';
+		p += len + 1;
+	}
+	strsz = (size_t) (p - strtab);
+
+	hash_each(strtab, offsets, BENCH_HASH_NSYM, refsysv, refgnu);
+
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		hash_each(strtab, offsets, BENCH_HASH_NSYM, sysv, gnu);
+	bench_report("hash", "elf_hash",
+	    (size_t) bo->bo_repeat * BENCH_HASH_NSYM, bench_time() - t);
+
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		hash_batch(strtab, strsz, offsets, BENCH_HASH_NSYM, sysv, gnu);
+	bench_report("hash", "elf_hashstrings",
+	    (size_t) bo->bo_repeat * BENCH_HASH_NSYM, bench_time() - t);
+
+	if (memcmp(sysv, refsysv, BENCH_HASH_NSYM * sizeof(*sysv)) != 0 ||
+	    memcmp(gnu, refgnu, BENCH_HASH_NSYM * sizeof(*gnu)) != 0)
+		errx(EXIT_FAILURE, "elf_hashstrings: inconsistent hashes");
+
+	free(refgnu);
+	free(refsysv);
+	free(gnu);
+	free(sysv);
+	free(offsets);
+	free(strtab);
+}
@@ -0,0 +1,203 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for section lookup.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+void
+bench_getscn(const struct bench_options *bo)
+{
+	Elf *e;
+	int fd, r;
+	char *path;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	double t;
+	size_t i, n, shnum, shstrndx;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+
+	path = bench_path(bo, "getscn.o");
+	bench_gen_elf(path, &bs);
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	t = bench_time();
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+	    elf_getshdrnum(e, &shnum) != 0 ||
+	    elf_getshdrstrndx(e, &shstrndx) != 0 ||
+	    elf_getscn(e, shstrndx) == NULL)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+	bench_report("getscn", "load", shnum, bench_time() - t);
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		for (i = 1; i < shnum; i++, n++)
+			if (elf_getscn(e, i) == NULL)
+				errx(EXIT_FAILURE, "elf_getscn: %s",
+				    elf_errmsg(-1));
+	bench_report("getscn", "elf_getscn", n, bench_time() - t);
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		for (i = 1; i < shnum; i++, n++)
+			if ((scn = elf_getscn(e, i)) == NULL ||
+			    gelf_getshdr(scn, &sh) == NULL ||
+			    elf_strptr(e, shstrndx, sh.sh_name) == NULL)
+				errx(EXIT_FAILURE, "elf_strptr: %s",
+				    elf_errmsg(-1));
+	bench_report("getscn", "elf_strptr", n, bench_time() - t);
+
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(path);
+	free(path);
+}
+
+/*
+ * Look up section names repeatedly, as a symbolizer looks up symbol
+ * names, once the section headers have been read.
+ */
+
+#define	BENCH_STRPTR_ROUNDS	20
+
+void
+bench_strptr(const struct bench_options *bo)
+{
+	Elf *e;
+	int fd, r;
+	char *path;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	double t;
+	size_t *names, i, n, shnum, shstrndx;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+
+	path = bench_path(bo, "strptr.o");
+	bench_gen_elf(path, &bs);
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+	    elf_getshdrnum(e, &shnum) != 0 ||
+	    elf_getshdrstrndx(e, &shstrndx) != 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	if ((names = malloc(shnum * sizeof(*names))) == NULL)
+		err(EXIT_FAILURE, "malloc");
+
+	for (i = 0; i < shnum; i++) {
+		if ((scn = elf_getscn(e, i)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			errx(EXIT_FAILURE, "\"%s\": %s", path,
+			    elf_errmsg(-1));
+		names[i] = sh.sh_name;
+	}
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat * BENCH_STRPTR_ROUNDS; r++)
+		for (i = 0; i < shnum; i++, n++)
+			if (elf_strptr(e, shstrndx, names[i]) == NULL)
+				errx(EXIT_FAILURE, "elf_strptr: %s",
+				    elf_errmsg(-1));
+	bench_report("strptr", "elf_strptr", n, bench_time() - t);
+
+	free(names);
+	(void) elf_end(e);
+	(void) close(fd);
+	(void) unlink(path);
+	free(path);
+}
+
+/*
+ * Open an object repeatedly and read a single note section, as a
+ * build-id reader would.
+ */
+
+#define	BENCH_NOTE_OPENS	1000
+
+void
+bench_note(const struct bench_options *bo)
+{
+	Elf *e;
+	int fd, r;
+	char *path;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	double t;
+	size_t i, n;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+	bs.bs_note = 1;
+
+	path = bench_path(bo, "note.o");
+	bench_gen_elf(path, &bs);
+
+	n = 0;
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		for (i = 0; i < BENCH_NOTE_OPENS; i++, n++) {
+			if ((fd = open(path, O_RDONLY)) < 0)
+				err(EXIT_FAILURE, "open \"%s\"", path);
+			if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+			    (scn = elf_getscn(e, 1)) == NULL ||
+			    gelf_getshdr(scn, &sh) == NULL ||
+			    (d = elf_getdata(scn, NULL)) == NULL)
+				errx(EXIT_FAILURE, "\"%s\": %s", path,
+				    elf_errmsg(-1));
+			if (sh.sh_type != SHT_NOTE || d->d_size == 0)
+				errx(EXIT_FAILURE, "\"%s\": bad note section",
+				    path);
+			(void) elf_end(e);
+			(void) close(fd);
+		}
+	bench_report("note", "open+getdata", n, bench_time() - t);
+
+	(void) unlink(path);
+	free(path);
+}
@@ -0,0 +1,122 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for symbol table access.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define	BENCH_SYM_NSCN		100
+
+void
+bench_symbols(const struct bench_options *bo)
+{
+	Elf *e;
+	int fd, r;
+	char *path;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	GElf_Sym sym;
+	size_t i, n, nsym;
+	double t, tbegin, tgetdata, tgetsym, tstrptr;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+	bs.bs_nscn = BENCH_SYM_NSCN;
+	bs.bs_nsym = bo->bo_nsym;
+	bs.bs_namelen = bo->bo_namelen;
+
+	path = bench_path(bo, "symbols.o");
+	bench_gen_elf(path, &bs);
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	n = 0;
+	tbegin = tgetdata = tgetsym = tstrptr = 0.0;
+	for (r = 0; r < bo->bo_repeat; r++) {
+		t = bench_time();
+		if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL)
+			errx(EXIT_FAILURE, "elf_begin: %s", elf_errmsg(-1));
+		tbegin += bench_time() - t;
+
+		scn = NULL;
+		while ((scn = elf_nextscn(e, scn)) != NULL) {
+			if (gelf_getshdr(scn, &sh) == NULL)
+				errx(EXIT_FAILURE, "gelf_getshdr: %s",
+				    elf_errmsg(-1));
+			if (sh.sh_type == SHT_SYMTAB)
+				break;
+		}
+		if (scn == NULL)
+			errx(EXIT_FAILURE, "\"%s\": no symbol table", path);
+
+		t = bench_time();
+		if ((d = elf_getdata(scn, NULL)) == NULL)
+			errx(EXIT_FAILURE, "elf_getdata: %s", elf_errmsg(-1));
+		tgetdata += bench_time() - t;
+
+		nsym = sh.sh_size / sh.sh_entsize;
+
+		t = bench_time();
+		for (i = 1; i < nsym; i++)
+			if (gelf_getsym(d, (int) i, &sym) == NULL)
+				errx(EXIT_FAILURE, "gelf_getsym: %s",
+				    elf_errmsg(-1));
+		tgetsym += bench_time() - t;
+
+		t = bench_time();
+		for (i = 1; i < nsym; i++, n++)
+			if (gelf_getsym(d, (int) i, &sym) == NULL ||
+			    elf_strptr(e, sh.sh_link, sym.st_name) == NULL)
+				errx(EXIT_FAILURE, "elf_strptr: %s",
+				    elf_errmsg(-1));
+		tstrptr += bench_time() - t;
+
+		(void) elf_end(e);
+	}
+
+	bench_report("symbols", "elf_begin", (size_t) bo->bo_repeat, tbegin);
+	bench_report("symbols", "elf_getdata", (size_t) bo->bo_repeat,
+	    tgetdata);
+	bench_report("symbols", "gelf_getsym", n, tgetsym);
+	bench_report("symbols", "elf_strptr", n, tstrptr);
+
+	(void) close(fd);
+	(void) unlink(path);
+	free(path);
+}
@@ -0,0 +1,164 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+/*
+ * Benchmarks for object layout.
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Assign the PROGBITS sections of `e' their file offsets in reverse
+ * order, so that their extents are seen from the end of the file
+ * backwards.
+ */
+static void
+reverse_offsets(Elf *e, size_t shnum)
+{
+	size_t i, j;
+	Elf_Scn *si, *sj;
+	GElf_Off off;
+	GElf_Shdr shi, shj;
+
+	/* Sections 1 .. shnum - 2 are the same size. */
+	for (i = 1, j = shnum - 2; i < j; i++, j--) {
+		if ((si = elf_getscn(e, i)) == NULL ||
+		    (sj = elf_getscn(e, j)) == NULL ||
+		    gelf_getshdr(si, &shi) == NULL ||
+		    gelf_getshdr(sj, &shj) == NULL)
+			errx(EXIT_FAILURE, "elf_getscn: %s", elf_errmsg(-1));
+
+		off = shi.sh_offset;
+		shi.sh_offset = shj.sh_offset;
+		shj.sh_offset = off;
+
+		if (gelf_update_shdr(si, &shi) == 0 ||
+		    gelf_update_shdr(sj, &shj) == 0)
+			errx(EXIT_FAILURE, "gelf_update_shdr: %s",
+			    elf_errmsg(-1));
+	}
+}
+
+static void
+time_update(const struct bench_options *bo, const char *path,
+    const char *variant, unsigned int flags, int reverse)
+{
+	Elf *e;
+	int fd, r;
+	double t;
+	size_t shnum;
+
+	if ((fd = open(path, O_RDWR)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	if ((e = elf_begin(fd, ELF_C_RDWR, NULL)) == NULL ||
+	    elf_getshdrnum(e, &shnum) != 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	if (flags)
+		(void) elf_flagelf(e, ELF_C_SET, flags);
+
+	if (reverse)
+		reverse_offsets(e, shnum);
+
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++)
+		if (elf_update(e, ELF_C_NULL) < 0)
+			errx(EXIT_FAILURE, "elf_update: %s", elf_errmsg(-1));
+	bench_report("update", variant, shnum * (size_t) bo->bo_repeat,
+	    bench_time() - t);
+
+	(void) elf_end(e);
+	(void) close(fd);
+}
+
+/*
+ * Time writing out an object in which the contents of one section
+ * have changed, which elf_update() does in place.
+ */
+static void
+time_write_dirty(const struct bench_options *bo, const char *path)
+{
+	Elf *e;
+	int fd, r;
+	double t;
+	size_t shnum;
+	Elf_Scn *scn;
+	Elf_Data *d;
+
+	if ((fd = open(path, O_RDWR)) < 0)
+		err(EXIT_FAILURE, "open \"%s\"", path);
+
+	if ((e = elf_begin(fd, ELF_C_RDWR, NULL)) == NULL ||
+	    elf_getshdrnum(e, &shnum) != 0)
+		errx(EXIT_FAILURE, "\"%s\": %s", path, elf_errmsg(-1));
+
+	t = bench_time();
+	for (r = 0; r < bo->bo_repeat; r++) {
+		if ((scn = elf_getscn(e, 1 + (size_t) r % (shnum - 2))) ==
+		    NULL || (d = elf_getdata(scn, NULL)) == NULL ||
+		    d->d_size == 0)
+			errx(EXIT_FAILURE, "elf_getdata: %s", elf_errmsg(-1));
+		((unsigned char *) d->d_buf)[0] ^= 0xFF;
+		(void) elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY);
+		if (elf_update(e, ELF_C_WRITE) < 0)
+			errx(EXIT_FAILURE, "elf_update: %s", elf_errmsg(-1));
+	}
+	bench_report("update", "write-dirty", (size_t) bo->bo_repeat,
+	    bench_time() - t);
+
+	(void) elf_end(e);
+	(void) close(fd);
+}
+
+void
+bench_update(const struct bench_options *bo)
+{
+	char *path;
+	struct bench_elf_spec bs;
+
+	bench_spec_init(&bs, bo);
+
+	path = bench_path(bo, "update.o");
+	bench_gen_elf(path, &bs);
+
+	time_update(bo, path, "library", 0, 0);
+	time_update(bo, path, "app-layout", ELF_F_LAYOUT, 0);
+	time_update(bo, path, "app-reversed", ELF_F_LAYOUT, 1);
+	time_write_dirty(bo, path);
+
+	(void) unlink(path);
+	free(path);
+}
@@ -147,6 +147,45 @@ define(`DOELFTYPES',
 ifelse(__SZ__,32,`_DOELFTYPES(ELF32_TYPES)',`_DOELFTYPES(ELF64_TYPES)')dnl
 popdef(`__ARGS__')popdef(`__F__')')
 
+/*
+ * ELF_BULK_TYPES
+ *
+ * Types with a fixed layout that share their file and memory
+ * representations.  Arrays of these types are converted in bulk by
+ * the library.
+ */
+define(`ELF_COMMON_BULK_TYPES',
+  ``ADDR,	Addr',
+   `DYN,	Dyn',
+   `HALF,	Half',
+   `LWORD,	Lword',
+   `OFF,	Off',
+   `REL,	Rel',
+   `RELA,	Rela',
+   `SWORD,	Sword',
+   `SYM,	Sym',
+   `WORD,	Word'')
+
+define(`ELF32_BULK_TYPES',
+  `ELF_COMMON_BULK_TYPES,
+   `_,		_'')
+
+define(`ELF64_BULK_TYPES',
+  `ELF_COMMON_BULK_TYPES,
+   `SXWORD,	Sxword',
+   `XWORD,	Xword',
+   `_,		_'')
+
+/*
+ * DOBULKTYPES(MACRO,ARGS...)
+ *
+ * Like `DOELFTYPES', but iterate over the ELF bulk type list.
+ */
+define(`DOBULKTYPES',
+  `pushdef(`__F__',defn(`$1'))pushdef(`__ARGS__',`shift($@)')dnl
+ifelse(__SZ__,32,`_DOELFTYPES(ELF32_BULK_TYPES)',`_DOELFTYPES(ELF64_BULK_TYPES)')dnl
+popdef(`__ARGS__')popdef(`__F__')')
+
 /*
  * ELFTYPEDEFINITION(TYPE,SZ,ENDIANNESS)
  *
@@ -258,6 +297,7 @@ divert(0)
 
 #define	NCOPIES		3
 #define	NOFFSET		8	/* Every alignment in a quad word. */
+#define	NBULK		131	/* Spans several vector blocks. */
 
 divert(-1)
 /*
@@ -918,6 +958,128 @@ Xlate_TestSharedConversions_Note')
 DO(64,`DOELFTYPES(`MKSHAREDCONVERSIONTP',LSB)')
 DO(64,`DOELFTYPES(`MKSHAREDCONVERSIONTP',MSB)')')')
 
+/*
+ * MKBULKCONVERSIONTP(TYPE,C-Name,ENDIANNESS)
+ *
+ * Generate a test purpose that converts an array of pseudo-random
+ * elements of Elf type TYPE in a single call, and checks the result
+ * against a conversion done one element at a time.  The check is
+ * repeated for every alignment of the file data and for an in-place
+ * conversion.
+ */
+define(`MKBULKCONVERSIONTP',`
+void
+tcXlate_tpBulk$1_$3`'__SZ__ (void)
+{
+	Elf_Data dst, src, *r;
+	size_t dsz, fsz, i, msz, ssz;
+	int offset, result;
+	unsigned char *dstbuf, *refbuf, *srcbuf;
+	unsigned int seed;
+
+	TP_ANNOUNCE("TPFNNAME""($1,$3) bulk conversion.");
+
+	(void) memset(&dst, 0, sizeof(dst));
+	(void) memset(&src, 0, sizeof(src));
+
+	fsz = elf`'__SZ__`'_fsize(ELF_T_$1, 1, EV_CURRENT);
+	msz = tests`'__SZ__[ELF_T_$1].tsd_msz;
+
+	assert(fsz == msz);	/* Sanity check. */
+
+	ssz = TO_M_OR_F(`fsz',`msz');
+	dsz = TO_M_OR_F(`msz',`fsz');
+
+	result = TET_UNRESOLVED;
+
+	dstbuf = refbuf = srcbuf = NULL;
+	if ((srcbuf = malloc(NBULK*ssz + NOFFSET)) == NULL ||
+	    (dstbuf = malloc(NBULK*dsz + NOFFSET)) == NULL ||
+	    (refbuf = malloc(NBULK*dsz)) == NULL) {
+		TP_UNRESOLVED("TPFNNAME"" malloc() failed.");
+		goto done;
+	}
+
+	seed = 1;
+	for (i = 0; i < NBULK*ssz + NOFFSET; i++) {
+		seed = seed * 1103515245U + 12345U;
+		srcbuf[i] = (unsigned char) (seed >> 16);
+	}
+
+	/* Convert one element at a time. */
+	src.d_type = ELF_T_$1;
+	src.d_version = dst.d_version = EV_CURRENT;
+	for (i = 0; i < NBULK; i++) {
+		src.d_buf = srcbuf + i*ssz;
+		src.d_size = ssz;
+		dst.d_buf = refbuf + i*dsz;
+		dst.d_size = dsz;
+		if ((r = CallXlator(&dst, &src, ELFDATA2$3)) != &dst) {
+			TP_FAIL("TPFNNAME""($1:$3) failed: \"%s\".",
+			   elf_errmsg(-1));
+			goto done;
+		}
+	}
+
+	result = TET_PASS;
+
+	for (offset = 0; offset < NOFFSET; offset++) {
+		/* Misalign the file representation. */
+		TO_M_OR_F(`(void) memmove(srcbuf + offset, srcbuf, NBULK*ssz);
+		src.d_buf = srcbuf + offset;
+		dst.d_buf = dstbuf;',`src.d_buf = srcbuf;
+		dst.d_buf = dstbuf + offset;')
+		src.d_size = NBULK*ssz;
+		dst.d_size = NBULK*dsz;
+
+		if ((r = CallXlator(&dst, &src, ELFDATA2$3)) != &dst) {
+			TP_FAIL("TPFNNAME""($1:$3) failed: \"%s\".",
+			   elf_errmsg(-1));
+			goto done;
+		}
+
+		if (dst.d_size != NBULK*dsz ||
+		    memcmp(dst.d_buf, refbuf, NBULK*dsz) != 0) {
+			TP_FAIL("$1 offset %d: compare failed.", offset);
+			goto done;
+		}
+
+		TO_M_OR_F(`(void) memmove(srcbuf, srcbuf + offset, NBULK*ssz);')
+	}
+
+	/* Convert in place. */
+	(void) memcpy(dstbuf, srcbuf, NBULK*ssz);
+	src.d_buf = dst.d_buf = dstbuf;
+	src.d_size = NBULK*ssz;
+	dst.d_size = NBULK*dsz;
+
+	if ((r = CallXlator(&dst, &src, ELFDATA2$3)) != &dst) {
+		TP_FAIL("TPFNNAME""($1:$3) failed: \"%s\".",
+		   elf_errmsg(-1));
+		goto done;
+	}
+
+	if (memcmp(dstbuf, refbuf, NBULK*dsz) != 0)
+		TP_FAIL("$1 in-place compare failed.");
+
+ done:
+	if (srcbuf)
+		free(srcbuf);
+	if (dstbuf)
+		free(dstbuf);
+	if (refbuf)
+		free(refbuf);
+	tet_result(result);
+}')
+
+define(`Xlate_TestBulkConversions',`
+ifdef(`ISELF32',dnl
+`DO(32,`DOBULKTYPES(`MKBULKCONVERSIONTP',LSB)')
+DO(32,`DOBULKTYPES(`MKBULKCONVERSIONTP',MSB)')')
+ifdef(`ISELF64',dnl
+`DO(64,`DOBULKTYPES(`MKBULKCONVERSIONTP',LSB)')
+DO(64,`DOBULKTYPES(`MKBULKCONVERSIONTP',MSB)')')')
+
 define(`Xlate_TestBadArguments',`
 void
 tcArgs_tpNullArgs(void)
@@ -46,6 +46,7 @@ include(`xlate_template.m4')
 
 Xlate_TestConversions()
 Xlate_TestConversionsSharedBuffer()
+Xlate_TestBulkConversions()
 
 Xlate_TestBadArguments()
 Xlate_TestBadBuffers()
@@ -0,0 +1,206 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <libelf.h>
+#include <unistd.h>
+
+#include "elfts.h"
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `elf_advise' and `elf_advisescn' APIs.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+#define	TS_FILE		"newscn.lsb64"
+
+/*
+ * NULL descriptors are rejected.
+ */
+
+void
+tcArgsNull(void)
+{
+	int error, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("NULL descriptors are rejected with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+
+	if (elf_advise(NULL, ELF_ADV_NORMAL) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_advise(NULL) was not rejected.");
+	else if (elf_advisescn(NULL, ELF_ADV_NORMAL) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_advisescn(NULL) was not rejected.");
+
+	tet_result(result);
+}
+
+/*
+ * Unknown advice is rejected.
+ */
+
+void
+tcArgsIllegalAdvice(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("unknown advice is rejected with ELF_E_ARGUMENT.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_FILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_advise(e, ELF_ADV_LAST + 1) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_advise() accepted unknown advice.");
+	else if (elf_advisescn(scn, -1) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_advisescn() accepted unknown advice.");
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}
+
+/*
+ * All advice is accepted for files, and the contents of the file are
+ * unaffected.
+ */
+
+void
+tcAdviseFile(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	int a, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("advice is accepted for files opened with ELF_C_READ.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_FILE, ELF_C_READ, fd, goto done;);
+
+	result = TET_PASS;
+
+	for (a = ELF_ADV_FIRST; a <= ELF_ADV_LAST; a++) {
+		if (elf_advise(e, a) != 0) {
+			TP_FAIL("elf_advise(%d) failed: \"%s\".", a,
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		for (scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; )
+			if (elf_advisescn(scn, a) != 0) {
+				TP_FAIL("elf_advisescn(%d) failed: \"%s\".",
+				    a, elf_errmsg(-1));
+				goto done;
+			}
+	}
+
+	if ((scn = elf_getscn(e, 2)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL || d->d_size != 8 ||
+	    ((unsigned char *) d->d_buf)[0] != 0x67)
+		TP_FAIL("unexpected section contents.");
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}
+
+/*
+ * Advice is ignored for objects in application memory.
+ */
+
+static char elf_file[] = "\177ELF\001\001\001	\001\000\000\000\000"
+	"\000\000\000\001\000\003\000\001\000\000\000\357\276\255\336"
+	"\000\000\000\000\000\000\000\000\003\000\000\0004\000 \000"
+	"\000\000(\000\000\000\000\000";
+
+void
+tcAdviseMemory(void)
+{
+	Elf *e;
+	int a, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("advice is ignored for objects opened with "
+	    "elf_memory().");
+
+	result = TET_UNRESOLVED;
+
+	if ((e = elf_memory(elf_file, sizeof(elf_file))) == NULL) {
+		TP_UNRESOLVED("elf_memory() failed: \"%s\".", elf_errmsg(-1));
+		tet_result(result);
+		return;
+	}
+
+	result = TET_PASS;
+
+	for (a = ELF_ADV_FIRST; a <= ELF_ADV_LAST; a++)
+		if (elf_advise(e, a) != 0) {
+			TP_FAIL("elf_advise(%d) failed: \"%s\".", a,
+			    elf_errmsg(-1));
+			break;
+		}
+
+	(void) elf_end(e);
+	tet_result(result);
+}
@@ -0,0 +1,717 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "elfts.h"
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `elf_compress' API, and for the handling of compressed
+ * sections by elf_getdata() and elf_update().  Compressed sections are
+ * only inflated when elf_compress() is asked to store them uncompressed.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+#define	TS_CONTENTSZ	4096
+
+static const char string_table[] = {
+	/* Offset 0 */   '\0',
+	/* Offset 1 */   '.', 'd', 'e', 'b', 'u', 'g', '_', 't', '\0',
+	/* Offset 10 */  '.', 'z', 'd', 'e', 'b', 'u', 'g', '_', 't', '\0',
+	/* Offset 20 */  '.', 's', 'h', 's', 't', 'r', 't', 'a', 'b', '\0'
+};
+
+#define	TS_NAME_DEBUG	1
+#define	TS_NAME_ZDEBUG	10
+#define	TS_NAME_SHSTRTAB 20
+
+static unsigned char contents[TS_CONTENTSZ];
+
+static void
+_init_contents(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(contents); i++)
+		contents[i] = (unsigned char) "compressible text "[i % 18];
+}
+
+/*
+ * Create an ELF object with a non-allocated section named by string
+ * table offset `name', holding `sz' bytes at `buf', and with section
+ * flags `flags'.  If `compress' is set, the section is marked for
+ * compression with elf_compress().  Returns zero on success.
+ */
+static int
+_make_object(int ec, int ed, size_t name, uint64_t flags, void *buf,
+    size_t sz, int compress)
+{
+	Elf *e;
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	Elf_Data *d;
+	Elf_Scn *scn, *strscn;
+	int fd, rc;
+
+	rc = -1;
+	(void) unlink(TS_NEWFILE);
+
+	if ((e = elfts_open_file(TS_NEWFILE, ELF_C_WRITE, &fd)) == NULL)
+		return (-1);
+
+	if (gelf_newehdr(e, ec) == NULL || gelf_getehdr(e, &eh) == NULL)
+		goto done;
+
+	eh.e_ident[EI_DATA] = (unsigned char) ed;
+	eh.e_machine = ec == ELFCLASS32 ? EM_386 : EM_X86_64;
+	eh.e_type = ET_REL;
+
+	if ((scn = elf_newscn(e)) == NULL || (d = elf_newdata(scn)) == NULL)
+		goto done;
+
+	d->d_buf = buf;
+	d->d_size = sz;
+
+	if (gelf_getshdr(scn, &sh) == NULL)
+		goto done;
+	sh.sh_name = name;
+	sh.sh_type = SHT_PROGBITS;
+	sh.sh_flags = flags;
+	if (gelf_update_shdr(scn, &sh) == 0)
+		goto done;
+
+	if ((strscn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(strscn)) == NULL)
+		goto done;
+
+	d->d_buf = (void *) (uintptr_t) string_table;
+	d->d_size = sizeof(string_table);
+
+	if (gelf_getshdr(strscn, &sh) == NULL)
+		goto done;
+	sh.sh_name = TS_NAME_SHSTRTAB;
+	sh.sh_type = SHT_STRTAB;
+	if (gelf_update_shdr(strscn, &sh) == 0)
+		goto done;
+
+	eh.e_shstrndx = elf_ndxscn(strscn);
+	if (gelf_update_ehdr(e, &eh) == 0)
+		goto done;
+
+	if (compress && elf_compress(scn, ELFCOMPRESS_ZLIB, 0) != 0)
+		goto done;
+
+	if (elf_update(e, ELF_C_WRITE) < 0)
+		goto done;
+
+	rc = 0;
+
+ done:
+	if (rc < 0)
+		tet_printf("U: creating \"%s\" failed: \"%s\".", TS_NEWFILE,
+		    elf_errmsg(-1));
+	(void) elf_end(e);
+	(void) close(fd);
+	return (rc);
+}
+
+/*
+ * Check that the data descriptor of section 1 of the object `e'
+ * holds the reference contents, after inflating them first if
+ * `inflate' is set.  Returns zero on success.
+ */
+static int
+_check_contents(Elf *e, int inflate)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		tet_printf("F: elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		return (-1);
+	}
+
+	if (inflate && elf_compress(scn, 0, 0) != 0) {
+		tet_printf("F: elf_compress() failed: \"%s\".",
+		    elf_errmsg(-1));
+		return (-1);
+	}
+
+	if ((d = elf_getdata(scn, NULL)) == NULL) {
+		tet_printf("F: elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		return (-1);
+	}
+
+	if (d->d_type != ELF_T_BYTE || d->d_size != sizeof(contents) ||
+	    memcmp(d->d_buf, contents, sizeof(contents)) != 0) {
+		tet_printf("F: unexpected data: type %d size %ju.",
+		    d->d_type, (uintmax_t) d->d_size);
+		return (-1);
+	}
+
+	if (elf_getdata(scn, d) != NULL) {
+		tet_printf("F: more than one data descriptor.");
+		return (-1);
+	}
+
+	return (0);
+}
+
+/*
+ * A NULL section is rejected.
+ */
+
+void
+tcArgsNull(void)
+{
+	int error, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_compress(NULL,...) fails with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+
+	if (elf_compress(NULL, ELFCOMPRESS_ZLIB, 0) != -1)
+		TP_FAIL("elf_compress() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+	tet_result(result);
+}
+
+/*
+ * Unknown flags and compression types are rejected, and sections
+ * in the process image may not be compressed.
+ */
+
+void
+tcArgsIllegal(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("illegal arguments are rejected.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_init_contents();
+	if (_make_object(ELFCLASS64, ELFDATA2LSB, TS_NAME_DEBUG, SHF_ALLOC,
+	    contents, sizeof(contents), 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_compress(scn, ELFCOMPRESS_ZLIB, 1) != -1 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("unknown flags were not rejected.");
+		goto done;
+	}
+
+	if (elf_compress(scn, ELFCOMPRESS_LOOS, 0) != -1 ||
+	    (error = elf_errno()) != ELF_E_UNIMPL) {
+		TP_FAIL("an unknown compression type was not rejected.");
+		goto done;
+	}
+
+	if (elf_compress(scn, ELFCOMPRESS_ZLIB, 0) != -1 ||
+	    (error = elf_errno()) != ELF_E_SECTION) {
+		TP_FAIL("an SHF_ALLOC section was not rejected.");
+		goto done;
+	}
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Sections marked with elf_compress() are written out compressed.
+ * Their contents are returned as stored by elf_getdata(), until
+ * elf_compress() is used to inflate them.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcRoundTrip$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	const unsigned char *p;
+	int fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: compressed sections round-trip.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_init_contents();
+	if (_make_object(ELFCLASS$1, ELFDATA2`'TOUPPER($2), TS_NAME_DEBUG,
+	    0, contents, sizeof(contents), 1) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((sh.sh_flags & SHF_COMPRESSED) == 0 ||
+	    sh.sh_size >= sizeof(contents) ||
+	    sh.sh_addralign != ($1 / 8)) {
+		TP_FAIL("unexpected section header: flags 0x%jx size %ju "
+		    "align %ju.", (uintmax_t) sh.sh_flags,
+		    (uintmax_t) sh.sh_size, (uintmax_t) sh.sh_addralign);
+		goto done;
+	}
+
+	/* The raw contents start with a compression header. */
+	if ((d = elf_rawdata(scn, NULL)) == NULL ||
+	    d->d_size != sh.sh_size) {
+		TP_FAIL("elf_rawdata() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	p = d->d_buf;
+	if (p[ifelse($2,lsb,0,3)] != ELFCOMPRESS_ZLIB) {
+		TP_FAIL("unexpected compression header.");
+		goto done;
+	}
+
+	if ((d = elf_getdata(scn, NULL)) == NULL ||
+	    d->d_size != sh.sh_size || memcmp(d->d_buf, p, d->d_size) != 0) {
+		TP_FAIL("elf_getdata() did not return the stored contents.");
+		goto done;
+	}
+
+	if (_check_contents(e, 1) < 0)
+		result = TET_FAIL;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
+/*
+ * elf_compress(scn, 0, 0) causes a compressed section to be written
+ * out uncompressed, and a compressed section whose contents were only
+ * retrieved is written out as it was read.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcRdWr$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	unsigned char *raw;
+	size_t rawsz;
+	int fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: compressed sections in ELF_C_RDWR mode.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+	raw = NULL;
+
+	_init_contents();
+	if (_make_object(ELFCLASS$1, ELFDATA2`'TOUPPER($2), TS_NAME_DEBUG,
+	    0, contents, sizeof(contents), 1) < 0)
+		goto done;
+
+	/* Read the section and rewrite the object. */
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_RDWR, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_rawdata(scn, NULL)) == NULL ||
+	    (raw = malloc(d->d_size)) == NULL) {
+		TP_UNRESOLVED("elf_rawdata() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+	(void) memcpy(raw, d->d_buf, rawsz = d->d_size);
+
+	result = TET_PASS;
+
+	if (elf_getdata(scn, NULL) == NULL || elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	e = NULL;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_RDWR, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_rawdata(scn, NULL)) == NULL || d->d_size != rawsz ||
+	    memcmp(d->d_buf, raw, rawsz) != 0) {
+		TP_FAIL("the compressed section was changed.");
+		goto done;
+	}
+
+	/* Store the section uncompressed. */
+	if (elf_compress(scn, 0, 0) != 0 || elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_compress() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	e = NULL;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL ||
+	    (sh.sh_flags & SHF_COMPRESSED) != 0 ||
+	    sh.sh_size != sizeof(contents)) {
+		TP_FAIL("the section was not decompressed.");
+		goto done;
+	}
+
+	if (_check_contents(e, 0) < 0)
+		result = TET_FAIL;
+
+ done:
+	free(raw);
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
+/*
+ * Copying a compressed section's header and the data returned by
+ * elf_getdata() to a new object, as elfcopy(1) does, preserves the
+ * compressed section.
+ */
+
+#define	TS_COPYFILE	"copy.file"
+
+undefine(`FN')
+define(`FN',`
+void
+tcCopy$1$2(void)
+{
+	Elf *e, *ce;
+	Elf_Scn *scn, *cscn;
+	Elf_Data *d, *cd;
+	GElf_Ehdr eh;
+	GElf_Shdr sh, csh;
+	uint64_t zsize;
+	int fd, cfd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: copied compressed sections stay "
+	    "compressed.");
+
+	result = TET_UNRESOLVED;
+	e = ce = NULL;
+	fd = cfd = -1;
+	zsize = 0;
+
+	_init_contents();
+	if (_make_object(ELFCLASS$1, ELFDATA2`'TOUPPER($2), TS_NAME_DEBUG,
+	    0, contents, sizeof(contents), 1) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	(void) unlink(TS_COPYFILE);
+	_TS_OPEN_FILE(ce, TS_COPYFILE, ELF_C_WRITE, cfd, goto done;);
+
+	if (gelf_getehdr(e, &eh) == NULL || gelf_newehdr(ce, ELFCLASS$1) ==
+	    NULL || gelf_update_ehdr(ce, &eh) == 0) {
+		TP_UNRESOLVED("copying the ELF header failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	scn = NULL;
+	while ((scn = elf_nextscn(e, scn)) != NULL) {
+		if (gelf_getshdr(scn, &sh) == NULL ||
+		    (d = elf_getdata(scn, NULL)) == NULL ||
+		    (cscn = elf_newscn(ce)) == NULL ||
+		    gelf_update_shdr(cscn, &sh) == 0 ||
+		    (cd = elf_newdata(cscn)) == NULL) {
+			TP_UNRESOLVED("copying section %zu failed: \"%s\".",
+			    elf_ndxscn(scn), elf_errmsg(-1));
+			goto done;
+		}
+		if (elf_ndxscn(scn) == 1)
+			zsize = sh.sh_size;
+		cd->d_align = d->d_align;
+		cd->d_buf = d->d_buf;
+		cd->d_size = d->d_size;
+		cd->d_type = d->d_type;
+	}
+
+	if (elf_update(ce, ELF_C_WRITE) < 0) {
+		TP_UNRESOLVED("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(ce);
+	(void) close(cfd);
+	ce = NULL;
+	cfd = -1;
+
+	_TS_OPEN_FILE(ce, TS_COPYFILE, ELF_C_READ, cfd, goto done;);
+
+	result = TET_PASS;
+
+	if ((cscn = elf_getscn(ce, 1)) == NULL ||
+	    gelf_getshdr(cscn, &csh) == NULL ||
+	    (csh.sh_flags & SHF_COMPRESSED) == 0 || csh.sh_size != zsize) {
+		TP_FAIL("the copied section was changed.");
+		goto done;
+	}
+
+	if (_check_contents(ce, 1) < 0)
+		result = TET_FAIL;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (ce)
+		(void) elf_end(ce);
+	if (fd != -1)
+		(void) close(fd);
+	if (cfd != -1)
+		(void) close(cfd);
+	(void) unlink(TS_NEWFILE);
+	(void) unlink(TS_COPYFILE);
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
+/*
+ * The contents of ".zdebug" sections can be inflated.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcZdebug$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	unsigned char *buf;
+	uLongf zsz;
+	int fd, i, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: .zdebug sections are inflated.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_init_contents();
+
+	zsz = compressBound(sizeof(contents));
+	if ((buf = malloc(12 + zsz)) == NULL ||
+	    compress(buf + 12, &zsz, contents, sizeof(contents)) != Z_OK) {
+		TP_UNRESOLVED("compress() failed.");
+		goto done;
+	}
+
+	(void) memcpy(buf, "ZLIB", 4);
+	for (i = 0; i < 8; i++)
+		buf[4 + i] = (unsigned char) ((uint64_t) sizeof(contents) >>
+		    (8 * (7 - i)));
+
+	if (_make_object(ELFCLASS$1, ELFDATA2`'TOUPPER($2), TS_NAME_ZDEBUG,
+	    0, buf, 12 + zsz, 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	result = TET_PASS;
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_rawdata(scn, NULL)) == NULL ||
+	    d->d_size != 12 + zsz || memcmp(d->d_buf, "ZLIB", 4) != 0) {
+		TP_FAIL("unexpected raw contents.");
+		goto done;
+	}
+
+	if (_check_contents(e, 1) < 0)
+		result = TET_FAIL;
+
+ done:
+	free(buf);
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
+/*
+ * Malformed compressed contents are reported with ELF_E_SECTION.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcMalformed$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	unsigned char buf[64];
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: malformed compressed sections are "
+	    "detected.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	/* A ZLIB compression header followed by garbage. */
+	(void) memset(buf, 0xA5, sizeof(buf));
+	(void) memset(buf, 0, $1 / 4 * 3);
+	buf[ifelse($2,lsb,0,3)] = ELFCOMPRESS_ZLIB;
+	buf[ifelse($1,32,ifelse($2,lsb,4,7),ifelse($2,lsb,8,15))] = 0x10;
+
+	if (_make_object(ELFCLASS$1, ELFDATA2`'TOUPPER($2), TS_NAME_DEBUG,
+	    SHF_COMPRESSED, buf, sizeof(buf), 0) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_compress(scn, 0, 0) != -1)
+		TP_FAIL("elf_compress() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_SECTION)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
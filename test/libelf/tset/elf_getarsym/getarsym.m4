@@ -74,10 +74,41 @@ tcArgsNull(void)
 	tet_result(result);
 }
 
+static char *nonar = "This is not an AR file.";
+
+/*
+ * elf_arsym_lookup() with NULL arguments fails.
+ */
+void
+tcArgsNullLookup(void)
+{
+	Elf *e;
+	int error, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_arsym_lookup(NULL,*) and elf_arsym_lookup(*,NULL) "
+	    "fail.");
+
+	result = TET_PASS;
+	if (elf_arsym_lookup(NULL, "a1") != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_arsym_lookup(NULL,*) did not fail.");
+
+	TS_OPEN_MEMORY(e, nonar);
+
+	if (elf_arsym_lookup(e, "a1") != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_arsym_lookup(non-ar,*) did not fail.");
+
+	(void) elf_end(e);
+
+	tet_result(result);
+}
+
 /*
  * elf_getarsym() on a non-Ar file fails.
  */
-static char *nonar = "This is not an AR file.";
 
 void
 tcArgsNonAr(void)
@@ -357,6 +388,119 @@ tcArArSym$1(void)
 	tet_result(result);
 
 }
+
+/*
+ * elf_arsym_lookup() finds each symbol in the archive symbol table.
+ */
+
+void
+tcArLookup$1(void)
+{
+	Elf_Arhdr *arh;
+	Elf *ar_e, *e;
+	Elf_Arsym *arsym;
+	off_t offset;
+	int error, fd, result;
+	struct refsym *r;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_arsym_lookup()/$1 returns the defining member.");
+
+	ar_e = e = NULL;
+	fd = -1;
+
+	TS_OPEN_FILE(ar_e, TP_ARFILE_$1, ELF_C_READ, fd);
+
+	result = TET_PASS;
+
+	for (r = refsym; r->as_name; r++) {
+		if ((arsym = elf_arsym_lookup(ar_e, r->as_name)) == NULL) {
+			TP_FAIL("symbol \"%s\" not found: \"%s\".",
+			    r->as_name, elf_errmsg(-1));
+			goto done;
+		}
+
+		if (strcmp(arsym->as_name, r->as_name) != 0 ||
+		    arsym->as_hash != r->as_hash) {
+			TP_FAIL("symbol \"%s\" returned entry \"%s\".",
+			    r->as_name, arsym->as_name);
+			goto done;
+		}
+
+		if ((offset = elf_rand(ar_e, arsym->as_off)) != arsym->as_off) {
+			TP_FAIL("elf_rand(%jd) failed: \"%s\".",
+			    (intmax_t) arsym->as_off, elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((e = elf_begin(fd, ELF_C_READ, ar_e)) == NULL) {
+			TP_UNRESOLVED("elf_begin() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((arh = elf_getarhdr(e)) == NULL) {
+			TP_UNRESOLVED("elf_getarhdr() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if (strcmp(arh->ar_name, r->as_object) != 0) {
+			TP_FAIL("object-name \"%s\" != ref \"%s\".",
+			    arh->ar_name, r->as_object);
+			goto done;
+		}
+
+		(void) elf_end(e);
+		e = NULL;
+	}
+
+	/* An unknown symbol is not found, and is not an error. */
+	(void) elf_errno();
+	if ((arsym = elf_arsym_lookup(ar_e, "a3")) != NULL ||
+	    (error = elf_errno()) != ELF_E_NONE)
+		TP_FAIL("lookup of unknown symbol: arsym=%p error=%d.",
+		    (void *) arsym, error);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (ar_e)
+		(void) elf_end(ar_e);
+	if (fd != -1)
+	        (void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * elf_arsym_lookup() on an ar archive without a symbol table fails.
+ */
+
+void
+tcArLookupNoSymtab$1(void)
+{
+	Elf *e;
+	Elf_Arsym *arsym;
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_arsym_lookup(ar-with-no-symtab)/$1 fails.");
+
+	TS_OPEN_FILE(e, TP_ARFILE_NOSYMTAB_$1, ELF_C_READ, fd);
+
+	result = TET_PASS;
+	if ((arsym = elf_arsym_lookup(e, "a1")) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARCHIVE)
+		TP_FAIL("arsym=%p error=%d.", (void *) arsym, error);
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	tet_result(result);
+}
 ')
 
 ARCHIVE_TESTS(`SVR4')
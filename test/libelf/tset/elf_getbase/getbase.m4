@@ -26,7 +26,12 @@
  * $Id$
  */
 
+#include <ar.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <libelf.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "elfts.h"
 #include "tet_api.h"
@@ -93,6 +98,169 @@ tcNonMemberAr(void)
 	(void) elf_end(e);
 }
 
+/*
+ * Objects opened with elf_open_slice() report the offset of the
+ * slice, and archive members the offset of the member in the file.
+ */
+
+#define	TS_SLICE_FILE	"getbase.slice"
+#define	TS_SLICE_OFFSET	5000	/* not a multiple of the page size */
+
+/*
+ * Create TS_SLICE_FILE, holding `sz' bytes at `image' placed at offset
+ * TS_SLICE_OFFSET.  Returns a descriptor open for reading.
+ */
+static int
+_make_slice_file(const char *image, size_t sz)
+{
+	int fd;
+	char pad[TS_SLICE_OFFSET];
+
+	(void) memset(pad, 0xA5, sizeof(pad));
+
+	if ((fd = open(TS_SLICE_FILE, O_RDWR | O_CREAT | O_TRUNC,
+	    0600)) < 0) {
+		tet_printf("U: open() failed: %s.", strerror(errno));
+		return (-1);
+	}
+
+	if (write(fd, pad, sizeof(pad)) != (ssize_t) sizeof(pad) ||
+	    write(fd, image, sz) != (ssize_t) sz ||
+	    write(fd, pad, sizeof(pad)) != (ssize_t) sizeof(pad)) {
+		tet_printf("U: write() failed: %s.", strerror(errno));
+		(void) close(fd);
+		return (-1);
+	}
+
+	return (fd);
+}
+
+void
+tcSliceElf(void)
+{
+	int fd, result;
+	char *r;
+	size_t sz;
+	Elf *e;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getbase() on a slice returns the slice offset");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+
+	if ((fd = _make_slice_file(elf_file, sizeof(elf_file))) < 0)
+		goto done;
+
+	if ((e = elf_open_slice(fd, (off_t) TS_SLICE_OFFSET,
+	    sizeof(elf_file))) == NULL) {
+		TP_UNRESOLVED("elf_open_slice() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_kind(e) != ELF_K_ELF)
+		TP_FAIL("unexpected kind %d.", elf_kind(e));
+	else if (elf_getbase(e) != (off_t) TS_SLICE_OFFSET)
+		TP_FAIL("unexpected base %jd.", (intmax_t) elf_getbase(e));
+	else if ((r = elf_rawfile(e, &sz)) == NULL ||
+	    sz != sizeof(elf_file) || memcmp(r, elf_file, sz) != 0)
+		TP_FAIL("elf_rawfile() did not return the slice.");
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_SLICE_FILE);
+	tet_result(result);
+}
+
+void
+tcSliceArMember(void)
+{
+	int fd, result;
+	off_t off;
+	Elf *ar, *e;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getbase() on a member of an archive slice returns "
+	    "its file offset");
+
+	result = TET_UNRESOLVED;
+	ar = e = NULL;
+
+	if ((fd = _make_slice_file(ar_file, sizeof(ar_file) - 1)) < 0)
+		goto done;
+
+	if ((ar = elf_open_slice(fd, (off_t) TS_SLICE_OFFSET,
+	    sizeof(ar_file) - 1)) == NULL ||
+	    (e = elf_begin(fd, ELF_C_READ, ar)) == NULL) {
+		TP_UNRESOLVED("opening the member failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	/* The member follows the archive magic and its header. */
+	off = TS_SLICE_OFFSET + SARMAG + sizeof(struct ar_hdr);
+	if (elf_getbase(ar) != (off_t) TS_SLICE_OFFSET)
+		TP_FAIL("unexpected archive base %jd.",
+		    (intmax_t) elf_getbase(ar));
+	else if (elf_getbase(e) != off)
+		TP_FAIL("unexpected member base %jd, expected %jd.",
+		    (intmax_t) elf_getbase(e), (intmax_t) off);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (ar)
+		(void) elf_end(ar);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_SLICE_FILE);
+	tet_result(result);
+}
+
+void
+tcSliceOutOfRange(void)
+{
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("slices extending past the end of the file are rejected");
+
+	result = TET_UNRESOLVED;
+
+	if ((fd = _make_slice_file(elf_file, sizeof(elf_file))) < 0)
+		goto done;
+
+	result = TET_PASS;
+
+	if (elf_open_slice(fd, (off_t) (3 * TS_SLICE_OFFSET), 1) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("an offset past the end was not rejected.");
+	else if (elf_open_slice(fd, (off_t) TS_SLICE_OFFSET,
+	    sizeof(elf_file) + TS_SLICE_OFFSET + 1) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("a size past the end was not rejected.");
+	else if (elf_open_slice(fd, (off_t) -1, 1) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("a negative offset was not rejected.");
+
+ done:
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_SLICE_FILE);
+	tet_result(result);
+}
+
 /*
  * Todo:
  * - test an ar archive with an embedded ELF file.
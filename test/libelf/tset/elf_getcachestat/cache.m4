@@ -0,0 +1,348 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for the cache of translated section data, controlled by
+ * `elf_setcachelimit' and `elf_getcachestat'.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+#define	TS_FILE		"newscn.lsb64"
+#define	TS_SCN_FOOBAR	2
+
+/*
+ * Open TS_FILE, and mark the descriptor evictable.
+ */
+static Elf *
+_open_evictable(int *fdp)
+{
+	Elf *e;
+
+	if ((e = elfts_open_file(TS_FILE, ELF_C_READ, fdp)) == NULL)
+		return (NULL);
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_EVICTABLE) == 0) {
+		tet_printf("U: elf_flagelf() failed: \"%s\".",
+		    elf_errmsg(-1));
+		(void) elf_end(e);
+		(void) close(*fdp);
+		return (NULL);
+	}
+
+	return (e);
+}
+
+/*
+ * Retrieve the contents of section `ndx' of `e'.
+ */
+static Elf_Data *
+_getdata(Elf *e, size_t ndx)
+{
+	Elf_Scn *scn;
+
+	if ((scn = elf_getscn(e, ndx)) == NULL)
+		return (NULL);
+	return (elf_getdata(scn, NULL));
+}
+
+/*
+ * A NULL argument is rejected.
+ */
+
+void
+tcArgsNull(void)
+{
+	int error, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getcachestat(NULL) fails with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+
+	if (elf_getcachestat(NULL) != -1)
+		TP_FAIL("elf_getcachestat() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+	tet_result(result);
+}
+
+/*
+ * The limit set is reported back.
+ */
+
+void
+tcLimit(void)
+{
+	int result;
+	size_t old;
+	Elf_Cachestat cs;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_setcachelimit() sets the cache limit.");
+
+	result = TET_PASS;
+
+	old = elf_setcachelimit((size_t) 12345);
+
+	if (elf_getcachestat(&cs) != 0 || cs.cs_limit != 12345)
+		TP_FAIL("unexpected limit %ju.", (uintmax_t) cs.cs_limit);
+	else if (elf_setcachelimit(old) != 12345)
+		TP_FAIL("the previous limit was not returned.");
+
+	tet_result(result);
+}
+
+/*
+ * ELF_F_EVICTABLE may only be set on descriptors opened for reading.
+ */
+
+void
+tcFlagMode(void)
+{
+	Elf *e;
+	int error, fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("ELF_F_EVICTABLE is rejected for ELF_C_WRITE "
+	    "descriptors.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	result = TET_PASS;
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_EVICTABLE) != 0)
+		TP_FAIL("elf_flagelf() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_MODE)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+	tet_result(result);
+}
+
+/*
+ * Data of other evictable descriptors is released when the cache is
+ * over its limit, and is re-created on demand.
+ */
+
+void
+tcEviction(void)
+{
+	Elf *e1, *e2;
+	Elf_Data *d1, *d2, *ds;
+	Elf_Cachestat before, cs;
+	unsigned char ref[8];
+	int fd1, fd2, result;
+	size_t old;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("least recently used data is released and re-created.");
+
+	result = TET_UNRESOLVED;
+	e1 = e2 = NULL;
+	fd1 = fd2 = -1;
+	old = elf_setcachelimit((size_t) 1);
+
+	if ((e1 = _open_evictable(&fd1)) == NULL ||
+	    (e2 = _open_evictable(&fd2)) == NULL)
+		goto done;
+
+	(void) elf_getcachestat(&before);
+
+	/* Data of the object being accessed is not released. */
+	if ((d1 = _getdata(e1, TS_SCN_FOOBAR)) == NULL ||
+	    (ds = _getdata(e1, 1)) == NULL || d1->d_size != sizeof(ref)) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+	(void) memcpy(ref, d1->d_buf, sizeof(ref));
+
+	result = TET_PASS;
+
+	if (_getdata(e1, TS_SCN_FOOBAR) != d1 ||
+	    elf_getcachestat(&cs) != 0 ||
+	    cs.cs_misses != before.cs_misses + 2 ||
+	    cs.cs_hits != before.cs_hits + 1 ||
+	    cs.cs_evictions != before.cs_evictions) {
+		TP_FAIL("unexpected counters: hits %ju misses %ju "
+		    "evictions %ju.", (uintmax_t) cs.cs_hits,
+		    (uintmax_t) cs.cs_misses, (uintmax_t) cs.cs_evictions);
+		goto done;
+	}
+
+	/* Accessing another object releases both sections. */
+	if ((d2 = _getdata(e2, TS_SCN_FOOBAR)) == NULL ||
+	    elf_getcachestat(&cs) != 0 ||
+	    cs.cs_evictions != before.cs_evictions + 2 ||
+	    cs.cs_size != d2->d_size) {
+		TP_FAIL("data was not released: evictions %ju size %ju.",
+		    (uintmax_t) cs.cs_evictions, (uintmax_t) cs.cs_size);
+		goto done;
+	}
+
+	/* Released data is re-created. */
+	if ((d1 = _getdata(e1, TS_SCN_FOOBAR)) == NULL ||
+	    d1->d_size != sizeof(ref) ||
+	    memcmp(d1->d_buf, ref, sizeof(ref)) != 0 ||
+	    elf_getcachestat(&cs) != 0 ||
+	    cs.cs_misses != before.cs_misses + 4 ||
+	    cs.cs_evictions != before.cs_evictions + 3) {
+		TP_FAIL("data was not re-created.");
+		goto done;
+	}
+
+	/* Descriptors that are no longer evictable keep their data. */
+	(void) elf_flagelf(e1, ELF_C_CLR, ELF_F_EVICTABLE);
+
+	if (_getdata(e2, TS_SCN_FOOBAR) == NULL ||
+	    elf_getcachestat(&cs) != 0 ||
+	    cs.cs_evictions != before.cs_evictions + 3 ||
+	    _getdata(e1, TS_SCN_FOOBAR) != d1) {
+		TP_FAIL("data of a non-evictable descriptor was released.");
+		goto done;
+	}
+
+ done:
+	(void) elf_setcachelimit(old);
+	if (e1)
+		(void) elf_end(e1);
+	if (e2)
+		(void) elf_end(e2);
+	if (fd1 != -1)
+		(void) close(fd1);
+	if (fd2 != -1)
+		(void) close(fd2);
+	tet_result(result);
+}
+
+/*
+ * Data retrieved before a descriptor is marked evictable is added to
+ * the cache, and closing a descriptor removes its data from the cache.
+ */
+
+void
+tcEnterAndEnd(void)
+{
+	Elf *e;
+	Elf_Data *d;
+	Elf_Cachestat before, cs;
+	int fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("data enters the cache when ELF_F_EVICTABLE is set and "
+	    "leaves it on elf_end().");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	(void) elf_getcachestat(&before);
+
+	_TS_OPEN_FILE(e, TS_FILE, ELF_C_READ, fd, goto done;);
+
+	if ((d = _getdata(e, TS_SCN_FOOBAR)) == NULL) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_getcachestat(&cs) != 0 || cs.cs_misses != before.cs_misses ||
+	    cs.cs_size != before.cs_size) {
+		TP_FAIL("data of a non-evictable descriptor was cached.");
+		goto done;
+	}
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_EVICTABLE) == 0 ||
+	    elf_getcachestat(&cs) != 0 ||
+	    cs.cs_size != before.cs_size + d->d_size) {
+		TP_FAIL("existing data was not added to the cache.");
+		goto done;
+	}
+
+	/* Nothing was translated, so no miss is counted. */
+	if (cs.cs_misses != before.cs_misses) {
+		TP_FAIL("unexpected misses %ju.", (uintmax_t) cs.cs_misses);
+		goto done;
+	}
+
+	/* Retrieving the cached data again is a hit. */
+	if (_getdata(e, TS_SCN_FOOBAR) != d ||
+	    elf_getcachestat(&cs) != 0 ||
+	    cs.cs_hits != before.cs_hits + 1 ||
+	    cs.cs_misses != before.cs_misses) {
+		TP_FAIL("unexpected counters: hits %ju misses %ju.",
+		    (uintmax_t) cs.cs_hits, (uintmax_t) cs.cs_misses);
+		goto done;
+	}
+
+	(void) elf_end(e);
+	e = NULL;
+
+	if (elf_getcachestat(&cs) != 0 || cs.cs_size != before.cs_size ||
+	    cs.cs_evictions != before.cs_evictions)
+		TP_FAIL("unexpected size %ju.", (uintmax_t) cs.cs_size);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}
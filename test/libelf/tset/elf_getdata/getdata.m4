@@ -349,3 +349,82 @@ _FN(lsb,32)
 _FN(lsb,64)
 _FN(msb,32)
 _FN(msb,64)
+
+/*
+ * Verify that data for an object marked ELF_F_READONLY is shared with
+ * the file image.
+ */
+undefine(`_FN')
+define(`_FN',`
+void
+tcReadOnlySharedData$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *ed;
+	GElf_Shdr shdr;
+	char *image;
+	size_t shstrndx, sz;
+	int error, fd, match_error, result;
+
+	e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	TP_ANNOUNCE("section data for an ELF_F_READONLY object is "
+	    "not copied.");
+	_TS_OPEN_FILE(e, "zerosection.$1$2", ELF_C_READ, fd, goto done;);
+
+	if (elf_flagelf(e, ELF_C_SET, ELF_F_READONLY) == 0) {
+		error = elf_errno();
+		TP_FAIL("elf_flagelf failed %d \"%s\"", error,
+		    elf_errmsg(error));
+		goto done;
+	}
+
+	if ((image = elf_rawfile(e, &sz)) == NULL) {
+		TP_UNRESOLVED("Cannot retrieve the file image");
+		goto done;
+	}
+
+	if (elf_getshdrstrndx(e, &shstrndx) != 0 ||
+	    (scn = elf_getscn(e, shstrndx)) == NULL ||
+	    gelf_getshdr(scn, &shdr) == NULL) {
+		TP_UNRESOLVED("Cannot find the string table");
+		goto done;
+	}
+
+	if ((ed = elf_getdata(scn, NULL)) == NULL) {
+		error = elf_errno();
+		TP_FAIL("elf_getdata failed %d \"%s\"", error,
+		    elf_errmsg(error));
+		goto done;
+	}
+
+	if ((char *) ed->d_buf != image + shdr.sh_offset) {
+		TP_FAIL("d_buf %p != expected %p", ed->d_buf,
+		    (void *) (image + shdr.sh_offset));
+		goto done;
+	}
+
+	match_error = match_content(ed, sizeof(stringsection),
+	    stringsection);
+	if (match_error != 0) {
+		TP_FAIL("String content mismatch: %d.", match_error);
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	if (e)
+		elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}')
+
+_FN(lsb,32)
+_FN(lsb,64)
+_FN(msb,32)
+_FN(msb,64)
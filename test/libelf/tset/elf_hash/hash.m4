@@ -31,6 +31,7 @@
 #include <ctype.h>
 #include <libelf.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -99,3 +100,194 @@ tpCheckHash(void)
 	}
 	tet_result(result);
 }
+
+/*
+ * Test the `elf_hashstrings' API.
+ */
+
+/*
+ * Known GNU hash values.
+ */
+static struct htab gnutab[] = {
+	H("",			0x1505),
+	H("exit",		0x7c967e3f),
+	H("freelocale",		0x49feb217),
+	H("printf",		0x156b2bb8),
+	H("syscall",		0xbac212a0),
+	H(NULL,			0)
+};
+
+static uint32_t
+gnu_hash(const char *name)
+{
+	const unsigned char *s;
+	uint32_t h;
+
+	for (h = 5381, s = (const unsigned char *) name; *s; s++)
+		h = h * 33 + *s;
+	return (h);
+}
+
+/*
+ * Build a string table holding the strings in `htab' and `gnutab'
+ * followed by strings of increasing length, so that the strings
+ * in a batch end at different points.
+ */
+#define	NLONG		70
+#define	NSTRINGS	(sizeof(htab) / sizeof(htab[0]) - 1 +		\
+	    sizeof(gnutab) / sizeof(gnutab[0]) - 1 + NLONG)
+
+static char *
+make_strtab(size_t *strsz, size_t *offsets)
+{
+	char *strtab, *p;
+	struct htab *ht;
+	size_t n, i;
+
+	if ((strtab = malloc(1 + NSTRINGS * (NLONG + 1))) == NULL)
+		return (NULL);
+
+	p = strtab;
+	*p++ = '\0';
+	n = 0;
+	for (ht = htab; ht->s; ht++) {
+		offsets[n++] = p - strtab;
+		(void) strcpy(p, ht->s);
+		p += strlen(ht->s) + 1;
+	}
+	for (ht = gnutab; ht->s; ht++) {
+		offsets[n++] = p - strtab;
+		(void) strcpy(p, ht->s);
+		p += strlen(ht->s) + 1;
+	}
+	for (i = 0; i < NLONG; i++) {
+		offsets[n++] = p - strtab;
+		/* Lengths cycle through 0..NLONG-1, with high bytes. */
+		memset(p, 'A' + (int) (i % 26) + (i & 1 ? 0x80 : 0),
+		    (i * 37) % NLONG);
+		p += (i * 37) % NLONG;
+		*p++ = '\0';
+	}
+
+	*strsz = p - strtab;
+	return (strtab);
+}
+
+void
+tpHashStrings(void)
+{
+	struct htab *ht;
+	size_t count, i, offsets[NSTRINGS], strsz;
+	uint32_t sysv[NSTRINGS], gnu[NSTRINGS];
+	int result;
+	char *strtab;
+
+	tet_infoline("assertion: elf_hashstrings() computes the same "
+	    "values as elf_hash() and the GNU hash function.");
+
+	if ((strtab = make_strtab(&strsz, offsets)) == NULL) {
+		tet_infoline("unresolved: malloc() failed.");
+		tet_result(TET_UNRESOLVED);
+		return;
+	}
+
+	result = TET_PASS;
+
+	for (ht = gnutab; ht->s; ht++)
+		if (gnu_hash(ht->s) != ht->h) {
+			tet_printf("fail: gnu_hash(\"%s\") = 0x%x != "
+			    "expected 0x%x.", ht->s, gnu_hash(ht->s), ht->h);
+			result = TET_FAIL;
+		}
+
+	/* Check every batch size, so that all lanes are exercised. */
+	for (count = 0; count <= NSTRINGS; count++) {
+		memset(sysv, 0, sizeof(sysv));
+		memset(gnu, 0, sizeof(gnu));
+		if (elf_hashstrings(strtab, strsz, offsets, count, sysv,
+		    gnu) != 0) {
+			tet_printf("fail: elf_hashstrings(count=%d) failed: "
+			    "\"%s\".", (int) count, elf_errmsg(-1));
+			result = TET_FAIL;
+			break;
+		}
+		for (i = 0; i < count; i++)
+			if (sysv[i] != elf_hash(strtab + offsets[i]) ||
+			    gnu[i] != gnu_hash(strtab + offsets[i])) {
+				tet_printf("fail: count=%d string %d: sysv "
+				    "0x%x gnu 0x%x.", (int) count, (int) i,
+				    sysv[i], gnu[i]);
+				result = TET_FAIL;
+			}
+		for (; i < NSTRINGS; i++)
+			if (sysv[i] != 0 || gnu[i] != 0) {
+				tet_printf("fail: count=%d wrote entry %d.",
+				    (int) count, (int) i);
+				result = TET_FAIL;
+			}
+		if (result != TET_PASS)
+			break;
+	}
+
+	/* Either of the result arrays may be omitted. */
+	memset(sysv, 0, sizeof(sysv));
+	memset(gnu, 0, sizeof(gnu));
+	if (elf_hashstrings(strtab, strsz, offsets, NSTRINGS, sysv,
+	    NULL) != 0 ||
+	    elf_hashstrings(strtab, strsz, offsets, NSTRINGS, NULL,
+	    gnu) != 0) {
+		tet_printf("fail: elf_hashstrings() failed: \"%s\".",
+		    elf_errmsg(-1));
+		result = TET_FAIL;
+	} else
+		for (i = 0; i < NSTRINGS; i++)
+			if (sysv[i] != elf_hash(strtab + offsets[i]) ||
+			    gnu[i] != gnu_hash(strtab + offsets[i])) {
+				tet_printf("fail: string %d: sysv 0x%x gnu "
+				    "0x%x.", (int) i, sysv[i], gnu[i]);
+				result = TET_FAIL;
+			}
+
+	free(strtab);
+	tet_result(result);
+}
+
+void
+tpHashStringsArgs(void)
+{
+	static const char strtab[] = "\0name\0unterminated";
+	size_t offsets[2];
+	uint32_t sysv[2], gnu[2];
+	int error, result;
+
+	tet_infoline("assertion: elf_hashstrings() with invalid arguments "
+	    "fails with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+	offsets[0] = 1;
+
+#define	CHECK_ARGS(T,N,O,C,S,G,M)	do {				\
+		if (elf_hashstrings((T), (N), (O), (C), (S), (G)) != -1 ||\
+		    (error = elf_errno()) != ELF_E_ARGUMENT) {		\
+			tet_printf("fail: %s was accepted.", (M));	\
+			result = TET_FAIL;				\
+		}							\
+	} while (0)
+
+	CHECK_ARGS(NULL, sizeof(strtab), offsets, 1, sysv, gnu,
+	    "a NULL string table");
+	CHECK_ARGS(strtab, 0, offsets, 1, sysv, gnu,
+	    "an empty string table");
+	CHECK_ARGS(strtab, sizeof(strtab) - 1, offsets, 1, sysv, gnu,
+	    "an unterminated string table");
+	CHECK_ARGS(strtab, sizeof(strtab), NULL, 1, sysv, gnu,
+	    "a NULL offset array");
+	CHECK_ARGS(strtab, sizeof(strtab), offsets, 1, NULL, NULL,
+	    "a call without result arrays");
+
+	offsets[1] = sizeof(strtab);
+	CHECK_ARGS(strtab, sizeof(strtab), offsets, 2, sysv, gnu,
+	    "an out of range offset");
+
+	tet_result(result);
+}
@@ -322,6 +322,75 @@ FN(64,`lsb')
 FN(64,`msb')
 
 
+/*
+ * elf_nextscn() iterates through sections in ascending order after
+ * a later section has been looked up.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcElfAscendingAfterLookup$2$1(void)
+{
+	Elf *e;
+	Elf_Scn *scn, *oldscn;
+	int fd, result;
+	size_t nsections, n, r;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_nextscn() visits every section after "
+	    "elf_getscn(elf,last-scn).");
+
+	e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, "newscn.$2$1", ELF_C_READ, fd, goto done;);
+
+	if (elf_getshnum(e, &nsections) == 0) {
+		TP_UNRESOLVED("elf_getshnum() failed.");
+		goto done;
+	}
+
+	if (elf_getscn(e, nsections - 1) == NULL) {
+		TP_UNRESOLVED("elf_getscn(%zu) failed.", nsections - 1);
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	for (n = 1, oldscn = NULL; n < nsections; n++, oldscn = scn) {
+		if ((scn = elf_nextscn(e, oldscn)) == NULL) {
+			TP_FAIL("elf_nextscn() failed at index %zu: \"%s\".",
+			    n, elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((r = elf_ndxscn(scn)) != n) {
+			TP_FAIL("scn=%p ndx %zu != %zu.", (void *) scn, r, n);
+			goto done;
+		}
+	}
+
+	if ((scn = elf_nextscn(e, oldscn)) != NULL)
+		TP_FAIL("scn=%p after the last section.", (void *) scn);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+
 /*
  * elf_nextscn() returns an error on mismatched Elf,Scn.
  */
@@ -32,6 +32,7 @@
 #include <ar.h>
 #include <libelf.h>
 #include <limits.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "elfts.h"
@@ -370,6 +371,11 @@ static off_t valid_offsets[] = {
 	80	/* File 's2'. */
 };
 
+static const char *valid_names[] = {
+	"s1",
+	"s2"
+};
+
 static const int number_of_offsets =
     sizeof(valid_offsets) / sizeof(valid_offsets[0]);
 
@@ -413,3 +419,140 @@ done:
 
 	tet_result(result);
 }
+
+/*
+ * elf_ar_member_at() opens members at valid offsets, and leaves the
+ * archive's position for elf_begin() unchanged.
+ */
+void
+tcMemberAtValidOffsets(void)
+{
+	Elf *ar, *e[2], *m;
+	Elf_Arhdr *arh;
+	int i, fd, result;
+
+	fd = -1;
+	ar = m = NULL;
+	e[0] = e[1] = NULL;
+	result = TET_UNRESOLVED;
+
+	TP_CHECK_INITIALIZATION();
+	TP_ANNOUNCE("elf_ar_member_at(valid-offsets) succeeds.");
+
+	TS_OPEN_FILE(ar, TP_ARFILE, ELF_C_READ, fd);
+
+	/* Open the members in reverse order. */
+	for (i = number_of_offsets - 1; i >= 0; i--) {
+		if ((e[i] = elf_ar_member_at(ar, valid_offsets[i])) == NULL) {
+			TP_FAIL("elf_ar_member_at(%lld) failed: \"%s\".",
+			    (long long) valid_offsets[i], elf_errmsg(-1));
+			goto done;
+		}
+	}
+
+	/* Release the archive before its members. */
+	(void) elf_end(ar);
+
+	for (i = 0; i < number_of_offsets; i++) {
+		if ((arh = elf_getarhdr(e[i])) == NULL) {
+			TP_FAIL("elf_getarhdr() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+		if (strcmp(arh->ar_name, valid_names[i]) != 0) {
+			TP_FAIL("member %d: name \"%s\" != \"%s\".", i,
+			    arh->ar_name, valid_names[i]);
+			goto done;
+		}
+	}
+
+	/* Sequential access still starts at the first member. */
+	ar = NULL;
+	(void) elf_end(e[0]);
+	(void) elf_end(e[1]);
+	e[0] = e[1] = NULL;
+	(void) close(fd);
+
+	TS_OPEN_FILE(ar, TP_ARFILE, ELF_C_READ, fd);
+
+	if ((e[1] = elf_ar_member_at(ar, valid_offsets[1])) == NULL) {
+		TP_FAIL("elf_ar_member_at() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((m = elf_begin(fd, ELF_C_READ, ar)) == NULL ||
+	    (arh = elf_getarhdr(m)) == NULL ||
+	    strcmp(arh->ar_name, valid_names[0]) != 0) {
+		TP_FAIL("elf_begin() did not return the first member.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	if (m)
+		(void) elf_end(m);
+	for (i = 0; i < number_of_offsets; i++)
+		if (e[i])
+			(void) elf_end(e[i]);
+	if (ar)
+		(void) elf_end(ar);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * elf_ar_member_at() rejects invalid offsets and non-archives.
+ */
+void
+tcMemberAtInvalid(void)
+{
+	Elf *ar, *e;
+	int error, fd, result;
+
+	fd = -1;
+	ar = NULL;
+	result = TET_UNRESOLVED;
+
+	TP_CHECK_INITIALIZATION();
+	TP_ANNOUNCE("elf_ar_member_at(invalid-arguments) fails.");
+
+	if ((e = elf_ar_member_at(NULL, SARMAG)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("elf_ar_member_at(NULL) did not fail.");
+		goto done;
+	}
+
+	TS_OPEN_FILE(ar, TP_ARFILE, ELF_C_READ, fd);
+
+	if ((e = elf_ar_member_at(ar, SARMAG - 2)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("offset below SARMAG did not fail.");
+		goto done;
+	}
+
+	if ((e = elf_ar_member_at(ar, SARMAG + 1)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("odd offset did not fail.");
+		goto done;
+	}
+
+	if ((e = elf_ar_member_at(ar, SARMAG + 2)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARCHIVE) {
+		TP_FAIL("offset not at a header did not fail.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+done:
+	if (ar)
+		(void) elf_end(ar);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}
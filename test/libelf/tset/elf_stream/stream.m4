@@ -0,0 +1,376 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for reading objects from a pipe using `elf_stream'.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+#define	TS_SCN_SHSTRTAB	1
+#define	TS_SCN_FOOBAR	2
+#define	TS_FOOBAR_SIZE	8
+
+struct ts_stream {
+	size_t	ts_count;		/* sections delivered */
+	size_t	ts_ndx[4];		/* their indices */
+	size_t	ts_size[4];		/* the sizes of their data */
+	int	ts_rc;			/* value returned by the handler */
+	int	ts_names;		/* section names were found */
+};
+
+/*
+ * Record the sections delivered, returning `ts_rc'.
+ */
+static int
+_handler(Elf *e, Elf_Scn *scn, void *arg)
+{
+	Elf_Data *d;
+	GElf_Shdr sh;
+	const char *name;
+	size_t shstrndx;
+	struct ts_stream *ts;
+
+	ts = arg;
+
+	if (ts->ts_count < 4) {
+		ts->ts_ndx[ts->ts_count] = elf_ndxscn(scn);
+		d = elf_getdata(scn, NULL);
+		ts->ts_size[ts->ts_count] = d ? d->d_size : (size_t) -1;
+	}
+	ts->ts_count++;
+
+	if (gelf_getshdr(scn, &sh) == NULL ||
+	    elf_getshdrstrndx(e, &shstrndx) < 0 ||
+	    (name = elf_strptr(e, shstrndx, sh.sh_name)) == NULL ||
+	    (elf_ndxscn(scn) == TS_SCN_FOOBAR && strcmp(name, ".foobar")))
+		ts->ts_names = 0;
+
+	return (ts->ts_rc);
+}
+
+/*
+ * Write the contents of file `fn' to a pipe, and read them back using
+ * elf_stream().  The file needs to fit in the pipe's buffer.
+ */
+static Elf *
+_stream_file(const char *fn, struct ts_stream *ts)
+{
+	Elf *e;
+	ssize_t n;
+	char buf[8192];
+	int fd, p[2];
+
+	e = NULL;
+	p[0] = p[1] = -1;
+
+	if ((fd = open(fn, O_RDONLY)) < 0 || pipe(p) < 0) {
+		tet_printf("U: setup failed: %s.", strerror(errno));
+		goto done;
+	}
+
+	while ((n = read(fd, buf, sizeof(buf))) > 0)
+		if (write(p[1], buf, (size_t) n) != n) {
+			tet_printf("U: write failed: %s.", strerror(errno));
+			goto done;
+		}
+
+	(void) close(p[1]);
+	p[1] = -1;
+
+	e = elf_stream(p[0], _handler, ts);
+
+ done:
+	if (fd != -1)
+		(void) close(fd);
+	if (p[0] != -1)
+		(void) close(p[0]);
+	if (p[1] != -1)
+		(void) close(p[1]);
+	return (e);
+}
+
+/*
+ * Invalid arguments are rejected.
+ */
+
+void
+tcArgsInvalid(void)
+{
+	int error, result;
+	struct ts_stream ts;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("a negative descriptor or a NULL handler is rejected.");
+
+	result = TET_PASS;
+	(void) memset(&ts, 0, sizeof(ts));
+
+	if (elf_stream(-1, _handler, &ts) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("a negative descriptor was not rejected.");
+	else if (elf_stream(0, NULL, &ts) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("a NULL handler was not rejected.");
+	else if (ts.ts_count != 0)
+		TP_FAIL("the handler was called.");
+
+	tet_result(result);
+}
+
+/*
+ * Data that is not an ELF object is rejected.
+ */
+
+void
+tcArgsNotElf(void)
+{
+	int error, p[2], result;
+	struct ts_stream ts;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("non-ELF data is rejected with ELF_E_ARGUMENT.");
+
+	result = TET_UNRESOLVED;
+	(void) memset(&ts, 0, sizeof(ts));
+
+	if (pipe(p) < 0) {
+		tet_printf("U: pipe() failed: %s.", strerror(errno));
+		goto done;
+	}
+
+	if (write(p[1], "!<arch>\n", 8) != 8) {
+		tet_printf("U: write() failed: %s.", strerror(errno));
+		goto done;
+	}
+	(void) close(p[1]);
+
+	result = TET_PASS;
+
+	if (elf_stream(p[0], _handler, &ts) != NULL)
+		TP_FAIL("elf_stream() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+	(void) close(p[0]);
+
+ done:
+	tet_result(result);
+}
+
+/*
+ * Sections are delivered in file order, with their names available.
+ */
+
+define(`TS_STREAM_ORDER',`
+void
+tcOrder$1$2(void)
+{
+	Elf *e;
+	int result;
+	struct ts_stream ts;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("sections of a TOUPPER($1)$2 object are delivered in order.");
+
+	result = TET_UNRESOLVED;
+	(void) memset(&ts, 0, sizeof(ts));
+	ts.ts_names = 1;
+
+	if ((e = _stream_file("newscn.$1$2", &ts)) == NULL) {
+		tet_printf("U: elf_stream() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (ts.ts_count != 2 || ts.ts_ndx[0] != TS_SCN_SHSTRTAB ||
+	    ts.ts_ndx[1] != TS_SCN_FOOBAR)
+		TP_FAIL("unexpected sections: count %d, [%d, %d].",
+		    (int) ts.ts_count, (int) ts.ts_ndx[0], (int) ts.ts_ndx[1]);
+	else if (ts.ts_size[1] != TS_FOOBAR_SIZE)
+		TP_FAIL("unexpected size %d.", (int) ts.ts_size[1]);
+	else if (ts.ts_names == 0)
+		TP_FAIL("section names were not available.");
+
+	(void) elf_end(e);
+
+ done:
+	tet_result(result);
+}')
+
+TS_STREAM_ORDER(lsb,32)
+TS_STREAM_ORDER(lsb,64)
+TS_STREAM_ORDER(msb,32)
+TS_STREAM_ORDER(msb,64)
+
+/*
+ * Retained sections keep their data; other sections do not.
+ */
+
+void
+tcRetain(void)
+{
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	int error, result;
+	struct ts_stream ts;
+	static const unsigned char ref[TS_FOOBAR_SIZE] = {
+		0x67, 0x45, 0x23, 0x01, 0xEF, 0xCD, 0xAB, 0x89
+	};
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("only sections marked ELF_STREAM_RETAIN keep their data.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	(void) memset(&ts, 0, sizeof(ts));
+
+	if ((e = _stream_file("newscn.lsb64", &ts)) == NULL) {
+		tet_printf("U: elf_stream() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((scn = elf_getscn(e, TS_SCN_FOOBAR)) == NULL)
+		TP_FAIL("elf_getscn() failed: \"%s\".", elf_errmsg(-1));
+	else if (elf_getdata(scn, NULL) != NULL)
+		TP_FAIL("data was retained unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_SEQUENCE)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+	(void) elf_end(e);
+	if (result != TET_PASS)
+		goto done;
+
+	ts.ts_count = 0;
+	ts.ts_rc = ELF_STREAM_RETAIN;
+
+	if ((e = _stream_file("newscn.lsb64", &ts)) == NULL) {
+		TP_FAIL("elf_stream() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, TS_SCN_FOOBAR)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL)
+		TP_FAIL("retained data was not available: \"%s\".",
+		    elf_errmsg(-1));
+	else if (d->d_size != TS_FOOBAR_SIZE ||
+	    memcmp(d->d_buf, ref, sizeof(ref)) != 0)
+		TP_FAIL("unexpected data.");
+
+	(void) elf_end(e);
+
+ done:
+	tet_result(result);
+}
+
+/*
+ * ELF_STREAM_STOP ends the delivery of sections.
+ */
+
+void
+tcStop(void)
+{
+	Elf *e;
+	int result;
+	struct ts_stream ts;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("no sections are delivered after ELF_STREAM_STOP.");
+
+	result = TET_UNRESOLVED;
+	(void) memset(&ts, 0, sizeof(ts));
+	ts.ts_rc = ELF_STREAM_STOP;
+
+	if ((e = _stream_file("newscn.lsb64", &ts)) == NULL) {
+		tet_printf("U: elf_stream() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (ts.ts_count != 1)
+		TP_FAIL("unexpected count %d.", (int) ts.ts_count);
+
+	(void) elf_end(e);
+
+ done:
+	tet_result(result);
+}
+
+/*
+ * A handler returning an unknown value causes elf_stream() to fail.
+ */
+
+void
+tcHandlerError(void)
+{
+	int error, result;
+	struct ts_stream ts;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("a negative handler return value is an error.");
+
+	result = TET_PASS;
+	(void) memset(&ts, 0, sizeof(ts));
+	ts.ts_rc = -1;
+
+	if (_stream_file("newscn.lsb64", &ts) != NULL)
+		TP_FAIL("elf_stream() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+	else if (ts.ts_count != 1)
+		TP_FAIL("unexpected count %d.", (int) ts.ts_count);
+
+	tet_result(result);
+}
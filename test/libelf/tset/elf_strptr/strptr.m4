@@ -353,6 +353,90 @@ FN(32,`msb',`newscn')
 FN(64,`lsb',`newscn')
 FN(64,`msb',`newscn')
 
+/*
+ * Changes made by the application to the data descriptor of a string
+ * table are seen by later lookups.
+ */
+
+static char replacement[] = {
+	'\0', 'x', 'y', 'z', '\0'
+};
+
+undefine(`FN')
+define(`FN',`
+void
+tcDataChanged$1`'TOUPPER($2)(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	Elf$1_Ehdr *eh;
+	char *r;
+	void *buf;
+	size_t sz;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: changed data descriptors are used.");
+
+	buf = NULL;
+	sz = 0;
+
+	_TS_OPEN_FILE(e, "$3.$2$1", ELF_C_READ, fd, goto done;);
+
+	if ((eh = elf$1_getehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_getehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, eh->e_shstrndx)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Look up a string twice, then replace the section contents. */
+	if ((r = elf_strptr(e, eh->e_shstrndx, 1)) == NULL ||
+	    strcmp(r, ".shstrtab") != 0 ||
+	    (r = elf_strptr(e, eh->e_shstrndx, 1)) == NULL ||
+	    strcmp(r, ".shstrtab") != 0) {
+		TP_UNRESOLVED("elf_strptr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	buf = d->d_buf;
+	sz = d->d_size;
+	d->d_buf = replacement;
+	d->d_size = sizeof(replacement);
+
+	result = TET_PASS;
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, 1)) != &replacement[1])
+		TP_FAIL("r=%p, expected %p.", (void *) r,
+		    (void *) &replacement[1]);
+	else if ((r = elf_strptr(e, eh->e_shstrndx,
+	    sizeof(replacement))) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("offset past the data was not rejected.");
+
+	/* Restore the contents that the library allocated. */
+	d->d_buf = buf;
+	d->d_size = sz;
+
+ done:
+	(void) elf_end(e);
+	tet_result(result);
+}')
+
+FN(32,`lsb',`newscn')
+FN(32,`msb',`newscn')
+FN(64,`lsb',`newscn')
+FN(64,`msb',`newscn')
+
 /*
  * TODO: With the layout bit set, an out of bounds offset is detected.
  */
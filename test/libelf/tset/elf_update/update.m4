@@ -34,6 +34,7 @@
 #include <libelf.h>
 #include <gelf.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -1952,6 +1953,319 @@ FN(32,msb)
 FN(64,lsb)
 FN(64,msb)
 
+/*
+ * Test that changing the contents of a section without changing its
+ * size updates the object in place, leaving the rest of the file
+ * alone.
+ */
+
+static char inplace_old = 'h', inplace_new = 'H', inplace_pad = 1;
+
+undefine(`FN')
+define(`FN',`
+void
+tcRdWrInPlace_$1$2(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	const char *srcfile = "rdwr2.$2$1";
+	off_t fsz, gap, off;
+	char c, *tfn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: elf_update() updates an unchanged "
+	    "layout in place");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+	tfn = NULL;
+
+	/* Make a copy of the reference object. */
+	if ((tfn = elfts_copy_file(srcfile, &error)) < 0) {
+		TP_UNRESOLVED("elfts_copyfile(%s) failed: \"%s\".",
+		    srcfile, strerror(error));
+		goto done;
+	}
+
+	/* Open the copied object in RDWR mode. */
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+
+	if (gelf_getehdr(e, &eh) == NULL) {
+		TP_UNRESOLVED("gelf_getehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Look for the padding before the section header table. */
+	gap = 0;
+	scn = NULL;
+	while ((scn = elf_nextscn(e, scn)) != NULL) {
+		if (gelf_getshdr(scn, &sh) == NULL) {
+			TP_UNRESOLVED("gelf_getshdr() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+		if ((off_t) (sh.sh_offset + sh.sh_size) > gap)
+			gap = (off_t) (sh.sh_offset + sh.sh_size);
+	}
+
+	if (gap >= (off_t) eh.e_shoff) {
+		TP_UNRESOLVED("no padding before the section header table.");
+		goto done;
+	}
+
+	/*
+	 * Change the padding directly.  A full rewrite of the object
+	 * would fill it in again.
+	 */
+	if (pwrite(fd, &inplace_pad, 1, gap) != 1) {
+		TP_UNRESOLVED("pwrite() failed: \"%s\".", strerror(errno));
+		goto done;
+	}
+
+	/* Change the contents of section 1. */
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL || d->d_size == 0) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	off = (off_t) sh.sh_offset;
+	*(char *) d->d_buf = inplace_new;
+
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY) {
+		TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((fsz = elf_update(e, ELF_C_WRITE)) < 0) {
+		TP_FAIL("elf_update(WRITE) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* The descriptor sees the new contents. */
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_rawdata(scn, NULL)) == NULL ||
+	    *(char *) d->d_buf != inplace_new) {
+		TP_FAIL("elf_rawdata() returned stale contents.");
+		goto done;
+	}
+
+	if ((error = elf_end(e)) != 0) {
+		TP_UNRESOLVED("elf_end() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+	e = NULL;
+
+	if (pread(fd, &c, 1, off) != 1 || c != inplace_new) {
+		TP_FAIL("section contents were not updated.");
+		goto done;
+	}
+
+	if (pread(fd, &c, 1, gap) != 1 || c != inplace_pad) {
+		TP_FAIL("the object was not updated in place.");
+		goto done;
+	}
+
+	/* Undo the changes and compare against the original. */
+	c = 0;
+	if (pwrite(fd, &c, 1, gap) != 1 ||
+	    pwrite(fd, &inplace_old, 1, off) != 1) {
+		TP_UNRESOLVED("pwrite() failed: \"%s\".", strerror(errno));
+		goto done;
+	}
+
+	(void) close(fd);
+	fd = -1;
+
+	result = elfts_compare_files(srcfile, tfn);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (tfn != NULL)
+		(void) unlink(tfn);
+
+	tet_result(result);
+}
+')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
+/*
+ * Test that a symbol changed with gelf_update_sym() in ELF_C_RDWR
+ * mode is written out, even though its section was not marked dirty.
+ */
+
+static char symtab_strtab[] = "\0sym\0.symtab\0.strtab";
+
+#define	TS_SYM_NAME		1
+#define	TS_SYMTAB_NAME		5
+#define	TS_STRTAB_NAME		13
+#define	TS_SYM_OLD_VALUE	0x10
+#define	TS_SYM_NEW_VALUE	0x20
+
+undefine(`FN')
+define(`FN',`
+void
+tcRdWrUpdateSym_$1$2(void)
+{
+	int fd, result;
+	Elf *e;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf$1_Sym syms[2];
+	Elf_Data *d;
+	Elf_Scn *scn, *strscn;
+	GElf_Sym sym;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: symbols changed with gelf_update_sym() "
+	    "are written out in ELF_C_RDWR mode");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	/* Create an object with a symbol table. */
+	(void) unlink(TS_NEWFILE);
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	(void) memset(syms, 0, sizeof(syms));
+	syms[1].st_name = TS_SYM_NAME;
+	syms[1].st_value = TS_SYM_OLD_VALUE;
+	syms[1].st_shndx = SHN_ABS;
+
+	if ((eh = elf$1_newehdr(e)) == NULL ||
+	    (scn = elf_newscn(e)) == NULL ||
+	    (strscn = elf_newscn(e)) == NULL) {
+		TP_UNRESOLVED("creating the object failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+	eh->e_shstrndx = elf_ndxscn(strscn);
+
+	if ((d = elf_newdata(scn)) == NULL ||
+	    (sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("creating the symbol table failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_buf = syms;
+	d->d_size = sizeof(syms);
+	d->d_type = ELF_T_SYM;
+	d->d_align = ifelse($1,32,4,8);
+
+	sh->sh_name = TS_SYMTAB_NAME;
+	sh->sh_type = SHT_SYMTAB;
+	sh->sh_link = elf_ndxscn(strscn);
+	sh->sh_info = 1;
+	sh->sh_entsize = sizeof(Elf$1_Sym);
+
+	if ((d = elf_newdata(strscn)) == NULL ||
+	    (sh = elf$1_getshdr(strscn)) == NULL) {
+		TP_UNRESOLVED("creating the string table failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_buf = symtab_strtab;
+	d->d_size = sizeof(symtab_strtab);
+
+	sh->sh_name = TS_STRTAB_NAME;
+	sh->sh_type = SHT_STRTAB;
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_UNRESOLVED("elf_update(WRITE) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);	e = NULL;
+	(void) close(fd);	fd = -1;
+
+	/* Change the symbol, without marking anything dirty. */
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_RDWR, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL ||
+	    gelf_getsym(d, 1, &sym) != &sym) {
+		TP_UNRESOLVED("gelf_getsym() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	sym.st_value = TS_SYM_NEW_VALUE;
+
+	if (gelf_update_sym(d, 1, &sym) == 0) {
+		TP_UNRESOLVED("gelf_update_sym() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update(WRITE) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);	e = NULL;
+	(void) close(fd);	fd = -1;
+
+	/* Read the symbol back. */
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL ||
+	    gelf_getsym(d, 1, &sym) != &sym) {
+		TP_FAIL("gelf_getsym() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (sym.st_value != TS_SYM_NEW_VALUE)
+		TP_FAIL("symbol value 0x%jx, expected 0x%x.",
+		    (uintmax_t) sym.st_value, TS_SYM_NEW_VALUE);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}
+')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
 /*
  * Test cases rejecting malformed ELF files created with the
  * ELF_F_LAYOUT flag set.
@@ -2388,3 +2702,665 @@ FN(32,`lsb')
 FN(32,`msb')
 FN(64,`lsb')
 FN(64,`msb')
+
+/*
+ * Check that an overlap is detected when sections are not placed in
+ * order of ascending file offsets.
+ */
+
+static size_t unordered_offsets[] = { 128, 192, 136 };
+
+undefine(`FN')
+define(`FN',`
+void
+tcSectionOverlapUnordered$1$2(void)
+{
+	int error, fd, result;
+	off_t offset;
+	size_t i;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: an overlap between sections that are "
+	    "out of order is detected.");
+
+	result = TET_UNRESOLVED;
+	fd = -1;
+	e = NULL;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if ((elf_flagelf(e, ELF_C_SET, ELF_F_LAYOUT) & ELF_F_LAYOUT) == 0) {
+		TP_UNRESOLVED("elf_flagelf() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((eh = elf$1_newehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_type = ET_REL;
+	eh->e_ident[EI_CLASS] = ELFCLASS`'$1;
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_shoff = TS_OFFSET_SHDR;
+
+	/*
+	 * The third section overlaps the first, but not the second.
+	 */
+	for (i = 0; i < sizeof(unordered_offsets) /
+		 sizeof(unordered_offsets[0]); i++) {
+		if ((scn = elf_newscn(e)) == NULL) {
+			TP_UNRESOLVED("elf_newscn() failed: %s.",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((sh = elf$1_getshdr(scn)) == NULL) {
+			TP_UNRESOLVED("elf$1_getshdr() failed: %s.",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((d = elf_newdata(scn)) == NULL) {
+			TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		d->d_buf = base_data;
+		d->d_size = strlen(base_data);
+
+		sh->sh_type = SHT_PROGBITS;
+		sh->sh_addralign = 1;
+		sh->sh_size = strlen(base_data);
+		sh->sh_entsize = 1;
+		sh->sh_offset = unordered_offsets[i];
+	}
+
+	if ((offset = elf_update(e, ELF_C_NULL)) != (off_t) -1) {
+		TP_FAIL("elf_update() succeeded unexpectedly; offset=%jd.",
+		    (intmax_t) offset);
+		goto done;
+	}
+
+	if ((error = elf_errno()) != ELF_E_LAYOUT) {
+		TP_FAIL("elf_update() did not fail with ELF_E_LAYOUT; "
+		    "error=%d \"%s\".", error, elf_errmsg(error));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}
+')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Check the contents of section 1 of TS_NEWFILE against the file
+ * representation of the `N' words at `W'.
+ */
+
+undefine(`FN')
+define(`FN',`
+static int
+_check_words$1$2(const uint32_t *w, size_t n)
+{
+	int fd, result;
+	size_t sz;
+	unsigned char *ref;
+	Elf *e;
+	Elf_Data dst, src, *d;
+	Elf_Scn *scn;
+
+	result = TET_UNRESOLVED;
+	ref = NULL;
+	e = NULL;
+	fd = -1;
+
+	sz = n * sizeof(*w);
+	if ((ref = malloc(sz)) == NULL) {
+		TP_UNRESOLVED("malloc() failed.");
+		goto done;
+	}
+
+	src.d_buf = (void *) (uintptr_t) w;
+	src.d_size = sz;
+	src.d_type = ELF_T_WORD;
+	src.d_version = EV_CURRENT;
+
+	dst.d_buf = ref;
+	dst.d_size = sz;
+	dst.d_version = EV_CURRENT;
+
+	if (elf$1_xlatetof(&dst, &src, ELFDATA2`'TOUPPER($2)) == NULL) {
+		TP_UNRESOLVED("elf$1_xlatetof() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_rawdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_rawdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	if (d->d_size != sz || memcmp(d->d_buf, ref, sz) != 0)
+		TP_FAIL("section contents differ; size=%ju, expected=%ju.",
+		    (uintmax_t) d->d_size, (uintmax_t) sz);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	free(ref);
+
+	return (result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Check that a section larger than the library's internal output
+ * buffer is written out correctly.
+ */
+
+define(`TS_NLARGEWORDS',40000)
+static uint32_t large_words[TS_NLARGEWORDS];
+
+undefine(`FN')
+define(`FN',`
+void
+tcLargeSection_$2$1(void)
+{
+	int fd, result;
+	size_t i;
+	Elf *e;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: a large section is written out "
+	    "correctly.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	for (i = 0; i < TS_NLARGEWORDS; i++)
+		large_words[i] = (uint32_t) (i * 0x01020304U);
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if ((eh = elf$1_newehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+
+	if ((scn = elf_newscn(e)) == NULL) {
+		TP_UNRESOLVED("elf_newscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_newdata(scn)) == NULL) {
+		TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_align = 4;
+	d->d_off = 0;
+	d->d_buf = large_words;
+	d->d_type = ELF_T_WORD;
+	d->d_size = sizeof(large_words);
+	d->d_version = EV_CURRENT;
+
+	if ((sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("elf$1_getshdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	sh->sh_type = SHT_PROGBITS;
+	sh->sh_addralign = 4;
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	e = NULL;
+	(void) close(fd);
+	fd = -1;
+
+	result = _check_words$1$2(large_words, TS_NLARGEWORDS);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Check that data descriptors placed out of order by the application
+ * are written out at their specified offsets.
+ */
+
+static uint32_t ordered_words[] = {
+	0x00010203U, 0x04050607U, 0x08090A0BU, 0x0C0D0E0FU
+};
+
+undefine(`FN')
+define(`FN',`
+void
+tcReorderedData_$2$1(void)
+{
+	int fd, result;
+	size_t fsz, i;
+	Elf *e;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: data descriptors out of file order "
+	    "are written out correctly.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if ((elf_flagelf(e, ELF_C_SET, ELF_F_LAYOUT) & ELF_F_LAYOUT) == 0) {
+		TP_UNRESOLVED("elf_flagelf() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((eh = elf$1_newehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+	eh->e_shoff = TS_OFFSET_SHDR;
+
+	if ((fsz = elf$1_fsize(ELF_T_EHDR, 1, EV_CURRENT)) == 0) {
+		TP_UNRESOLVED("fsize() failed: %s.", elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((scn = elf_newscn(e)) == NULL) {
+		TP_UNRESOLVED("elf_newscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Add the second half of the section first. */
+	for (i = 0; i < 2; i++) {
+		if ((d = elf_newdata(scn)) == NULL) {
+			TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		d->d_align = 4;
+		d->d_off = (2 - 2 * i) * sizeof(ordered_words[0]);
+		d->d_buf = &ordered_words[2 - 2 * i];
+		d->d_type = ELF_T_WORD;
+		d->d_size = 2 * sizeof(ordered_words[0]);
+		d->d_version = EV_CURRENT;
+	}
+
+	if ((sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("elf$1_getshdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	sh->sh_type = SHT_PROGBITS;
+	sh->sh_addralign = 4;
+	sh->sh_offset = fsz;
+	sh->sh_size = sizeof(ordered_words);
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	e = NULL;
+	(void) close(fd);
+	fd = -1;
+
+	result = _check_words$1$2(ordered_words, sizeof(ordered_words) /
+	    sizeof(ordered_words[0]));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Check that a failed ELF_C_WRITE update leaves the existing contents
+ * of the file in place.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcFailedWriteKeepsFile_$2$1(void)
+{
+	int fd, rfd, result;
+	char buf[sizeof(rawdata) + 1];
+	ssize_t n;
+	Elf *e;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: a failed update does not truncate "
+	    "the file.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = rfd = -1;
+
+	_TS_WRITE_FILE(TS_NEWFILE, rawdata, sizeof(rawdata), goto done;);
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if ((eh = elf$1_newehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+
+	if ((scn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(scn)) == NULL ||
+	    (sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("section creation failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* A misaligned buffer cannot be translated. */
+	d->d_align = 4;
+	d->d_buf = (char *) large_words + 1;
+	d->d_type = ELF_T_WORD;
+	d->d_size = 4 * sizeof(large_words[0]);
+	d->d_version = EV_CURRENT;
+
+	sh->sh_type = SHT_PROGBITS;
+	sh->sh_addralign = 4;
+
+	result = TET_PASS;
+	if (elf_update(e, ELF_C_WRITE) >= 0) {
+		TP_FAIL("elf_update() succeeded unexpectedly.");
+		goto done;
+	}
+
+	if ((rfd = open(TS_NEWFILE, O_RDONLY)) < 0) {
+		TP_UNRESOLVED("open() failed: %s.", strerror(errno));
+		goto done;
+	}
+
+	if ((n = read(rfd, buf, sizeof(buf))) < 0 ||
+	    (size_t) n != sizeof(rawdata) ||
+	    memcmp(buf, rawdata, sizeof(rawdata)) != 0)
+		TP_FAIL("file contents changed, %d bytes read.", (int) n);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (rfd != -1)
+		(void) close(rfd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Check that an ELF_C_WRITE update of a file that is mapped in by an
+ * ELF_C_READ descriptor, and whose data is being copied, succeeds.
+ */
+
+#define	TS_MAPPED_SIZE	(128 * 1024)
+
+undefine(`FN')
+define(`FN',`
+static int
+_make_mapped_source_$2$1(const unsigned char *buf)
+{
+	int fd, ok;
+	Elf *e;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+
+	ok = 0;
+	e = NULL;
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if ((eh = elf$1_newehdr(e)) == NULL ||
+	    (scn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(scn)) == NULL ||
+	    (sh = elf$1_getshdr(scn)) == NULL)
+		goto done;
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+
+	d->d_buf = (void *) (uintptr_t) buf;
+	d->d_size = TS_MAPPED_SIZE;
+	sh->sh_type = SHT_PROGBITS;
+
+	ok = elf_update(e, ELF_C_WRITE) >= 0;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	return (ok);
+}
+
+void
+tcWriteOverMappedFile_$2$1(void)
+{
+	int fd, rfd, result, wfd;
+	size_t i;
+	unsigned char *buf;
+	Elf *e, *re, *we;
+	Elf$1_Ehdr *eh;
+	Elf$1_Shdr *sh;
+	Elf_Data *d, *rd;
+	Elf_Scn *scn;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: a file can be rewritten from data "
+	    "mapped in from it.");
+
+	result = TET_UNRESOLVED;
+	e = re = we = NULL;
+	fd = rfd = wfd = -1;
+
+	if ((buf = malloc(TS_MAPPED_SIZE)) == NULL) {
+		TP_UNRESOLVED("malloc() failed.");
+		goto done;
+	}
+	for (i = 0; i < TS_MAPPED_SIZE; i++)
+		buf[i] = (unsigned char) (i * 7);
+
+	if (!_make_mapped_source_$2$1(buf)) {
+		TP_UNRESOLVED("creating the source failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	_TS_OPEN_FILE(re, TS_NEWFILE, ELF_C_READ, rfd, goto done;);
+
+	if ((scn = elf_getscn(re, 1)) == NULL ||
+	    (rd = elf_rawdata(scn, NULL)) == NULL ||
+	    rd->d_size != TS_MAPPED_SIZE) {
+		TP_UNRESOLVED("elf_rawdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Write a large and a small section, copied from the source. */
+	_TS_OPEN_FILE(we, TS_NEWFILE, ELF_C_WRITE, wfd, goto done;);
+
+	if ((eh = elf$1_newehdr(we)) == NULL) {
+		TP_UNRESOLVED("elf$1_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_machine = MAKE_EM($1,$2);
+	eh->e_type = ET_REL;
+
+	for (i = 0; i < 2; i++) {
+		if ((scn = elf_newscn(we)) == NULL ||
+		    (d = elf_newdata(scn)) == NULL ||
+		    (sh = elf$1_getshdr(scn)) == NULL) {
+			TP_UNRESOLVED("section creation failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+		d->d_buf = rd->d_buf;
+		d->d_size = i == 0 ? rd->d_size : 16;
+		sh->sh_type = SHT_PROGBITS;
+	}
+
+	result = TET_PASS;
+
+	if (elf_update(we, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(we);
+	we = NULL;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	for (i = 0; i < 2; i++)
+		if ((scn = elf_getscn(e, i + 1)) == NULL ||
+		    (d = elf_rawdata(scn, NULL)) == NULL ||
+		    d->d_size != (i == 0 ? TS_MAPPED_SIZE : 16) ||
+		    memcmp(d->d_buf, buf, d->d_size) != 0) {
+			TP_FAIL("section %d has unexpected contents.",
+			    (int) i + 1);
+			goto done;
+		}
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (we)
+		(void) elf_end(we);
+	if (re)
+		(void) elf_end(re);
+	if (fd != -1)
+		(void) close(fd);
+	if (rfd != -1)
+		(void) close(rfd);
+	if (wfd != -1)
+		(void) close(wfd);
+	free(buf);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
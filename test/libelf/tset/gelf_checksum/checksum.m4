@@ -0,0 +1,273 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <sys/types.h>
+
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `gelf_checksum' and `elf{32,64}_checksum' APIs.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+/*
+ * Section sizes chosen to straddle the block sizes of the vectorized
+ * summation kernels.  The contents of successive sections are taken
+ * from successive parts of a common buffer, so that their data lies
+ * at unaligned file offsets.
+ */
+static const size_t section_sizes[] = {
+	1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 4097, 1024 * 1024
+};
+
+#define	TS_NSECTIONS	(sizeof(section_sizes) / sizeof(section_sizes[0]))
+#define	TS_CONTENTSZ	(2 * 1024 * 1024)
+
+static unsigned char contents[TS_CONTENTSZ];
+
+static const char string_table[] = {
+	/* Offset 0 */   '\0',
+	/* Offset 1 */   '.', 'a', 'l', 'l', 'o', 'c', '\0',
+	/* Offset 7 */   '.', 'n', 'o', 'a', 'l', 'l', 'o', 'c', '\0',
+	/* Offset 16 */  '.', 'b', 's', 's', '\0',
+	/* Offset 21 */  '.', 's', 'h', 's', 't', 'r', 't', 'a', 'b', '\0'
+};
+
+#define	TS_NAME_ALLOC	1
+#define	TS_NAME_NOALLOC	7
+#define	TS_NAME_BSS	16
+#define	TS_NAME_SHSTRTAB 21
+
+/*
+ * Fill the contents buffer, favouring large byte values so that the
+ * partial sums computed by the library carry.
+ */
+static void
+_init_contents(void)
+{
+	size_t i;
+	uint32_t x;
+
+	for (i = 0, x = 1; i < sizeof(contents); i++) {
+		x = x * 1103515245U + 12345U;
+		contents[i] = (unsigned char) ((x >> 16) | 0x80);
+	}
+}
+
+/*
+ * Append a section of type `type' with flags `flags', named by string
+ * table offset `name' and holding `sz' bytes at `buf'.
+ */
+static Elf_Scn *
+_add_section(Elf *e, size_t name, uint32_t type, uint64_t flags,
+    void *buf, size_t sz)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+
+	if ((scn = elf_newscn(e)) == NULL || (d = elf_newdata(scn)) == NULL)
+		return (NULL);
+
+	d->d_buf = buf;
+	d->d_size = sz;
+
+	if (gelf_getshdr(scn, &sh) == NULL)
+		return (NULL);
+	sh.sh_name = name;
+	sh.sh_type = type;
+	sh.sh_flags = flags;
+	sh.sh_addralign = 1;
+	if (gelf_update_shdr(scn, &sh) == 0)
+		return (NULL);
+
+	return (scn);
+}
+
+/*
+ * Create an ELF object of class `ec' and byte order `ed' and return
+ * its expected checksum in `*sum'.  Returns zero on success.
+ */
+static int
+_make_object(int ec, int ed, long *sum)
+{
+	Elf *e;
+	GElf_Ehdr eh;
+	Elf_Scn *scn;
+	size_t i, j, off;
+	unsigned long c;
+	int fd, rc;
+
+	rc = -1;
+	(void) unlink(TS_NEWFILE);
+
+	if ((e = elfts_open_file(TS_NEWFILE, ELF_C_WRITE, &fd)) == NULL)
+		return (-1);
+
+	if (gelf_newehdr(e, ec) == NULL || gelf_getehdr(e, &eh) == NULL)
+		goto done;
+
+	eh.e_ident[EI_DATA] = (unsigned char) ed;
+	eh.e_machine = ec == ELFCLASS32 ? EM_386 : EM_X86_64;
+	eh.e_type = ET_EXEC;
+
+	c = 0;
+	for (i = off = 0; i < TS_NSECTIONS; i++) {
+		if (_add_section(e, TS_NAME_ALLOC, SHT_PROGBITS, SHF_ALLOC,
+		    contents + off, section_sizes[i]) == NULL)
+			goto done;
+		for (j = 0; j < section_sizes[i]; j++)
+			c += contents[off + j];
+		off += section_sizes[i];
+	}
+
+	/* Sections that do not contribute to the checksum. */
+	if (_add_section(e, TS_NAME_NOALLOC, SHT_PROGBITS, 0, contents,
+	    4096) == NULL ||
+	    _add_section(e, TS_NAME_BSS, SHT_NOBITS, SHF_ALLOC | SHF_WRITE,
+	    NULL, 4096) == NULL)
+		goto done;
+
+	if ((scn = _add_section(e, TS_NAME_SHSTRTAB, SHT_STRTAB, 0,
+	    (void *) (uintptr_t) string_table, sizeof(string_table))) == NULL)
+		goto done;
+
+	eh.e_shstrndx = elf_ndxscn(scn);
+	if (gelf_update_ehdr(e, &eh) == 0)
+		goto done;
+
+	if (elf_update(e, ELF_C_WRITE) < 0)
+		goto done;
+
+	*sum = (long) (((c >> 16) & 0xFFFFUL) + (c & 0xFFFFUL));
+	rc = 0;
+
+ done:
+	if (rc < 0)
+		tet_printf("U: creating \"%s\" failed: \"%s\".", TS_NEWFILE,
+		    elf_errmsg(-1));
+	(void) elf_end(e);
+	(void) close(fd);
+	return (rc);
+}
+
+/*
+ * A NULL argument is rejected.
+ */
+
+void
+tcArgsNull(void)
+{
+	int error, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("gelf_checksum(NULL) fails with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+
+	if (gelf_checksum(NULL) != 0)
+		TP_FAIL("gelf_checksum() succeeded unexpectedly.");
+	else if ((error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("unexpected error %d \"%s\".", error,
+		    elf_errmsg(error));
+
+	tet_result(result);
+}
+
+/*
+ * The checksum is the folded sum of the bytes of allocated sections.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcChecksum$1$2(void)
+{
+	Elf *e;
+	long sum, v;
+	int fd, result;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: the checksum of an object is correct.");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+
+	_init_contents();
+	if (_make_object(ELFCLASS$1, ELFDATA2`'TOUPPER($2), &sum) < 0)
+		goto done;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd, goto done;);
+
+	result = TET_PASS;
+
+	if ((v = gelf_checksum(e)) != sum) {
+		TP_FAIL("gelf_checksum() = %ld, expected %ld.", v, sum);
+		goto done;
+	}
+
+	if ((v = elf$1_checksum(e)) != sum) {
+		TP_FAIL("elf$1_checksum() = %ld, expected %ld.", v, sum);
+		goto done;
+	}
+
+	/* A mismatched class is rejected. */
+	if (elf`'ifelse($1,32,64,32)_checksum(e) != 0 ||
+	    elf_errno() != ELF_E_CLASS)
+		TP_FAIL("a class mismatch was not detected.");
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
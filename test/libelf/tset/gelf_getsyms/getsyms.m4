@@ -0,0 +1,306 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <gelf.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for the `gelf_getdyns', `gelf_getrels', `gelf_getrelas' and
+ * `gelf_getsyms' APIs.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+#define	TS_NENTRIES	37
+
+/*
+ * Create an ELF object of class `ec' holding a single section of type
+ * `sht' whose contents are the `sz' bytes at `buf'.
+ */
+static Elf *
+_make_object(int ec, uint32_t sht, void *buf, size_t sz, Elf_Type t,
+    int *fdp, Elf_Data **dp)
+{
+	int fd;
+	Elf *e;
+	GElf_Shdr sh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+
+	e = NULL;
+	*fdp = -1;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto error;);
+	*fdp = fd;
+
+	if (gelf_newehdr(e, ec) == NULL) {
+		tet_printf("U: gelf_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto error;
+	}
+
+	if ((scn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(scn)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL) {
+		tet_printf("U: section creation failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto error;
+	}
+
+	d->d_buf = buf;
+	d->d_size = sz;
+	d->d_type = t;
+
+	sh.sh_type = sht;
+	if (gelf_update_shdr(scn, &sh) == 0) {
+		tet_printf("U: gelf_update_shdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto error;
+	}
+
+	*dp = d;
+	return (e);
+
+ error:
+	if (e)
+		(void) elf_end(e);
+	return (NULL);
+}
+
+static void
+_release_object(Elf *e, int fd)
+{
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+}
+
+/*
+ * Fill a buffer with a position dependent byte pattern.
+ */
+static void
+_fill(void *buf, size_t sz)
+{
+	size_t i;
+	unsigned char *p;
+
+	for (i = 0, p = buf; i < sz; i++)
+		*p++ = (unsigned char) (i * 7 + 3);
+}
+
+/*
+ * Null arguments are rejected.
+ */
+
+void
+tcArgsNull(void)
+{
+	int error, result;
+	GElf_Sym sym;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("gelf_getsyms(NULL,...) fails with ELF_E_ARGUMENT.");
+
+	result = TET_PASS;
+	if (gelf_getsyms(NULL, 0, 1, &sym) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("gelf_getsyms() did not fail as expected.");
+
+	tet_result(result);
+}
+
+/*
+ * A range of entries matches the entries returned one at a time.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcCompare$2_$1(void)
+{
+	int fd, result;
+	size_t first, i;
+	Elf *e;
+	Elf_Data *d;
+	GElf_$2 bulk[TS_NENTRIES], one;
+	Elf$1_$2 raw[TS_NENTRIES];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("gelf_get`'translit($2,`A-Z',`a-z')s() on an ELFCLASS$1 "
+	    "object matches gelf_get`'translit($2,`A-Z',`a-z')().");
+
+	result = TET_UNRESOLVED;
+
+	_fill(raw, sizeof(raw));
+
+	if ((e = _make_object(ELFCLASS$1, $3, raw, sizeof(raw), $4, &fd,
+	    &d)) == NULL)
+		goto done;
+
+	result = TET_PASS;
+
+	for (first = 0; first < TS_NENTRIES; first += 5) {
+		(void) memset(bulk, 0, sizeof(bulk));
+		if (gelf_get`'translit($2,`A-Z',`a-z')s(d, first,
+		    TS_NENTRIES - first, bulk) != bulk) {
+			TP_FAIL("first=%zu: bulk retrieval failed: \"%s\".",
+			    first, elf_errmsg(-1));
+			goto done;
+		}
+		for (i = first; i < TS_NENTRIES; i++) {
+			if (gelf_get`'translit($2,`A-Z',`a-z')(d, (int) i,
+			    &one) != &one) {
+				TP_UNRESOLVED("entry %zu: retrieval failed: "
+				    "\"%s\".", i, elf_errmsg(-1));
+				goto done;
+			}
+			if (memcmp(&one, &bulk[i - first], sizeof(one))) {
+				TP_FAIL("first=%zu: entry %zu differs.",
+				    first, i);
+				goto done;
+			}
+		}
+	}
+
+ done:
+	_release_object(e, fd);
+	tet_result(result);
+}
+
+/*
+ * Ranges extending past the end of the data are rejected.
+ */
+
+void
+tcRange$2_$1(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Data *d;
+	GElf_$2 bulk[TS_NENTRIES];
+	Elf$1_$2 raw[TS_NENTRIES];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("gelf_get`'translit($2,`A-Z',`a-z')s() on an ELFCLASS$1 "
+	    "object rejects out of range requests.");
+
+	result = TET_UNRESOLVED;
+
+	_fill(raw, sizeof(raw));
+
+	if ((e = _make_object(ELFCLASS$1, $3, raw, sizeof(raw), $4, &fd,
+	    &d)) == NULL)
+		goto done;
+
+	result = TET_PASS;
+
+	if (gelf_get`'translit($2,`A-Z',`a-z')s(d, TS_NENTRIES, 0, bulk) !=
+	    bulk) {
+		TP_FAIL("empty range at end failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (gelf_get`'translit($2,`A-Z',`a-z')s(d, 1, TS_NENTRIES, bulk) !=
+	    NULL || (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("range past end was not rejected.");
+		goto done;
+	}
+
+	if (gelf_get`'translit($2,`A-Z',`a-z')s(d, 1, SIZE_MAX, bulk) !=
+	    NULL || (error = elf_errno()) != ELF_E_ARGUMENT) {
+		TP_FAIL("overflowing range was not rejected.");
+		goto done;
+	}
+
+ done:
+	_release_object(e, fd);
+	tet_result(result);
+}
+
+/*
+ * Sections of the wrong type are rejected.
+ */
+
+void
+tcType$2_$1(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Data *d;
+	GElf_$2 bulk[TS_NENTRIES];
+	Elf$1_$2 raw[TS_NENTRIES];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("gelf_get`'translit($2,`A-Z',`a-z')s() on an ELFCLASS$1 "
+	    "object rejects sections of the wrong type.");
+
+	result = TET_UNRESOLVED;
+
+	_fill(raw, sizeof(raw));
+
+	if ((e = _make_object(ELFCLASS$1, SHT_PROGBITS, raw, sizeof(raw),
+	    ELF_T_BYTE, &fd, &d)) == NULL)
+		goto done;
+
+	result = TET_PASS;
+
+	if (gelf_get`'translit($2,`A-Z',`a-z')s(d, 0, 1, bulk) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("section type was not checked.");
+
+ done:
+	_release_object(e, fd);
+	tet_result(result);
+}')
+
+FN(32,`Dyn',SHT_DYNAMIC,ELF_T_DYN)
+FN(64,`Dyn',SHT_DYNAMIC,ELF_T_DYN)
+FN(32,`Rel',SHT_REL,ELF_T_REL)
+FN(64,`Rel',SHT_REL,ELF_T_REL)
+FN(32,`Rela',SHT_RELA,ELF_T_RELA)
+FN(64,`Rela',SHT_RELA,ELF_T_RELA)
+FN(32,`Sym',SHT_SYMTAB,ELF_T_SYM)
+FN(64,`Sym',SHT_SYMTAB,ELF_T_SYM)
@@ -0,0 +1,524 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <ar.h>
+#include <errno.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+include(`elfts.m4')
+
+/*
+ * Tests for the use of libelf from multiple threads.
+ */
+
+IC_REQUIRES_VERSION_INIT();
+
+#define	TS_NTHREADS	8
+#define	TS_NITERATIONS	200
+#define	TS_NSECTIONS	3
+
+/*
+ * Assertion: error numbers are maintained per thread.
+ */
+
+static void *
+set_error(void *arg)
+{
+	int *error;
+
+	error = arg;
+
+	(void) elf_errno();
+	(void) elf_getscn(NULL, (size_t) 0);
+	*error = elf_errno();
+
+	return (NULL);
+}
+
+void
+tcErrorPerThread(void)
+{
+	pthread_t t;
+	int error, result, thread_error;
+
+	TP_ANNOUNCE("error numbers are maintained per thread.");
+
+	result = TET_UNRESOLVED;
+	thread_error = -1;
+
+	(void) elf_errno();
+
+	if (pthread_create(&t, NULL, set_error, &thread_error) != 0 ||
+	    pthread_join(t, NULL) != 0) {
+		TP_UNRESOLVED("cannot run a thread: %s", strerror(errno));
+		goto done;
+	}
+
+	result = TET_PASS;
+	if (thread_error != ELF_E_ARGUMENT) {
+		TP_FAIL("thread error %d != %d", thread_error,
+		    ELF_E_ARGUMENT);
+		goto done;
+	}
+
+	if ((error = elf_errno()) != ELF_E_NONE)
+		TP_FAIL("main thread error %d \"%s\"", error,
+		    elf_errmsg(error));
+
+ done:
+	tet_result(result);
+}
+
+/*
+ * Assertion: an ELF_C_READ descriptor may be shared between threads.
+ */
+
+struct reader {
+	Elf		*r_elf;
+	int		r_error;
+	const char	*r_names[TS_NSECTIONS];
+	void		*r_buf[TS_NSECTIONS];
+};
+
+static void *
+read_sections(void *arg)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr shdr;
+	size_t n, shstrndx;
+	struct reader *r;
+
+	r = arg;
+	e = r->r_elf;
+
+	if (elf_getshdrstrndx(e, &shstrndx) != 0)
+		goto error;
+
+	scn = NULL;
+	while ((scn = elf_nextscn(e, scn)) != NULL) {
+		if ((n = elf_ndxscn(scn)) >= TS_NSECTIONS ||
+		    gelf_getshdr(scn, &shdr) == NULL ||
+		    (d = elf_getdata(scn, NULL)) == NULL ||
+		    (r->r_names[n] = elf_strptr(e, shstrndx,
+		    (size_t) shdr.sh_name)) == NULL)
+			goto error;
+		r->r_buf[n] = d->d_buf;
+	}
+
+	if ((r->r_error = elf_errno()) != ELF_E_NONE)
+		goto error;
+
+	return (NULL);
+
+ error:
+	r->r_error = elf_errno();
+	if (r->r_error == ELF_E_NONE)
+		r->r_error = -1;
+	return (NULL);
+}
+
+static int
+check_shared_descriptor(const char *fn)
+{
+	Elf *e;
+	size_t n;
+	int fd, i, iteration, result;
+	pthread_t t[TS_NTHREADS];
+	struct reader r[TS_NTHREADS];
+
+	e = NULL;
+	fd = -1;
+	result = TET_PASS;
+
+	for (iteration = 0; iteration < TS_NITERATIONS; iteration++) {
+		_TS_OPEN_FILE(e, fn, ELF_C_READ, fd,
+		    return (TET_UNRESOLVED););
+
+		(void) memset(r, 0, sizeof(r));
+		for (i = 0; i < TS_NTHREADS; i++) {
+			r[i].r_elf = e;
+			if (pthread_create(&t[i], NULL, read_sections,
+			    &r[i]) != 0) {
+				TP_UNRESOLVED("pthread_create: %s",
+				    strerror(errno));
+				return (TET_UNRESOLVED);
+			}
+		}
+
+		for (i = 0; i < TS_NTHREADS; i++)
+			(void) pthread_join(t[i], NULL);
+
+		for (i = 0; i < TS_NTHREADS; i++) {
+			if (r[i].r_error != ELF_E_NONE) {
+				TP_FAIL("iteration %d thread %d: error %d",
+				    iteration, i, r[i].r_error);
+				break;
+			}
+			for (n = 1; n < TS_NSECTIONS; n++)
+				if (r[i].r_buf[n] != r[0].r_buf[n] ||
+				    r[i].r_names[n] != r[0].r_names[n] ||
+				    r[i].r_names[n] == NULL) {
+					TP_FAIL("iteration %d thread %d: "
+					    "mismatch for section %d",
+					    iteration, i, (int) n);
+					break;
+				}
+		}
+
+		if (strcmp(r[0].r_names[1], ".shstrtab") != 0 ||
+		    strcmp(r[0].r_names[2], ".foobar") != 0)
+			TP_FAIL("iteration %d: unexpected names \"%s\" "
+			    "\"%s\"", iteration, r[0].r_names[1],
+			    r[0].r_names[2]);
+
+		(void) elf_end(e);
+		(void) close(fd);
+
+		if (result != TET_PASS)
+			break;
+	}
+
+	return (result);
+}
+
+undefine(`FN')
+define(`FN',`
+void
+tcSharedDescriptor$1$2(void)
+{
+	TP_ANNOUNCE("an ELF_C_READ descriptor may be shared by threads.");
+	tet_result(check_shared_descriptor("newscn.$1$2"));
+}')
+
+FN(lsb,32)
+FN(lsb,64)
+FN(msb,32)
+FN(msb,64)
+
+/*
+ * Assertion: sections may be added to a descriptor concurrently.
+ */
+
+struct creator {
+	Elf		*c_elf;
+	int		c_error;
+	size_t		c_ndx[TS_NITERATIONS];
+};
+
+static void *
+add_sections(void *arg)
+{
+	Elf_Scn *scn;
+	struct creator *c;
+	int n;
+
+	c = arg;
+
+	for (n = 0; n < TS_NITERATIONS; n++) {
+		if ((scn = elf_newscn(c->c_elf)) == NULL) {
+			c->c_error = elf_errno();
+			return (NULL);
+		}
+		c->c_ndx[n] = elf_ndxscn(scn);
+	}
+
+	return (NULL);
+}
+
+void
+tcConcurrentNewscn(void)
+{
+	Elf *e;
+	char *seen;
+	size_t n, nscn, ndx;
+	int fd, i, result;
+	pthread_t t[TS_NTHREADS];
+	struct creator c[TS_NTHREADS];
+
+	TP_ANNOUNCE("sections may be added to a descriptor concurrently.");
+
+	e = NULL;
+	fd = -1;
+	seen = NULL;
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, "newscn.lsb64", ELF_C_READ, fd, goto done;);
+
+	(void) memset(c, 0, sizeof(c));
+	for (i = 0; i < TS_NTHREADS; i++) {
+		c[i].c_elf = e;
+		if (pthread_create(&t[i], NULL, add_sections, &c[i]) != 0) {
+			TP_UNRESOLVED("pthread_create: %s", strerror(errno));
+			goto done;
+		}
+	}
+
+	for (i = 0; i < TS_NTHREADS; i++)
+		(void) pthread_join(t[i], NULL);
+
+	result = TET_PASS;
+	if (elf_getshdrnum(e, &nscn) != 0) {
+		TP_FAIL("elf_getshdrnum() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	if (nscn != TS_NSECTIONS + TS_NTHREADS * TS_NITERATIONS) {
+		TP_FAIL("nscn %d != %d", (int) nscn,
+		    TS_NSECTIONS + TS_NTHREADS * TS_NITERATIONS);
+		goto done;
+	}
+
+	if ((seen = calloc(nscn, 1)) == NULL) {
+		TP_UNRESOLVED("calloc: %s", strerror(errno));
+		goto done;
+	}
+
+	for (i = 0; i < TS_NTHREADS; i++) {
+		if (c[i].c_error != ELF_E_NONE) {
+			TP_FAIL("thread %d: error %d", i, c[i].c_error);
+			goto done;
+		}
+		for (n = 0; n < TS_NITERATIONS; n++) {
+			ndx = c[i].c_ndx[n];
+			if (ndx < TS_NSECTIONS || ndx >= nscn || seen[ndx]) {
+				TP_FAIL("thread %d: bad or duplicate index "
+				    "%d", i, (int) ndx);
+				goto done;
+			}
+			seen[ndx] = 1;
+		}
+	}
+
+ done:
+	free(seen);
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	tet_result(result);
+}
+
+/*
+ * Assertion: members of a shared archive may be opened and closed
+ * concurrently using elf_ar_member_at().
+ */
+
+#define	TS_MEMBERSZ	16
+
+static char ts_archive[SARMAG + TS_NTHREADS *
+    (sizeof(struct ar_hdr) + TS_MEMBERSZ)];
+static off_t ts_member_offsets[TS_NTHREADS];
+
+/*
+ * Lay out an archive with one member per thread, named "m<N>/".
+ */
+static void
+make_archive(void)
+{
+	struct ar_hdr *arh;
+	char *p;
+	int i;
+
+	p = ts_archive;
+	(void) memcpy(p, ARMAG, SARMAG);
+	p += SARMAG;
+
+	for (i = 0; i < TS_NTHREADS; i++) {
+		ts_member_offsets[i] = p - ts_archive;
+		arh = (struct ar_hdr *) p;
+		(void) memset(arh, ' ', sizeof(*arh));
+		arh->ar_name[0] = 'm';
+		arh->ar_name[1] = (char) ('0' + i);
+		arh->ar_name[2] = '/';
+		(void) memcpy(arh->ar_size, "16", 2);
+		(void) memcpy(arh->ar_fmag, ARFMAG, sizeof(arh->ar_fmag));
+		p += sizeof(*arh);
+		(void) memset(p, '0' + i, TS_MEMBERSZ);
+		p += TS_MEMBERSZ;
+	}
+}
+
+struct member_reader {
+	Elf		*m_ar;		/* shared archive */
+	Elf		*m_elf;		/* member, if already open */
+	int		m_index;
+	int		m_error;
+};
+
+static int
+check_member(Elf *e, int i)
+{
+	Elf_Arhdr *arh;
+	char *raw, name[8];
+	size_t sz;
+
+	(void) snprintf(name, sizeof(name), "m%d", i);
+
+	if ((arh = elf_getarhdr(e)) == NULL ||
+	    strcmp(arh->ar_name, name) != 0 ||
+	    (raw = elf_rawfile(e, &sz)) == NULL || sz != TS_MEMBERSZ ||
+	    raw[0] != '0' + i || raw[sz - 1] != '0' + i)
+		return (0);
+
+	return (1);
+}
+
+static void *
+read_member(void *arg)
+{
+	Elf *e;
+	int n;
+	struct member_reader *m;
+
+	m = arg;
+
+	for (n = 0; m->m_elf == NULL && n < TS_NITERATIONS; n++) {
+		if ((e = elf_ar_member_at(m->m_ar,
+		    ts_member_offsets[m->m_index])) == NULL ||
+		    check_member(e, m->m_index) == 0)
+			goto error;
+		(void) elf_end(e);
+	}
+
+	if (m->m_elf) {
+		if (check_member(m->m_elf, m->m_index) == 0)
+			goto error;
+		(void) elf_end(m->m_elf);
+	}
+
+	return (NULL);
+
+ error:
+	m->m_error = elf_errno();
+	if (m->m_error == ELF_E_NONE)
+		m->m_error = -1;
+	return (NULL);
+}
+
+static int
+run_member_readers(struct member_reader *m)
+{
+	int i;
+	pthread_t t[TS_NTHREADS];
+
+	for (i = 0; i < TS_NTHREADS; i++)
+		if (pthread_create(&t[i], NULL, read_member, &m[i]) != 0) {
+			tet_printf("U: pthread_create: %s", strerror(errno));
+			return (TET_UNRESOLVED);
+		}
+
+	for (i = 0; i < TS_NTHREADS; i++)
+		(void) pthread_join(t[i], NULL);
+
+	for (i = 0; i < TS_NTHREADS; i++)
+		if (m[i].m_error != ELF_E_NONE) {
+			tet_printf("F: thread %d: error %d", i,
+			    m[i].m_error);
+			return (TET_FAIL);
+		}
+
+	return (TET_PASS);
+}
+
+void
+tcArchiveMembers(void)
+{
+	Elf *ar;
+	int i, iteration, result;
+	struct member_reader m[TS_NTHREADS];
+
+	TP_ANNOUNCE("archive members may be opened and closed "
+	    "concurrently.");
+
+	make_archive();
+
+	/* Threads open and close members of a live archive. */
+	if ((ar = elf_memory(ts_archive, sizeof(ts_archive))) == NULL) {
+		TP_UNRESOLVED("elf_memory() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) memset(m, 0, sizeof(m));
+	for (i = 0; i < TS_NTHREADS; i++) {
+		m[i].m_ar = ar;
+		m[i].m_index = i;
+	}
+
+	result = run_member_readers(m);
+	(void) elf_end(ar);
+	if (result != TET_PASS)
+		goto done;
+
+	/*
+	 * Threads close the last references to an archive that has
+	 * already been released by elf_end().
+	 */
+	for (iteration = 0; iteration < TS_NITERATIONS; iteration++) {
+		if ((ar = elf_memory(ts_archive, sizeof(ts_archive))) ==
+		    NULL) {
+			TP_UNRESOLVED("elf_memory() failed: \"%s\".",
+			    elf_errmsg(-1));
+			goto done;
+		}
+
+		(void) memset(m, 0, sizeof(m));
+		for (i = 0; i < TS_NTHREADS; i++) {
+			m[i].m_index = i;
+			if ((m[i].m_elf = elf_ar_member_at(ar,
+			    ts_member_offsets[i])) == NULL) {
+				TP_FAIL("elf_ar_member_at() failed: \"%s\".",
+				    elf_errmsg(-1));
+				(void) elf_end(ar);
+				goto done;
+			}
+		}
+
+		if (elf_end(ar) != 0) {
+			TP_FAIL("elf_end() of the archive did not return 0.");
+			goto done;
+		}
+
+		if ((result = run_member_readers(m)) != TET_PASS)
+			break;
+	}
+
+ done:
+	tet_result(result);
+}